@@ -0,0 +1,15 @@
+// The sources of the firmware that the benchmarks exercise.
+// They are built for the host with the WiFi configuration, over the in-memory client connections of host/WiFi.h.
+
+#include <HttpHeaders.cpp>
+#include <HttpReceiveBuffer.cpp>
+#include <HTTPServer.cpp>
+#include <HttpMetrics.cpp>
+#include <SocketBudget.cpp>
+#include <View.cpp>
+#include <HtmlFillerViewReader.cpp>
+
+CriticalSection csSpi;
+
+// EthernetUtil.cpp brings up the network, so only the part the benchmarks need is taken from it, as on the WiFi build
+size_t GetRoomForWrite(EthClient &client, size_t size) { return size; }
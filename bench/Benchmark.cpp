@@ -0,0 +1,122 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+static std::atomic<uint64_t> allocationsCount(0);
+static std::atomic<uint64_t> allocatedBytesCount(0);
+
+// Every heap allocation of the program goes through these operators, so they can be counted
+void *operator new(size_t size)
+{
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytesCount.fetch_add(size, std::memory_order_relaxed);
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytesCount.fetch_add(size, std::memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+Benchmark::Benchmark(const char *name) :
+    name(name),
+    operations(0),
+    failures(0),
+    startTime(0),
+    elapsed(0),
+    startAllocations(0),
+    allocations(0),
+    startAllocatedBytes(0),
+    allocatedBytes(0)
+{
+}
+
+uint64_t Benchmark::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t Benchmark::getAllocations()
+{
+    return allocationsCount.load(std::memory_order_relaxed);
+}
+
+uint64_t Benchmark::getAllocatedBytes()
+{
+    return allocatedBytesCount.load(std::memory_order_relaxed);
+}
+
+void Benchmark::start(size_t expectedSamples)
+{
+    samples.clear();
+    samples.reserve(expectedSamples);
+    failures = 0;
+    startAllocations = getAllocations();
+    startAllocatedBytes = getAllocatedBytes();
+    startTime = now();
+}
+
+void Benchmark::stop(size_t operations)
+{
+    elapsed = now() - startTime;
+    allocations = getAllocations() - startAllocations;
+    allocatedBytes = getAllocatedBytes() - startAllocatedBytes;
+    this->operations = operations;
+}
+
+uint64_t Benchmark::percentile(double p) const
+{
+    if (samples.empty())
+        return 0;
+    size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+    return samples[index];
+}
+
+void Benchmark::reportHeader()
+{
+    printf("%-28s %9s %12s %9s %10s %9s %9s %9s %9s %6s\n",
+        "benchmark", "ops", "ops/sec", "allocs/op", "bytes/op", "p50 us", "p90 us", "p99 us", "max us", "failed");
+}
+
+void Benchmark::report()
+{
+    std::sort(samples.begin(), samples.end());
+    double seconds = elapsed / 1e9;
+    double ops = operations == 0 ? 1 : operations;
+    printf("%-28s %9zu %12.0f %9.2f %10.1f %9.2f %9.2f %9.2f %9.2f %6zu\n",
+        name,
+        operations,
+        seconds > 0 ? operations / seconds : 0,
+        allocations / ops,
+        allocatedBytes / ops,
+        percentile(0.5) / 1e3,
+        percentile(0.9) / 1e3,
+        percentile(0.99) / 1e3,
+        samples.empty() ? 0 : samples.back() / 1e3,
+        failures);
+    fflush(stdout);
+}
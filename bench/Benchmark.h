@@ -0,0 +1,54 @@
+#ifndef Benchmark_h
+#define Benchmark_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/// @brief Measures a benchmark: the rate of its operations, the heap allocations per operation and the latency percentiles.
+class Benchmark
+{
+public:
+    /// @brief Constructs a benchmark.
+    /// @param name The name of the benchmark, as it appears in the report.
+    Benchmark(const char *name);
+
+    /// @brief Starts the measurement. The wall time and the heap allocations are counted from here.
+    /// @param expectedSamples Room is reserved for this many samples, so adding them does not allocate.
+    void start(size_t expectedSamples = 0);
+    /// @brief Adds the latency of a single operation.
+    /// @param ns The latency, in nanoseconds.
+    void addSample(uint64_t ns) { samples.push_back(ns); }
+    /// @brief Counts an operation that failed.
+    void addFailure() { failures++; }
+    /// @brief Stops the measurement.
+    /// @param operations The number of operations that were done since start().
+    void stop(size_t operations);
+    /// @brief Prints a line of the report.
+    void report();
+
+    /// @brief Prints the header of the report.
+    static void reportHeader();
+    /// @brief Returns the time of the monotonic clock, in nanoseconds.
+    static uint64_t now();
+    /// @brief Returns the number of heap allocations so far.
+    static uint64_t getAllocations();
+    /// @brief Returns the number of bytes that were allocated on the heap so far.
+    static uint64_t getAllocatedBytes();
+
+private:
+    uint64_t percentile(double p) const;
+
+    const char *name;
+    std::vector<uint64_t> samples;
+    size_t operations;
+    size_t failures;
+    uint64_t startTime;
+    uint64_t elapsed;
+    uint64_t startAllocations;
+    uint64_t allocations;
+    uint64_t startAllocatedBytes;
+    uint64_t allocatedBytes;
+};
+
+#endif // Benchmark_h
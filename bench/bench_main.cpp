@@ -0,0 +1,310 @@
+// Host-side benchmarks of the HTTP server.
+//
+// The request parser, the routing, View::Get and HtmlFillerViewReader are measured one by one, and then the whole server
+// is loaded through its accept task and workers pool, over in-memory client connections.
+// Build and run: pio run -e bench -t exec
+// Or run .pio/build/bench/program with the arguments: [filter] [iterations] [concurrency]
+//   filter      Runs only the benchmarks whose names contain it, "all" runs all of them.
+//   iterations  The number of operations of each benchmark (default 20000).
+//   concurrency The number of connections that the load generator keeps open at once (default 4).
+
+#include "Benchmark.h"
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPServer.h>
+#include <HttpClientContext.h>
+#include <HttpHeaders.h>
+#include <View.h>
+#include <MemViewReader.h>
+#include <HtmlFillerViewReader.h>
+#include <PathTrie.h>
+#include <memory>
+#include <vector>
+
+static const char browserRequest[] =
+    "GET %s HTTP/1.1\r\n"
+    "Host: 192.168.50.240\r\n"
+    "Connection: %s\r\n"
+    "User-Agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0.0.0 Safari/537.36\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+    "Referer: http://192.168.50.240/index\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: en-US,en;q=0.9,he;q=0.8\r\n"
+    "\r\n";
+
+/// @brief Builds a request of a browser.
+static String makeRequest(const char *resource, bool keepAlive = false)
+{
+    char request[sizeof(browserRequest) + 64];
+    snprintf(request, sizeof(request), browserRequest, resource, keepAlive ? "keep-alive" : "close");
+    return request;
+}
+
+/// @brief A static file of about 4KB, as served from memory.
+static String staticFile;
+/// @brief A page template with fillers, like the pages of the application.
+static String pageTemplate;
+
+static void initContent()
+{
+    for (int i = 0; staticFile.length() < 4096; i++)
+        staticFile += String(".rule") + i + " { margin: 0 auto; padding: 4px 8px; color: #333; }\n";
+
+    pageTemplate = "<!DOCTYPE html>\n<html>\n<head><title>IWG</title><link rel=\"stylesheet\" href=\"/site.css\"></head>\n<body>\n";
+    for (int i = 0; i < 40; i++)
+    {
+        pageTemplate += "<div class=\"row\"><span class=\"label\">Setting</span><input type=\"text\" value=\"%";
+        pageTemplate += i % 8;
+        pageTemplate += "                \"></div>\n";
+    }
+    pageTemplate += "</body>\n</html>\n";
+}
+
+static int getFillers(const ViewFiller *&fillers)
+{
+    static const ViewFiller pageFillers[] =
+    {
+        [](String &fill) { fill = "192.168.50.1"; },
+        [](String &fill) { fill = "pool.ntp.org"; },
+        [](String &fill) { fill = String(120); },
+        [](String &fill) { fill = "true"; },
+        [](String &fill) { fill = "www.google.com"; },
+        [](String &fill) { fill = "www.yahoo.com"; },
+        [](String &fill) { fill = String(3); },
+        [](String &fill) { fill = "IWG"; },
+    };
+    fillers = pageFillers;
+    return NELEMS(pageFillers);
+}
+
+static std::unique_ptr<ViewReader> makeStaticReader()
+{
+    return std::unique_ptr<ViewReader>(new MemViewReader(reinterpret_cast<const byte *>(staticFile.c_str()), staticFile.length(), CONTENT_TYPE::CSS));
+}
+
+static std::unique_ptr<ViewReader> makePageReader(bool expandFillers)
+{
+    std::unique_ptr<ViewReader> source(new MemViewReader(reinterpret_cast<const byte *>(pageTemplate.c_str()), pageTemplate.length(), CONTENT_TYPE::HTML));
+    return std::unique_ptr<ViewReader>(new HtmlFillerViewReader(std::move(source), getFillers, expandFillers));
+}
+
+/// @brief A controller of the API, that answers with a small JSON document.
+class StatusController : public HttpController
+{
+public:
+    bool Get(HttpClientContext &context, const String id)
+    {
+        String json = String("{ \"autoRecovery\" : true, \"modemState\" : 1, \"routerState\" : 1, \"id\" : \"") + id + "\" }";
+        HttpHeaders::Header additionalHeaders[] = {{CONTENT_TYPE::JSON}, {"Access-Control-Allow-Origin", "*"}, {"Cache-Control", "no-cache"}};
+        HttpHeaders headers(context);
+        headers.sendResponse(200, additionalHeaders, NELEMS(additionalHeaders), json);
+        return true;
+    }
+    bool Post(HttpClientContext &context, const String id) { return false; }
+    bool Put(HttpClientContext &context, const String id) { return false; }
+    bool Delete(HttpClientContext &context, const String id) { return false; }
+};
+
+static const char *const controllerPaths[] =
+{
+    "/INDEX", "/SETTINGS", "/DUMMY", "/", "/HISTORY", "/FILES",
+    "/API/SSE", "/API/FILES", "/API/RECOVERY", "/API/SYSTEM", "/API/METRICS"
+};
+
+static void registerControllers()
+{
+    // The paths of the application, the views are served from memory
+    HTTPServer::AddController("/", []() -> std::shared_ptr<HttpController> { return std::make_shared<View>(makeStaticReader()); });
+    HTTPServer::AddController("/SITE.CSS", []() -> std::shared_ptr<HttpController> { return std::make_shared<View>(makeStaticReader()); });
+    HTTPServer::AddController("/INDEX", []() -> std::shared_ptr<HttpController> { return std::make_shared<View>(makePageReader(true)); });
+    HTTPServer::AddController("/SETTINGS", []() -> std::shared_ptr<HttpController> { return std::make_shared<View>(makePageReader(false)); });
+    HTTPServer::AddController("/API/RECOVERY", []() -> std::shared_ptr<HttpController> { return std::make_shared<StatusController>(); });
+    for (const char *path : controllerPaths)
+        if (strcmp(path, "/") != 0 && strcmp(path, "/INDEX") != 0 && strcmp(path, "/SETTINGS") != 0 && strcmp(path, "/API/RECOVERY") != 0)
+            HTTPServer::AddController(path, []() -> std::shared_ptr<HttpController> { return std::make_shared<StatusController>(); });
+}
+
+static bool selected(const char *filter, const char *name)
+{
+    return strcmp(filter, "all") == 0 || strstr(name, filter) != NULL;
+}
+
+/// @brief Parses the header section of a browser request, as done for each connection.
+static void benchParse(size_t iterations)
+{
+    Benchmark bench("parse");
+    std::shared_ptr<HostConnection> connection = std::make_shared<HostConnection>(makeRequest("/api/recovery/status"));
+    WiFiClient client(connection);
+
+    bench.start(iterations);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        connection->rewind();
+        uint64_t t0 = Benchmark::now();
+        HttpClientContext context(client);
+        context.reset(0);
+        if (!context.parseRequestHeaderSection())
+            bench.addFailure();
+        bench.addSample(Benchmark::now() - t0);
+    }
+    bench.stop(iterations);
+    bench.report();
+}
+
+/// @brief Looks up resources in the trie of the controllers.
+static void benchRouting(size_t iterations)
+{
+    static const char *const resources[] =
+    {
+        "/index/1234", "/api/recovery", "/site.css", "/api/files/wwwroot/history.htm", "/settings", "/jquery.min.js", "/api/sse/12"
+    };
+    Benchmark bench("routing");
+    PathTrie<int> trie;
+    for (size_t i = 0; i < NELEMS(controllerPaths); i++)
+        trie.Insert(controllerPaths[i], i);
+
+    bench.start(iterations);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        uint64_t t0 = Benchmark::now();
+        int value;
+        size_t length;
+        // Some of the resources are files, that no controller matches
+        trie.Find(resources[i % NELEMS(resources)], value, length);
+        bench.addSample(Benchmark::now() - t0);
+    }
+    bench.stop(iterations);
+    bench.report();
+}
+
+/// @brief Reads a page through HtmlFillerViewReader.
+static void benchFiller(const char *name, bool expandFillers, size_t iterations)
+{
+    Benchmark bench(name);
+    byte buff[256];
+
+    bench.start(iterations);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        uint64_t t0 = Benchmark::now();
+        std::unique_ptr<ViewReader> reader = makePageReader(expandFillers);
+        reader->setGzipAccepted(false);
+        if (!reader->open(buff, sizeof(buff)))
+            bench.addFailure();
+        while (reader->read() > 0)
+            ;
+        reader->close();
+        bench.addSample(Benchmark::now() - t0);
+    }
+    bench.stop(iterations);
+    bench.report();
+}
+
+/// @brief Serves a parsed request by View::Get, without the server around it.
+static void benchViewGet(const char *name, const char *resource, std::unique_ptr<ViewReader> (*makeReader)(), size_t iterations)
+{
+    Benchmark bench(name);
+    std::shared_ptr<HostConnection> connection = std::make_shared<HostConnection>(makeRequest(resource));
+    WiFiClient client(connection);
+
+    bench.start(iterations);
+    for (size_t i = 0; i < iterations; i++)
+    {
+        connection->rewind();
+        HttpClientContext context(client);
+        context.reset(0);
+        context.parseRequestHeaderSection();
+        uint64_t t0 = Benchmark::now();
+        View view(makeReader());
+        if (!view.Get(context, "") || connection->getStatusCode() != 200)
+            bench.addFailure();
+        bench.addSample(Benchmark::now() - t0);
+    }
+    bench.stop(iterations);
+    bench.report();
+}
+
+/// @brief Loads the server with connections, keeping a number of them open at once.
+/// @param name The name of the benchmark.
+/// @param request The request(s) that are sent on each connection.
+/// @param requestsPerConnection The number of requests in request.
+/// @param iterations The number of connections.
+/// @param concurrency The number of connections that are open at once.
+static void benchServer(const char *name, const String &request, size_t requestsPerConnection, size_t iterations, size_t concurrency)
+{
+    Benchmark bench(name);
+    // The connections are created in advance, so only the allocations of the server are counted
+    std::vector<std::shared_ptr<HostConnection>> connections;
+    connections.reserve(iterations);
+    for (size_t i = 0; i < iterations; i++)
+        connections.push_back(std::make_shared<HostConnection>(request));
+
+    size_t stoppedBefore = WiFiServer::getStoppedConnections();
+    size_t opened = 0;
+    size_t stopped = 0;
+    bench.start();
+    while (stopped < iterations)
+    {
+        while (opened < iterations && opened - stopped < concurrency)
+            WiFiServer::connect(connections[opened++]);
+        if (!WiFiServer::waitForStopped(stoppedBefore + stopped + 1, 10000))
+        {
+            printf("%s: the server stopped responding\n", name);
+            break;
+        }
+        stopped = WiFiServer::getStoppedConnections() - stoppedBefore;
+    }
+    bench.stop(stopped * requestsPerConnection);
+
+    for (size_t i = 0; i < stopped; i++)
+    {
+        const HostConnection &connection = *connections[i];
+        bench.addSample(static_cast<uint64_t>(connection.getServiceTime()) * 1000);
+        if (connection.getStatusCode() != 200)
+            bench.addFailure();
+    }
+    bench.report();
+}
+
+int main(int argc, char *argv[])
+{
+    const char *filter = argc > 1 ? argv[1] : "all";
+    size_t iterations = argc > 2 ? atol(argv[2]) : 20000;
+    size_t concurrency = argc > 3 ? atol(argv[3]) : 4;
+
+    initContent();
+    registerControllers();
+    HTTPServer::Init();
+
+    Benchmark::reportHeader();
+    if (selected(filter, "parse"))
+        benchParse(iterations);
+    if (selected(filter, "routing"))
+        benchRouting(iterations);
+    if (selected(filter, "filler in place"))
+        benchFiller("filler in place", false, iterations);
+    if (selected(filter, "filler expanded"))
+        benchFiller("filler expanded", true, iterations);
+    if (selected(filter, "view static"))
+        benchViewGet("view static", "/site.css", makeStaticReader, iterations);
+    if (selected(filter, "view page"))
+        benchViewGet("view page", "/index", []() { return makePageReader(true); }, iterations);
+    if (selected(filter, "server static"))
+        benchServer("server static", makeRequest("/site.css"), 1, iterations, concurrency);
+    if (selected(filter, "server page"))
+        benchServer("server page", makeRequest("/index/1"), 1, iterations, concurrency);
+    if (selected(filter, "server api"))
+        benchServer("server api", makeRequest("/api/recovery/status"), 1, iterations, concurrency);
+    if (selected(filter, "server keep-alive"))
+    {
+        // Ten requests are sent one after the other on each persistent connection
+        String requests;
+        for (int i = 0; i < 10; i++)
+            requests += makeRequest("/api/recovery/status", true);
+        benchServer("server keep-alive", requests, 10, iterations / 10, concurrency);
+    }
+
+    // The tasks of the server never end
+    fflush(stdout);
+    _Exit(0);
+}
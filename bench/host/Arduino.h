@@ -0,0 +1,153 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// A minimal Arduino core for running parts of the firmware on the host.
+// Time is the monotonic clock of the host, and the FreeRTOS primitives are backed by threads.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+#include <string>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef unsigned long ulong;
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+/// @brief The Arduino string, over std::string.
+class String
+{
+public:
+    String() {}
+    String(const char *s) : s(s == NULL ? "" : s) {}
+    String(const char *s, size_t length) : s(s, length) {}
+    String(const std::string &s) : s(s) {}
+    explicit String(char c) : s(1, c) {}
+    explicit String(int n) : s(std::to_string(n)) {}
+    explicit String(unsigned int n) : s(std::to_string(n)) {}
+    explicit String(long n) : s(std::to_string(n)) {}
+    explicit String(unsigned long n) : s(std::to_string(n)) {}
+    explicit String(long long n) : s(std::to_string(n)) {}
+    explicit String(unsigned long long n) : s(std::to_string(n)) {}
+    explicit String(double d, unsigned int decimals = 2);
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    bool isEmpty() const { return s.empty(); }
+    void reserve(unsigned int size) { s.reserve(size); }
+    char charAt(unsigned int index) const { return index < s.length() ? s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    char &operator[](unsigned int index) { return s[index]; }
+
+    bool equals(const String &other) const { return s == other.s; }
+    bool equals(const char *other) const { return s == other; }
+    bool equalsIgnoreCase(const String &other) const { return strcasecmp(s.c_str(), other.c_str()) == 0; }
+    bool startsWith(const String &prefix) const { return s.compare(0, prefix.s.length(), prefix.s) == 0; }
+    bool endsWith(const String &suffix) const
+    {
+        return s.length() >= suffix.s.length() && s.compare(s.length() - suffix.s.length(), suffix.s.length(), suffix.s) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const { return toIndex(s.find(c, from)); }
+    int indexOf(const String &str, unsigned int from = 0) const { return toIndex(s.find(str.s, from)); }
+    int lastIndexOf(char c) const { return toIndex(s.rfind(c)); }
+    int lastIndexOf(const String &str) const { return toIndex(s.rfind(str.s)); }
+    String substring(unsigned int from) const { return from >= s.length() ? String() : String(s.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+            std::swap(from, to);
+        return from >= s.length() ? String() : String(s.substr(from, to - from));
+    }
+
+    void toUpperCase() { for (char &c : s) c = toupper(c); }
+    void toLowerCase() { for (char &c : s) c = tolower(c); }
+    void trim();
+    void replace(const String &find, const String &replace);
+    void replace(char find, char replace) { std::replace(s.begin(), s.end(), find, replace); }
+    void remove(unsigned int index) { if (index < s.length()) s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s.length()) s.erase(index, count); }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+
+    bool concat(const String &str) { s += str.s; return true; }
+    String &operator+=(const String &str) { s += str.s; return *this; }
+    String &operator+=(const char *str) { s += str; return *this; }
+    String &operator+=(char c) { s += c; return *this; }
+    template <typename T>
+    String &operator+=(T n) { s += String(n).s; return *this; }
+
+    bool operator==(const String &other) const { return s == other.s; }
+    bool operator==(const char *other) const { return s == other; }
+    bool operator!=(const String &other) const { return s != other.s; }
+    bool operator!=(const char *other) const { return s != other; }
+    bool operator<(const String &other) const { return s < other.s; }
+
+private:
+    static int toIndex(size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+
+    std::string s;
+};
+
+inline String operator+(const String &a, const String &b) { String r(a); r += b; return r; }
+inline String operator+(const String &a, const char *b) { String r(a); r += b; return r; }
+inline String operator+(const char *a, const String &b) { String r(a); r += b; return r; }
+inline String operator+(const String &a, char c) { String r(a); r += c; return r; }
+template <typename T>
+inline String operator+(const String &a, T n) { String r(a); r += String(n); return r; }
+
+// FreeRTOS
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef unsigned long TickType_t;
+typedef uint8_t StackType_t;
+typedef void *SemaphoreHandle_t;
+typedef SemaphoreHandle_t xSemaphoreHandle;
+typedef void *QueueHandle_t;
+typedef void *TaskHandle_t;
+typedef struct { void *queue; } StaticQueue_t;
+typedef struct { int unused; } StaticTask_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define tskIDLE_PRIORITY 0
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex();
+SemaphoreHandle_t xSemaphoreCreateBinary();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t h, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t h);
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t h, TickType_t ticks);
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t h);
+void vSemaphoreDelete(SemaphoreHandle_t h);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t *storage, StaticQueue_t *queueBuffer);
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks);
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q);
+void vQueueDelete(QueueHandle_t q);
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackSize, void *param, UBaseType_t priority, TaskHandle_t *handle);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stackSize, void *param, UBaseType_t priority, StackType_t *stack, StaticTask_t *task);
+void vTaskDelay(TickType_t ticks);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+#define taskYIELD() yield()
+
+#endif // Arduino_h
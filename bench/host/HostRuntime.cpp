@@ -0,0 +1,403 @@
+// The host implementation of the Arduino core, FreeRTOS and the WiFi client connections that the benchmarks run on.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdarg.h>
+#include <thread>
+#include <vector>
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long micros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(unsigned long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield()
+{
+    std::this_thread::yield();
+}
+
+String::String(double d, unsigned int decimals)
+{
+    char buff[32];
+    snprintf(buff, sizeof(buff), "%.*f", decimals, d);
+    s = buff;
+}
+
+void String::trim()
+{
+    size_t begin = s.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+    {
+        s.clear();
+        return;
+    }
+    s = s.substr(begin, s.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if (find.s.empty())
+        return;
+    for (size_t pos = s.find(find.s); pos != std::string::npos; pos = s.find(find.s, pos + replace.s.length()))
+        s.replace(pos, find.s.length(), replace.s);
+}
+
+// Semaphores
+
+namespace
+{
+    struct HostSemaphore
+    {
+        std::recursive_timed_mutex mutex;
+        // Binary semaphores are given and taken by different tasks, so they are not mutexes
+        bool binary = false;
+        bool given = false;
+        std::mutex binaryMutex;
+        std::condition_variable binaryCond;
+    };
+
+    bool waitFor(std::unique_lock<std::mutex> &lock, std::condition_variable &cond, TickType_t ticks, std::function<bool()> predicate)
+    {
+        if (ticks == portMAX_DELAY)
+        {
+            cond.wait(lock, predicate);
+            return true;
+        }
+        return cond.wait_for(lock, std::chrono::milliseconds(ticks), predicate);
+    }
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+    return new HostSemaphore();
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+    return new HostSemaphore();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+    HostSemaphore *semaphore = new HostSemaphore();
+    semaphore->binary = true;
+    return semaphore;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t h, TickType_t ticks)
+{
+    HostSemaphore *semaphore = static_cast<HostSemaphore *>(h);
+    if (ticks == portMAX_DELAY)
+    {
+        semaphore->mutex.lock();
+        return pdTRUE;
+    }
+    return semaphore->mutex.try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t h)
+{
+    static_cast<HostSemaphore *>(h)->mutex.unlock();
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t h, TickType_t ticks)
+{
+    HostSemaphore *semaphore = static_cast<HostSemaphore *>(h);
+    if (!semaphore->binary)
+        return xSemaphoreTakeRecursive(h, ticks);
+    std::unique_lock<std::mutex> lock(semaphore->binaryMutex);
+    if (!waitFor(lock, semaphore->binaryCond, ticks, [semaphore]() { return semaphore->given; }))
+        return pdFALSE;
+    semaphore->given = false;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t h)
+{
+    HostSemaphore *semaphore = static_cast<HostSemaphore *>(h);
+    if (!semaphore->binary)
+        return xSemaphoreGiveRecursive(h);
+    std::lock_guard<std::mutex> lock(semaphore->binaryMutex);
+    semaphore->given = true;
+    semaphore->binaryCond.notify_one();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t h)
+{
+    delete static_cast<HostSemaphore *>(h);
+}
+
+// Queues
+
+namespace
+{
+    struct HostQueue
+    {
+        HostQueue(UBaseType_t length, UBaseType_t itemSize) : length(length), itemSize(itemSize) {}
+
+        const size_t length;
+        const size_t itemSize;
+        std::deque<std::vector<uint8_t>> items;
+        std::mutex mutex;
+        std::condition_variable cond;
+    };
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+    return new HostQueue(length, itemSize);
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t itemSize, uint8_t *storage, StaticQueue_t *queueBuffer)
+{
+    return new HostQueue(length, itemSize);
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    HostQueue *queue = static_cast<HostQueue *>(q);
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(lock, queue->cond, ticks, [queue]() { return queue->items.size() < queue->length; }))
+        return pdFALSE;
+    const uint8_t *data = static_cast<const uint8_t *>(item);
+    queue->items.emplace_back(data, data + queue->itemSize);
+    queue->cond.notify_all();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    HostQueue *queue = static_cast<HostQueue *>(q);
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    if (!waitFor(lock, queue->cond, ticks, [queue]() { return !queue->items.empty(); }))
+        return pdFALSE;
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    queue->items.pop_front();
+    queue->cond.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    HostQueue *queue = static_cast<HostQueue *>(q);
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q)
+{
+    HostQueue *queue = static_cast<HostQueue *>(q);
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    return queue->length - queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    delete static_cast<HostQueue *>(q);
+}
+
+// Tasks
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackSize, void *param, UBaseType_t priority, TaskHandle_t *handle)
+{
+    // Tasks are never joined, the process ends while they are still running
+    std::thread(fn, param).detach();
+    if (handle != NULL)
+        *handle = NULL;
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStatic(TaskFunction_t fn, const char *name, uint32_t stackSize, void *param, UBaseType_t priority, StackType_t *stack, StaticTask_t *task)
+{
+    std::thread(fn, param).detach();
+    return task;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    if (ticks == 0)
+        yield();
+    else
+        delay(ticks);
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    return 0;
+}
+
+// Client connections
+
+WiFiClass WiFi;
+
+String IPAddress::toString() const
+{
+    char buff[16];
+    snprintf(buff, sizeof(buff), "%u.%u.%u.%u", address[0], address[1], address[2], address[3]);
+    return buff;
+}
+
+/// @brief Guards the state of all the connections, and signals when the server stops a connection.
+static std::mutex connectionsMutex;
+static std::condition_variable connectionStopped;
+static std::deque<std::shared_ptr<HostConnection>> pendingConnections;
+static size_t stoppedConnections = 0;
+static uint16_t nextPort = 1024;
+
+HostConnection::HostConnection(const String &request, bool closeAfterRequest) :
+    request(request),
+    closeAfterRequest(closeAfterRequest)
+{
+    rewind();
+}
+
+void HostConnection::rewind()
+{
+    offset = 0;
+    peerClosed = false;
+    stopped = false;
+    bytesSent = 0;
+    responseHead[0] = '\0';
+    acceptTime = 0;
+    stopTime = 0;
+    port = 0;
+}
+
+int HostConnection::getStatusCode() const
+{
+    // "HTTP/1.1 200 OK"
+    const char *space = strchr(responseHead, ' ');
+    return space == NULL ? 0 : atoi(space + 1);
+}
+
+uint8_t WiFiClient::connected()
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    return connection != NULL && !connection->stopped && (!connection->peerClosed || connection->offset < connection->request.length());
+}
+
+int WiFiClient::available()
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (connection == NULL || connection->stopped)
+        return 0;
+    return connection->request.length() - connection->offset;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (connection == NULL || connection->stopped || connection->offset >= connection->request.length())
+        return -1;
+    size = std::min<size_t>(size, connection->request.length() - connection->offset);
+    memcpy(buf, connection->request.c_str() + connection->offset, size);
+    connection->offset += size;
+    if (connection->offset == connection->request.length() && connection->closeAfterRequest)
+        connection->peerClosed = true;
+    return size;
+}
+
+int WiFiClient::read()
+{
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+}
+
+int WiFiClient::peek()
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (connection == NULL || connection->offset >= connection->request.length())
+        return -1;
+    return static_cast<uint8_t>(connection->request[connection->offset]);
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (connection == NULL || connection->stopped)
+        return 0;
+    // Keep the beginning of the response, null terminated
+    size_t headLength = strlen(connection->responseHead);
+    size_t n = std::min<size_t>(size, HostConnection::RESPONSE_HEAD_SIZE - 1 - headLength);
+    memcpy(connection->responseHead + headLength, buf, n);
+    connection->responseHead[headLength + n] = '\0';
+    connection->bytesSent += size;
+    return size;
+}
+
+size_t WiFiClient::printf(const char *format, ...)
+{
+    char buff[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buff, sizeof(buff), format, args);
+    va_end(args);
+    return len < 0 ? 0 : write(buff, std::min<size_t>(len, sizeof(buff) - 1));
+}
+
+void WiFiClient::stop()
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (connection == NULL || connection->stopped)
+        return;
+    connection->stopped = true;
+    connection->stopTime = micros();
+    stoppedConnections++;
+    connectionStopped.notify_all();
+}
+
+uint16_t WiFiClient::remotePort() const
+{
+    return connection == NULL ? 0 : connection->port;
+}
+
+WiFiClient WiFiServer::accept()
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    if (pendingConnections.empty())
+        return WiFiClient();
+    std::shared_ptr<HostConnection> connection = pendingConnections.front();
+    pendingConnections.pop_front();
+    return WiFiClient(connection);
+}
+
+void WiFiServer::connect(const std::shared_ptr<HostConnection> &connection)
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    connection->acceptTime = micros();
+    connection->port = nextPort++;
+    if (nextPort == 0)
+        nextPort = 1024;
+    pendingConnections.push_back(connection);
+}
+
+bool WiFiServer::waitForStopped(size_t count, unsigned long timeout)
+{
+    std::unique_lock<std::mutex> lock(connectionsMutex);
+    return connectionStopped.wait_for(lock, std::chrono::milliseconds(timeout), [count]() { return stoppedConnections >= count; });
+}
+
+size_t WiFiServer::getStoppedConnections()
+{
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    return stoppedConnections;
+}
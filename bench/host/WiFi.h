@@ -0,0 +1,126 @@
+#ifndef WiFi_h
+#define WiFi_h
+
+// In-memory client connections, in place of the WiFi library, for running the HTTP server on the host.
+// A connection is created with the whole request already received. The response is counted and
+// the beginning of it is kept, so the status code can be checked.
+
+#include <Arduino.h>
+#include <memory>
+
+#ifndef CONFIG_LWIP_MAX_SOCKETS
+#define CONFIG_LWIP_MAX_SOCKETS 16
+#endif
+
+class IPAddress
+{
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : address{a, b, c, d} {}
+    uint8_t operator[](int index) const { return address[index]; }
+    String toString() const;
+
+private:
+    uint8_t address[4];
+};
+
+/// @brief The state of an in-memory client connection.
+class HostConnection
+{
+public:
+    /// @brief The number of bytes of the response that are kept.
+    static const size_t RESPONSE_HEAD_SIZE = 64;
+
+    /// @brief Creates a connection that the client already sent the whole request on.
+    /// @param request The request, or several requests that are sent one after the other on a persistent connection.
+    /// @param closeAfterRequest If true, the client closes its side of the connection once the request is read.
+    HostConnection(const String &request, bool closeAfterRequest = true);
+
+    /// @brief Resets the connection, so the same request is sent again.
+    void rewind();
+    /// @brief Returns the status code of the first response, or 0 if nothing was sent.
+    int getStatusCode() const;
+    /// @brief Returns the number of bytes of the response.
+    size_t getBytesSent() const { return bytesSent; }
+    /// @brief Returns the time, in microseconds, from the time the connection was accepted until the server stopped it.
+    unsigned long getServiceTime() const { return stopTime - acceptTime; }
+    bool isStopped() const { return stopped; }
+
+private:
+    friend class WiFiClient;
+    friend class WiFiServer;
+
+    String request;
+    size_t offset;
+    bool peerClosed;
+    bool closeAfterRequest;
+    bool stopped;
+    size_t bytesSent;
+    char responseHead[RESPONSE_HEAD_SIZE];
+    unsigned long acceptTime;
+    unsigned long stopTime;
+    uint16_t port;
+};
+
+class WiFiClient
+{
+public:
+    WiFiClient() {}
+    WiFiClient(const std::shared_ptr<HostConnection> &connection) : connection(connection) {}
+
+    uint8_t connected();
+    int available();
+    int read();
+    int read(uint8_t *buf, size_t size);
+    int peek();
+    size_t write(uint8_t b) { return write(&b, 1); }
+    size_t write(const uint8_t *buf, size_t size);
+    size_t write(const char *buf, size_t size) { return write(reinterpret_cast<const uint8_t *>(buf), size); }
+    size_t print(const String &s) { return write(s.c_str(), s.length()); }
+    size_t print(const char *s) { return write(s, strlen(s)); }
+    size_t println(const String &s) { return print(s) + println(); }
+    size_t println(const char *s) { return print(s) + println(); }
+    size_t println() { return write("\r\n", 2); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    void flush() {}
+    void stop();
+    IPAddress remoteIP() const { return IPAddress(127, 0, 0, 1); }
+    uint16_t remotePort() const;
+    operator bool() const { return connection != NULL; }
+    bool operator==(const WiFiClient &other) const { return connection == other.connection; }
+
+private:
+    std::shared_ptr<HostConnection> connection;
+};
+
+class WiFiServer
+{
+public:
+    WiFiServer(uint16_t port, int maxClients = 4) {}
+
+    void begin() {}
+    /// @brief Accepts the next connection that a client opened, if there is one.
+    WiFiClient accept();
+    WiFiClient available() { return accept(); }
+
+    /// @brief Opens a connection to the server.
+    /// @param connection The connection.
+    static void connect(const std::shared_ptr<HostConnection> &connection);
+    /// @brief Waits until the server has stopped a number of connections since the start.
+    /// @param count The number of connections.
+    /// @param timeout The maximum time to wait, in milliseconds.
+    /// @return false on timeout.
+    static bool waitForStopped(size_t count, unsigned long timeout);
+    /// @brief Returns the number of connections that were stopped by the server so far.
+    static size_t getStoppedConnections();
+};
+
+class WiFiClass
+{
+public:
+    IPAddress localIP() const { return IPAddress(127, 0, 0, 1); }
+    IPAddress gatewayIP() const { return IPAddress(127, 0, 0, 1); }
+};
+
+extern WiFiClass WiFi;
+
+#endif // WiFi_h
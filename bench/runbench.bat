@@ -0,0 +1,3 @@
+cd ..
+pio run -e bench -t exec
+cd bench
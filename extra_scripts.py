@@ -1,14 +1,125 @@
 Import("env")
 
-# Source text file
-text_file = "sd/wwwroot/index.htm"
+import email.utils
+import fnmatch
+import gzip
+import os
 
-# Output object file
-output_obj = env["BUILD_DIR"] + "\\" + "index.o"
+# Static files of the web site
+wwwroot = os.path.join(env.subst("$PROJECT_DIR"), "SD", "wwwroot")
 
-# Generate an object file from the text
-env.Execute(
-    f"xtensa-esp32-elf-objcopy -I binary -O elf32-xtensa-le -B xtensa {text_file} {output_obj}"
-)
+# The index page is always embedded, it is served from flash by IndexView.
+# The rest of the files are embedded only when the project option custom_embed_wwwroot is set, e.g.:
+#   custom_embed_wwwroot = yes
+#   custom_embed_wwwroot_exclude = *.MAP *.JPG
+#   custom_embed_wwwroot_gzip = yes
+# Make sure that the application partition is large enough for the embedded files.
+index_file = "/INDEX.HTM"
+embed_all = env.GetProjectOption("custom_embed_wwwroot", "no").lower() in ("yes", "true", "1")
+exclude = env.GetProjectOption("custom_embed_wwwroot_exclude", "*.MAP *.GZ").upper().split()
+compress = env.GetProjectOption("custom_embed_wwwroot_gzip", "yes").lower() in ("yes", "true", "1")
 
-env.Append(LINKFLAGS=output_obj)
\ No newline at end of file
+# File extensions and their content types, as in FileViewReader
+content_types = {
+    "JS": "JAVASCRIPT",
+    "ICO": "ICON",
+    "HTM": "HTML",
+    "CSS": "CSS",
+    "JPG": "JPEG",
+    "MAP": "CSS",
+    "EOT": "EOT",
+    "SVG": "SVG",
+    "TTF": "TTF",
+    "WOF": "WOFF",
+    "WF2": "WOFF2",
+}
+# Already compressed formats do not gain anything from gzip.
+# HTML files are templates that the server fills, so they must remain plain.
+not_compressed = ("JPG", "WOF", "WF2", "HTM")
+
+
+def fnv1a(data):
+    # The same hash that FileViewReader uses for entity tags
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def collect_assets():
+    assets = []
+    for root, dirs, files in os.walk(wwwroot):
+        dirs.sort()
+        for name in sorted(files):
+            file_path = os.path.join(root, name)
+            path = "/" + os.path.relpath(file_path, wwwroot).replace(os.sep, "/")
+            ext = os.path.splitext(name)[1][1:].upper()
+            if path.upper() != index_file:
+                if not embed_all or ext not in content_types:
+                    continue
+                if any(fnmatch.fnmatch(name.upper(), pattern) for pattern in exclude):
+                    continue
+            with open(file_path, "rb") as f:
+                data = f.read()
+            gzipped = False
+            if compress and ext not in not_compressed:
+                compressed = gzip.compress(data, compresslevel=9, mtime=0)
+                if len(compressed) < len(data):
+                    data = compressed
+                    gzipped = True
+            assets.append({
+                "path": path,
+                "data": data,
+                "type": content_types.get(ext, "UNKNOWN"),
+                "gzipped": gzipped,
+                "etag": '\\"%08x-%x\\"' % (fnv1a(data), len(data)),
+                "last_modified": email.utils.formatdate(os.path.getmtime(file_path), usegmt=True),
+            })
+    # The manifest is sorted by the (case insensitive) path, so it can be binary searched
+    assets.sort(key=lambda asset: asset["path"].lower())
+    return assets
+
+
+def generate_manifest(assets):
+    lines = [
+        "// Generated by extra_scripts.py from the files in SD/wwwroot. Do not edit.",
+        "",
+        "#include <EmbeddedAssets.h>",
+        "",
+    ]
+    for i, asset in enumerate(assets):
+        lines.append("// %s" % asset["path"])
+        lines.append("static const byte asset%d[] = {" % i)
+        data = asset["data"]
+        for offset in range(0, len(data), 32):
+            lines.append("    " + ", ".join("0x%02x" % b for b in data[offset:offset + 32]) + ",")
+        lines.append("};")
+        lines.append("")
+    if assets:
+        lines.append("static constexpr EmbeddedAsset manifest[] =")
+        lines.append("{")
+        for i, asset in enumerate(assets):
+            lines.append('    {"%s", asset%d, sizeof(asset%d), CONTENT_TYPE::%s, %s, "%s", "%s"},' % (
+                asset["path"], i, i, asset["type"], "true" if asset["gzipped"] else "false",
+                asset["etag"], asset["last_modified"]))
+        lines.append("};")
+        lines.append("")
+        lines.append("const EmbeddedAsset *const EmbeddedAssets::assets = manifest;")
+        lines.append("const size_t EmbeddedAssets::nAssets = sizeof(manifest) / sizeof(*manifest);")
+    else:
+        lines.append("const EmbeddedAsset *const EmbeddedAssets::assets = NULL;")
+        lines.append("const size_t EmbeddedAssets::nAssets = 0;")
+    return "\n".join(lines) + "\n"
+
+
+# Generate the manifest source in the build directory and add it to the build.
+# The source is rewritten only when it changes, so it is not recompiled needlessly.
+output_dir = os.path.join(env.subst("$BUILD_DIR"), "embedded")
+output_src = os.path.join(output_dir, "EmbeddedManifest.cpp")
+manifest = generate_manifest(collect_assets())
+os.makedirs(output_dir, exist_ok=True)
+if not os.path.exists(output_src) or open(output_src).read() != manifest:
+    with open(output_src, "w") as f:
+        f.write(manifest)
+
+env.BuildSources(os.path.join("$BUILD_DIR", "embedded_obj"), output_dir)
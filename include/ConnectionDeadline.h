@@ -0,0 +1,94 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#ifndef ConnectionDeadline_h
+#define ConnectionDeadline_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef HTTP_IDLE_TIMEOUT
+/// @brief The time, in milliseconds, that a request may wait for the client without any data moving,
+/// before its connection is closed.
+#define HTTP_IDLE_TIMEOUT 3000
+#endif
+#ifndef HTTP_MIN_BYTE_RATE
+/// @brief The minimal average rate, in bytes per second, that the client must move the data of a request and its response at,
+/// once the grace period is over. A client that trickles data slower than this has its connection closed.
+#define HTTP_MIN_BYTE_RATE 512
+#endif
+#ifndef HTTP_RATE_GRACE_PERIOD
+/// @brief The time, in milliseconds, that a request may wait for the client before the minimal rate is enforced.
+/// It is longer than HTTP_IDLE_TIMEOUT, so a client that sends nothing is closed by the idle timeout.
+#define HTTP_RATE_GRACE_PERIOD 5000
+#endif
+
+/// @brief The deadline of a request on a client connection, covering the reading of the request body and the writing of the response.
+/// Only the time that is spent waiting for the client counts, either for data to arrive or for a write to complete,
+/// so a controller that takes its time to prepare the response is not taken for a slow client.
+/// The request expires when a single wait lasts HTTP_IDLE_TIMEOUT, or when the client moved the data slower than
+/// HTTP_MIN_BYTE_RATE over the time it was waited for, once HTTP_RATE_GRACE_PERIOD of waiting is over.
+/// So a large upload or download keeps going as long as it progresses, while a stalled or a trickling client
+/// cannot hold a worker and a socket.
+/// @note The class does not read the clock, the caller measures the waits.
+class ConnectionDeadline
+{
+public:
+    ConnectionDeadline() :
+        waitTime(0),
+        transferred(0)
+    {
+    }
+
+    /// @brief Starts the deadline of a new request.
+    void restart()
+    {
+        waitTime = 0;
+        transferred = 0;
+    }
+
+    /// @brief Accounts for data of the request or of the response that moved.
+    /// @param size The number of bytes.
+    void progress(size_t size) { transferred += size; }
+
+    /// @brief Accounts for time that was spent waiting for the client.
+    /// @param time The time, in milliseconds.
+    void waited(unsigned long time) { waitTime += time; }
+
+    /// @brief Indicates whether the request expired.
+    /// @param currentWait The time, in milliseconds, of a wait for the client that is in progress, and was not accounted for yet.
+    bool isExpired(unsigned long currentWait = 0) const
+    {
+        if (currentWait >= HTTP_IDLE_TIMEOUT)
+            return true;
+        uint64_t totalWait = waitTime + currentWait;
+        if (totalWait <= HTTP_RATE_GRACE_PERIOD)
+            return false;
+        return transferred * 1000 < (totalWait - HTTP_RATE_GRACE_PERIOD) * HTTP_MIN_BYTE_RATE;
+    }
+
+    /// @brief Returns the number of bytes that moved since the request started.
+    uint64_t getTransferred() const { return transferred; }
+    /// @brief Returns the time, in milliseconds, that was spent waiting for the client since the request started.
+    uint64_t getWaitTime() const { return waitTime; }
+
+private:
+    uint64_t waitTime;
+    uint64_t transferred;
+};
+
+#endif // ConnectionDeadline_h
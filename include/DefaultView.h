@@ -36,14 +36,14 @@ public:
 protected:
     /// @brief Redirects the client to the index page.
     /// This method is called when the client requests the root URL ("/").
-    /// @param client The EthClient instance representing the client connection.
-    /// This client is used to send the HTTP response.
+    /// @param context The context of the HTTP client that made the request.
+    /// This context is used to send the HTTP response.
     /// @param id The identifier for the resource being requested.
     /// @return True to indicate that a redirection response was sent.
-    bool redirect(EthClient &client, const String &id)
+    bool redirect(HttpClientContext &context, const String &id)
     {
         HttpHeaders::Header additionalHeaders[] = { {"Location", "/index"} };
-        HttpHeaders headers(client);
+        HttpHeaders headers(context);
         headers.sendHeaderSection(302, true, additionalHeaders, NELEMS(additionalHeaders));
         return true;
     }
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef DoubleBufferedFileWriter_h
+#define DoubleBufferedFileWriter_h
+
+#include <Arduino.h>
+#include <SDUtil.h>
+#include <atomic>
+
+#ifndef FILE_WRITER_BUFF_SIZE
+/// @brief The size of each of the two buffers of the writer. A multiple of the SD card sector size.
+#define FILE_WRITER_BUFF_SIZE (4 * 1024)
+#endif
+#ifndef FILE_WRITER_STACK_SIZE
+/// @brief The stack size of the task that writes the buffers to the file
+#define FILE_WRITER_STACK_SIZE (4 * 1024)
+#endif
+
+/// @brief Writes data to a file through two buffers.
+/// While one buffer is written to the file by a background task, the next one is filled by the caller.
+/// This way, receiving the data and writing it to the SD card overlap, and the file is written in large blocks.
+class DoubleBufferedFileWriter
+{
+public:
+    /// @brief Constructs a new DoubleBufferedFileWriter.
+    /// @param file The file to write to. It must remain open until end() is called.
+    DoubleBufferedFileWriter(SdFile &file);
+    ~DoubleBufferedFileWriter();
+
+    /// @brief Allocates the buffers and starts the task that writes them to the file.
+    /// If the resources cannot be allocated, the data is written directly to the file.
+    void begin();
+    /// @brief Writes data to the file.
+    /// The data is copied to the current buffer. When the buffer is full, it is handed to the writing task.
+    /// @param data The data.
+    /// @param size The size of the data.
+    /// @return false if writing to the file failed, true otherwise.
+    bool write(const byte *data, size_t size);
+    /// @brief Writes the rest of the data to the file, and waits for the writing task to end.
+    /// @return false if writing to the file failed, true otherwise.
+    bool end();
+
+private:
+    /// @brief A buffer that is passed between the caller and the writing task
+    struct Block
+    {
+        byte *data;
+        size_t size;
+    };
+
+    static void WriterTask(void *param);
+    void handOver();
+
+private:
+    SdFile &file;
+    byte *buffers[2];
+    /// @brief Buffers that are waiting to be written to the file. A block of size 0 ends the task.
+    QueueHandle_t fullBlocks;
+    /// @brief Buffers that may be filled
+    QueueHandle_t freeBlocks;
+    /// @brief Given by the writing task when it ends
+    SemaphoreHandle_t taskEnded;
+    bool taskRunning;
+    /// @brief The buffer that is being filled, its data is NULL when there is none
+    Block current;
+    std::atomic<bool> failed;
+};
+
+#endif // DoubleBufferedFileWriter_h
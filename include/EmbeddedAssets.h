@@ -0,0 +1,56 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef EmbeddedAssets_h
+#define EmbeddedAssets_h
+
+#include <Common.h>
+#include <HttpHeaders.h>
+
+/// @brief A static file of the web site that is embedded in the firmware.
+typedef struct
+{
+    const char *path; // The path of the file, relative to the wwwroot directory on the SD card, e.g. "/CSS/SITE.CSS"
+    const byte *data; // The content of the file, in flash
+    size_t size; // The size of the content
+    CONTENT_TYPE contentType; // The content type of the file
+    bool gzipped; // Whether the content is gzip compressed
+    const char *etag; // The entity tag of the content, including the quotes
+    const char *lastModified; // The last modified time of the file, formatted for the Last-Modified header
+} EmbeddedAsset;
+
+/// @brief The manifest of the static files of the web site that are embedded in the firmware.
+/// The manifest is generated at build time by extra_scripts.py. The index page is always embedded.
+/// The rest of the files under SD/wwwroot are embedded when the custom_embed_wwwroot project option is set.
+/// Embedded files are served from flash, without accessing the SD card, so the web site stays up even when the
+/// SD card is slow, busy, or missing.
+class EmbeddedAssets
+{
+public:
+    /// @brief Finds an embedded file.
+    /// @param path The path of the file, relative to the wwwroot directory. Case is ignored.
+    /// @return The embedded file, or NULL if the file is not embedded.
+    static const EmbeddedAsset *find(const char *path);
+
+private:
+    /// @brief The embedded files, sorted by their (case insensitive) path
+    static const EmbeddedAsset *const assets;
+    static const size_t nAssets;
+};
+
+#endif // EmbeddedAssets_h
@@ -171,6 +171,12 @@ void MaintainEthernet();
 /// @return True if the address is a zero address.
 bool IsZeroIPAddress(const IPAddress &address);
 
+/// @brief Returns the number of bytes that can be written to a client without waiting.
+/// @param client The client.
+/// @param size The number of bytes that are to be written.
+/// @return The number of bytes, up to size, that the client has room for.
+size_t GetRoomForWrite(EthClient &client, size_t size);
+
 /// @brief Try to get the host address from the server name.
 /// @param address The IPAddress object to store the resolved address.
 /// @param server The server name to resolve.
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FileCache_h
+#define FileCache_h
+
+#include <Common.h>
+#include <SDUtil.h>
+#include <Lock.h>
+#include <list>
+#include <map>
+#include <set>
+#include <memory>
+
+#ifndef FILE_CACHE_SIZE
+/// @brief The maximum number of bytes of file content that are kept in the cache.
+#define FILE_CACHE_SIZE (64 * 1024)
+#endif
+#ifndef FILE_CACHE_MAX_FILE_SIZE
+/// @brief Files larger than this are never cached, they are always read from the SD card.
+#define FILE_CACHE_MAX_FILE_SIZE (32 * 1024)
+#endif
+#ifndef FILE_CACHE_MAX_MISSING
+/// @brief The maximum number of files that are remembered not to exist. When another file is found missing,
+/// the files that were remembered are forgotten, and they are looked for on the SD card again.
+#define FILE_CACHE_MAX_MISSING 32
+#endif
+
+/// @brief A byte budgeted, least recently used, cache of the content of files on the SD card.
+/// Frequently requested static files are served from memory, without mounting the SD card and without
+/// competing for the SPI bus with the logger and the history writer.
+/// The cache also remembers the files that do not exist, e.g. the compressed copies that were not made.
+/// @note A cached file remains valid until it is changed through the server, so FilesController
+/// invalidates the cache whenever it writes or deletes files.
+class FileCache
+{
+public:
+    /// @brief The cached content of a file
+    class Entry
+    {
+    public:
+        Entry(const String &path, size_t size, time_t lastWrite) :
+            path(path),
+            data(static_cast<byte *>(malloc(size))),
+            size(size),
+            lastWrite(lastWrite)
+        {
+        }
+
+        ~Entry()
+        {
+            free(data);
+        }
+
+    public:
+        const String path; // The path of the file on the SD card
+        byte *data; // The content of the file
+        const size_t size; // The size of the file
+        const time_t lastWrite; // The last modified time of the file, when it was loaded
+    };
+
+    /// @brief The entry is shared, so a file that is being sent is kept in memory even if it is evicted from the cache meanwhile.
+    typedef std::shared_ptr<const Entry> EntryPtr;
+
+    /// @brief Cache statistics
+    typedef struct
+    {
+        uint32_t hits; // Number of lookups that found the file in the cache
+        uint32_t misses; // Number of lookups that did not find the file in the cache
+        uint32_t evictions; // Number of files that were evicted to make room for other files
+        size_t entries; // Number of cached files
+        size_t bytes; // Number of cached bytes
+        size_t missing; // Number of files that are remembered not to exist
+    } Stats;
+
+    /// @brief Looks up a file in the cache.
+    /// @param filePath The path of the file on the SD card.
+    /// @param countMiss true if a miss should be counted when the file is not found.
+    /// @return The cached file, or an empty pointer if the file is not cached.
+    static EntryPtr get(const String &filePath, bool countMiss = true);
+    /// @brief Loads a file into the cache.
+    /// @param filePath The path of the file on the SD card.
+    /// @param file The opened file. On success its read position is at the end of the file.
+    /// @return The cached file, or an empty pointer if the file is too large to be cached, or it could not be read.
+    /// @note The SD card must be mounted while the file is loaded.
+    static EntryPtr load(const String &filePath, SdFile &file);
+    /// @brief Checks whether a file is known not to exist on the SD card, without accessing the SD card.
+    /// @param filePath The path of the file on the SD card.
+    /// @return true if exists() found that the file does not exist, and it was not invalidated since.
+    static bool isMissing(const String &filePath);
+    /// @brief Checks whether a file exists on the SD card.
+    /// A file that does not exist is remembered, so isMissing() answers for it until it is invalidated,
+    /// or until FILE_CACHE_MAX_MISSING other files were found missing.
+    /// @param filePath The path of the file on the SD card.
+    /// @return true if the file exists.
+    /// @note The SD card must be mounted while the file is checked.
+    static bool exists(const String &filePath);
+    /// @brief Drops a file, or all the files in a directory, from the cache.
+    /// @param path The path of the file or the directory on the SD card.
+    /// @note This method should be called whenever a file is written or deleted.
+    static void invalidate(const String &path);
+    /// @brief Gets the cache statistics.
+    /// @param stats Filled with the statistics.
+    static void getStats(Stats &stats);
+
+private:
+    static String key(const String &path);
+    static void evict(size_t size);
+
+private:
+    typedef std::list<EntryPtr> LruList;
+    typedef std::map<String, LruList::iterator> EntriesMap;
+    /// @brief The cached files, the most recently used first
+    static LruList lru;
+    /// @brief The cached files by their (upper case) path
+    static EntriesMap entries;
+    /// @brief The (upper case) paths of the files that are known not to exist on the SD card
+    static std::set<String> missing;
+    static size_t bytes;
+    static uint32_t hits;
+    static uint32_t misses;
+    static uint32_t evictions;
+    /// @brief Incremented whenever files are invalidated
+    static uint32_t generation;
+    static CriticalSection cs;
+};
+
+#endif // FileCache_h
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FileSender_h
+#define FileSender_h
+
+#include <Arduino.h>
+#include <EthernetUtil.h>
+#include <SDUtil.h>
+#include <HttpClientContext.h>
+
+#ifndef FILE_SENDER_CHUNK_SIZE
+/// @brief The largest chunk that is sent at once. The size of the Tx buffer of a W5500 socket.
+#define FILE_SENDER_CHUNK_SIZE 2048
+#endif
+#ifndef FILE_SENDER_MIN_CHUNK_SIZE
+/// @brief The sender waits for at least this much free space in the Tx buffer of the socket before it sends a chunk,
+/// so the file is not sent in many small segments while the client is slow to acknowledge.
+#define FILE_SENDER_MIN_CHUNK_SIZE 512
+#endif
+
+/// @brief Sends the content of files to clients in large chunks.
+/// The data that is sent is accounted for in the context of the request, and the time spent waiting for the client
+/// counts against the deadline of the request, so a stalled or a trickling client stops the sending.
+class FileSender
+{
+public:
+    /// @brief Sends a part of a file to a client, from the current position of the file.
+    /// @param context The context of the request.
+    /// @param file The file.
+    /// @param size The number of bytes to send.
+    /// @return The number of bytes that were sent. It is less than size if the file could not be read, the client failed
+    /// or the request expired.
+    /// @note On the wired build, the next chunk is read from the SD card while the W5500 transmits the previous one,
+    /// and each chunk is copied to the Tx buffer of the socket and sent with a single SEND command, in a single hold of the SPI bus.
+    static size_t send(HttpClientContext &context, SdFile &file, size_t size);
+    /// @brief Sends data from memory to a client.
+    /// @param context The context of the request.
+    /// @param data The data.
+    /// @param size The size of the data.
+    /// @return The number of bytes that were sent.
+    static size_t send(HttpClientContext &context, const byte *data, size_t size);
+
+#ifndef USE_WIFI
+private:
+    static bool waitForSendDone(HttpClientContext &context, SOCKET s);
+    static size_t sendChunk(HttpClientContext &context, SOCKET s, const byte *data, size_t size);
+#endif
+};
+
+#endif // FileSender_h
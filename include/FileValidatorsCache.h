@@ -0,0 +1,68 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef FileValidatorsCache_h
+#define FileValidatorsCache_h
+
+#include <Arduino.h>
+#include <Lock.h>
+#include <map>
+
+#ifndef FILE_VALIDATORS_CACHE_SIZE
+/// @brief The maximum number of files whose validators are cached.
+#define FILE_VALIDATORS_CACHE_SIZE 64
+#endif
+
+/// @brief A cache of the validators (entity tag and last modified time) of files on the SD card.
+/// The validators of a file are computed once, when the file is first served, and are kept until the file
+/// is changed through the server. So a conditional request can be answered without opening the file.
+class FileValidatorsCache
+{
+public:
+    /// @brief The validators of a file
+    typedef struct
+    {
+        String etag; // The entity tag, a hash of the file content, including the quotes
+        String lastModified; // The last modified time, formatted for the Last-Modified header
+    } Validators;
+
+    /// @brief Gets the cached validators of a file.
+    /// @param filePath The path of the file on the SD card.
+    /// @param validators Filled with the validators of the file.
+    /// @return true if the validators of the file are cached, false otherwise.
+    static bool get(const String &filePath, Validators &validators);
+    /// @brief Caches the validators of a file.
+    /// @param filePath The path of the file on the SD card.
+    /// @param validators The validators of the file.
+    /// @note When the cache is full, the validators of another file are dropped.
+    static void put(const String &filePath, const Validators &validators);
+    /// @brief Drops the cached validators of a file, or of all the files in a directory.
+    /// @param path The path of the file or the directory on the SD card.
+    /// @note This method should be called whenever a file is written or deleted.
+    static void invalidate(const String &path);
+
+private:
+    static String key(const String &path);
+
+private:
+    typedef std::map<String, Validators> ValidatorsMap;
+    static ValidatorsMap validatorsMap;
+    static CriticalSection cs;
+};
+
+#endif // FileValidatorsCache_h
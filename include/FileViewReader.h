@@ -22,6 +22,9 @@
 #include <Common.h>
 #include <SDUtil.h>
 #include <ViewReader.h>
+#include <FileValidatorsCache.h>
+#include <FileCache.h>
+#include <EmbeddedAssets.h>
 
 /// @brief This class is a ViewReader that reads from a file on the SD card.
 /// It is used to read data from a file and provide it as a view.
@@ -31,7 +34,12 @@ public:
     /// @brief Class constructor
     /// @param viewFilePath The path to the file on the SD card to read from
     FileViewReader(const String viewFilePath) :
-        viewFilePath(viewFilePath)
+        viewFilePath(viewFilePath),
+        gzipEncoded(false),
+        embeddedAsset(NULL),
+        memData(NULL),
+        memSize(0),
+        memOffset(0)
     {        
     }
     
@@ -47,6 +55,8 @@ protected:
     /// @return true if the view reader was opened successfully, false otherwise
     /// @note This function opens the file on the SD card. When read method is called,
     /// it will read from the file and fill the buffer with the data. 
+    /// Files that are embedded in the firmware are read from flash, and small files are kept in the file cache
+    /// and read from memory instead.
     virtual bool open(byte *buff, int buffSize);
     /// @brief Opens the view reader with a given opened file object
     /// @param buff A buffer to read the view into
@@ -65,6 +75,14 @@ protected:
     /// it will read only the first buffSize bytes. Next call to read() will continue reading from the view from where it left off.
     /// @return The number of bytes read from the file, or -1 if there was an error, or there is no more data.
     virtual int read(int offset);
+#ifndef TESTING
+    /// @brief Sends the next part of the file directly to the client
+    /// @param context The context of the request to send the file in.
+    /// @param size The number of bytes to send.
+    /// @return The number of bytes sent.
+    /// @note A file on the SD card is sent in chunks as large as the socket accepts, rather than through the small buffer of the view.
+    virtual long send(HttpClientContext &context, long size);
+#endif
     /// @brief The file size in bytes
     /// @return number of bytes in the file. This is required to send the correct Content-Length header in the HTTP response.
     virtual long getViewSize();
@@ -74,16 +92,48 @@ protected:
     /// @note The last modified time is in the format "YYYY-MM-DD HH:MM:SS". This format
     /// is used in the HTTP headers to indicate the last modified time of the file.
     virtual bool getLastModifiedTime(String &lastModifiedTimeStr);
+    /// @brief Gets the entity tag of the file
+    /// @param etag A string to fill with the entity tag of the file
+    /// @return true if the entity tag was successfully retrieved, false otherwise
+    /// @note The entity tag is a hash of the file content. It is computed when the file is first served
+    /// and it is cached from then on.
+    virtual bool getETag(String &etag);
+    /// @brief Gets the cached validators of the file, without opening it
+    /// @param etag A string to fill with the entity tag of the file
+    /// @param lastModifiedTimeStr A string to fill with the last modified time of the file
+    /// @return true if the validators of the file are cached, false otherwise
+    virtual bool getCachedValidators(String &etag, String &lastModifiedTimeStr);
     /// @brief Gets the content type of the file
     /// @return The content type of the file
     /// @note The content type is used in the HTTP headers to indicate the type of the file.
     /// The content type is determined based on the file extension. If the file extension is not
     /// recognized, it will return CONTENT_TYPE::UNKNOWN.
     virtual CONTENT_TYPE getContentType();
+    /// @brief A file view can be read from a gzip compressed copy of the file.
+    /// @return true
+    virtual bool supportsGzip() { return true; }
+    /// @brief Indicates whether the view is read from the gzip compressed copy of the file.
+    /// @return true if the opened file is the gzip compressed copy, false otherwise.
+    virtual bool isGzipEncoded() { return gzipEncoded; }
+
+private:
+    bool getValidators(FileValidatorsCache::Validators &validators);
+    const EmbeddedAsset *findEmbeddedAsset();
+    bool openMem(byte *buff, int buffSize, const byte *data, size_t size);
 
 private:
     String viewFilePath;
     SdFile file;
+    bool gzipEncoded;
+    /// @brief The content of the file, when it is read from the file cache
+    FileCache::EntryPtr cachedFile;
+    /// @brief The file, when it is embedded in the firmware
+    const EmbeddedAsset *embeddedAsset;
+    /// @brief The content of the file, when it is read from memory (the file cache, or flash)
+    const byte *memData;
+    size_t memSize;
+    /// @brief The read position in memData
+    size_t memOffset;
 };
 
 #endif // FileViewReader
\ No newline at end of file
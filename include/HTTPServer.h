@@ -20,11 +20,59 @@
 #define HTTPServer_h
 
 #include <HttpController.h>
-#include <LinkedList.h>
+#include <PathTrie.h>
+#include <atomic>
 #ifdef DEBUG_HTTP_SERVER
 #include <Trace.h>
 #endif
 
+#ifndef HTTP_WORKERS_POOL_SIZE
+/// @brief The number of pre-allocated worker tasks that serve client requests.
+/// Can be overridden from the build flags.
+#define HTTP_WORKERS_POOL_SIZE 4
+#endif
+#ifndef HTTP_REQUESTS_QUEUE_DEPTH
+/// @brief The maximum number of accepted client connections that may wait for a free worker.
+/// Can be overridden from the build flags.
+#define HTTP_REQUESTS_QUEUE_DEPTH 8
+#endif
+#ifndef HTTP_WORKER_STACK_SIZE
+/// @brief The stack size, in bytes, of each worker task.
+#define HTTP_WORKER_STACK_SIZE (4 * 1024)
+#endif
+#ifndef HTTP_ACCEPT_POLL_INTERVAL
+/// @brief The time, in milliseconds, that the accept task sleeps between checks for incoming connections,
+/// when no client is connecting.
+#define HTTP_ACCEPT_POLL_INTERVAL 10
+#endif
+#ifndef HTTP_ACCEPT_STACK_SIZE
+/// @brief The stack size, in bytes, of the accept task.
+#define HTTP_ACCEPT_STACK_SIZE (3 * 1024)
+#endif
+#ifndef HTTP_IDLE_POLL_INTERVAL
+/// @brief The longest time, in milliseconds, between checks for data on a connection that waits for a request.
+/// A connection that stays idle is checked less and less often, up to this interval.
+#define HTTP_IDLE_POLL_INTERVAL 8
+#endif
+#ifndef HTTP_RETRY_AFTER
+/// @brief The time, in seconds, that a client is asked to wait before it retries a connection that was rejected
+/// because all the workers were busy and the requests queue was full.
+#define HTTP_RETRY_AFTER 2
+#endif
+#ifndef HTTP_KEEP_ALIVE_TIMEOUT
+/// @brief The time, in milliseconds, that a persistent connection may stay idle between requests.
+#define HTTP_KEEP_ALIVE_TIMEOUT 5000
+#endif
+#ifndef HTTP_KEEP_ALIVE_MAX_REQUESTS
+/// @brief The maximum number of requests that are served on a single persistent connection.
+#define HTTP_KEEP_ALIVE_MAX_REQUESTS 100
+#endif
+
+/// @brief The route that the metrics of requests that are served by the default controller are collected under
+#define HTTP_METRICS_FILES_ROUTE "/*"
+/// @brief The route that the metrics of requests that no controller was found for are collected under
+#define HTTP_METRICS_NOT_FOUND_ROUTE "NOT_FOUND"
+
 /// @brief This is a class that implements an HTTP server.
 /// It handles incoming HTTP requests, routes them to the appropriate controllers,
 /// and serves static files or dynamic content based on the request type.
@@ -32,57 +80,97 @@ class HTTPServer
 {
 public:
     /// @brief Initializes the HTTP server.
-    /// This method sets up the server to listen for incoming connections on port 80.
-    static void Init();
-    /// @brief This method should repeatedly be called from the program loop.
-    /// It checks for incoming client connections and serves requests.
-    /// The request is actually served in a task that is created for each client request.
-    static void ServeClient();
+    /// This method creates the pool of worker tasks and the queue that feeds them,
+    /// sets up the server to listen for incoming connections on port 80, and starts the task that accepts them.
+    /// @param canServe Called by the accept task before it checks for incoming connections.
+    /// Connections are not accepted while it returns false. If it is NULL, connections are always accepted.
+    static void Init(bool (*canServe)() = NULL);
     /// @brief Adds a controller that serves specific client requests. Per each client request,
     /// the server will check if the request matches the controller's path and call the appropriate method
     /// (Get, Post, Put, Delete) based on the request type.
     /// @param path The path that the controller will handle. This is typically a URL path that the client requests.
     /// @param getControllerInstance A function pointer that returns an instance of the controller.
+    /// @note Controllers should be added before the server is initialized. When several paths match a request,
+    /// the longest one is used. Paths are matched case-insensitively.
     static void AddController(const String path, GetControllerInstance getControllerInstance);
 
+    /// @brief Admission statistics of client connections
+    typedef struct
+    {
+        uint32_t accepted; // Number of connections that were queued to the workers
+        uint32_t rejected; // Number of connections that were rejected with 503 Service Unavailable, because the queue was full
+        uint32_t expired; // Number of connections that were closed because the client was too slow
+        size_t queued; // Number of connections that currently wait for a free worker
+        size_t maxQueued; // The highest number of connections that waited for a free worker at once
+    } AdmissionStats;
+    /// @brief Gets the admission statistics of client connections.
+    /// @param stats Filled with the statistics.
+    static void getAdmissionStats(AdmissionStats &stats);
+
 public:
     /// @brief Send a 304 Not Modified response to the client.
     /// This method is called when the requested resource has not been modified since the last request,
-    /// @param client The EthClient instance representing the client connection.
-    static void NotModified(EthClient &client);
+    /// @param context The HTTP client context of the request.
+    /// @param etag The entity tag of the resource, if it has one.
+    static void NotModified(HttpClientContext &context, const String &etag = "");
     /// @brief Sends a 404 Not Found response to the client.
     /// This method is called when the requested resource is not found on the server.
-    /// @param client The EthClient instance representing the client connection.
-    static void PageNotFound(EthClient &client);
+    /// @param context The HTTP client context of the request.
+    static void PageNotFound(HttpClientContext &context);
+    /// @brief Sends a 503 Service Unavailable response to a client that cannot be served at this time.
+    /// The response asks the client to retry after HTTP_RETRY_AFTER seconds, and closes the connection.
+    /// @param client The client connection.
+    static void ServiceUnavailable(EthClient &client);
     static std::shared_ptr<HttpController> (*getDefaultController)(const char *resource);
     static void stop() { stopServer = true; }
     static void restart() { stopServer = false; }
 
 private:
+    /// @brief Checks for an incoming client connection and queues it to the workers pool.
+    /// The request is actually served by one of the pre-allocated worker tasks.
+    /// @return True if a client connection was handled, false if no client is connecting.
+    static bool ServeClient();
+    /// @brief The function of the task that accepts client connections.
+    /// @param params Unused.
+    /// The task polls the server for incoming connections. As long as clients keep connecting, it checks again right away.
+    /// Otherwise it sleeps for HTTP_ACCEPT_POLL_INTERVAL, so the program loop and the other tasks are not starved.
+    static void AcceptTask(void *params);
     /// @brief Gets the controller instance for the specified path.
-    /// This method searches through the registered controllers to find one that matches the given path.
+    /// This method looks up the registered controllers for the one with the longest path that matches the resource.
     /// @param context The HTTP client context containing the request information.
     /// @param controller A reference to a pointer that will be set to the controller instance if found.
     /// @param id An optional identifier for the resource being requested.
     /// @return Returns true if a controller was found and set, false otherwise.
-    static bool GetController(HttpClientContext *context, std::shared_ptr<HttpController> &controller, String &id);
+    /// @param route Set to the route of the request, for the metrics of the server.
+    static bool GetController(HttpClientContext *context, std::shared_ptr<HttpController> &controller, String &id, String &route);
     /// @brief Handles the HTTP request by routing it to the appropriate controller.
     /// This method checks the request type and calls the corresponding method on the controller.
     static void ServiceRequest(HttpClientContext *context);
-    /// @brief The task function that handles the client request
-    /// @param params Pointer to parameters passed to the task, which is actually an HttpClientContext pointer.
-    /// This function is called when a new client connection is accepted.
-    /// @note This function calls the RequestTask(HttpClientContext*) function. It is doing initialization before calling
-    /// the RequestTask(HttpClientContext*) function and is doing cleanup after calling it. This separation is done to 
-    /// allow for better organization and readability of the code.
-    static void RequestTask(void *params);
-    /// @brief Requests a task to handle the client request.
+    /// @brief Records the latency and throughput metrics of a request that was served.
+    /// @param context The HTTP client context of the request.
+    /// @param route The route of the request.
+    /// @param succeeded Whether the controller served the request.
+    static void RecordMetrics(HttpClientContext *context, const String &route, bool succeeded);
+    /// @brief The function of the worker tasks that handle client requests.
+    /// @param params Unused.
+    /// Each worker waits on the requests queue for a client context that was queued by ServeClient(),
+    /// serves it by calling RequestTask(HttpClientContext*) and then cleans up and waits for the next one.
+    /// The worker tasks are never deleted.
+    static void RequestWorker(void *params);
+    /// @brief Handles the requests of a single client connection.
     /// @param context The HTTP client context containing the request information.
-    /// This method is called when a new client connection is accepted, and it creates a task to handle the request asynchronously.
-    /// It allows the server to handle multiple client requests concurrently without blocking the main loop.
-    /// @note This method is called from the RequestTask(void*) function. It is doing the actual work of handling the request.
-    /// It is separated from the RequestTask(void*) function to allow for better organization and readability
+    /// As long as the connection is persistent, the requests sent on it are served one after the other.
+    /// The loop ends when the client asks to close the connection, when the connection stays idle for HTTP_KEEP_ALIVE_TIMEOUT,
+    /// or earlier when it is idle and other clients are waiting for a worker, or after HTTP_KEEP_ALIVE_MAX_REQUESTS requests.
+    /// @note This method is called from the RequestWorker() function. It is doing the actual work of handling the request.
+    /// It is separated from the RequestWorker() function to allow for better organization and readability
     static void RequestTask(HttpClientContext *context);
+    /// @brief Waits for the next request to arrive on the client connection.
+    /// @param context The HTTP client context.
+    /// @param timeout The maximum time to wait, in milliseconds.
+    /// @param yieldToQueue If true, stop waiting as soon as other clients wait in the requests queue.
+    /// @return True if data of a request is available, false otherwise.
+    static bool WaitForRequest(HttpClientContext *context, unsigned long timeout, bool yieldToQueue);
 
 private:
     /// @brief The server instance that listens for incoming connections.
@@ -90,50 +178,28 @@ private:
     /// @brief Indicates whether the server should stop accepting new connections.
     /// This is used to gracefully shut down the server when needed.
     static bool stopServer;
-    /// @brief THis class handles creation of HttpControllers
-    class HttpControllerCreatorData{
-    public:    
-        /// @brief The class constructor for HttpControllerCreatorData.
-        /// @param path The path that the controller handles. This is typically a URL path that the client requests.
-        /// @param instanceGetter A function pointer that returns an instance of the controller.
-        HttpControllerCreatorData(const String path, GetControllerInstance instanceGetter) :
-            path(path),
-            instanceGetter(instanceGetter)
-        {}
-
-        /// @brief A copy constructor for HttpControllerCreatorData.
-        /// @param other Another instance of HttpControllerCreatorData to copy from.
-        HttpControllerCreatorData(const HttpControllerCreatorData &other) : 
-            path(other.path),
-            instanceGetter(other.instanceGetter)
-        {}
-
-        /// @brief Returns the path that this controller handles.
-        /// @return Returns the path as a String.
-        const String getPath() const { return path; }
-        /// @brief Returns the function pointer that returns an instance of the controller.
-        /// @return Returns the function pointer as a GetControllerInstance type. 
-        const GetControllerInstance getInstanceGetter() const { return instanceGetter; }
-    private:
-        /// @brief The path that this controller handles.
-        const String path;
-        /// @brief A function pointer that returns an instance of the controller.
-        GetControllerInstance instanceGetter;
-    };
-
-    typedef LinkedList<HttpControllerCreatorData> ControllersDataList;
-    /// @brief A list of controllers that handle specific client requests.
-    /// This list is used to store the registered controllers and their associated paths.
-    /// Upon receiving a client request, the server will check this list to find a matching controller
-    /// and will retrieve an instance of the controller to handle the request.
-    static ControllersDataList controllersData;
+    /// @brief The queue of accepted client contexts waiting to be served by the worker tasks.
+    static QueueHandle_t requestsQueue;
+    /// @brief Called by the accept task to check whether connections may be accepted
+    static bool (*canServe)();
+    /// @brief Admission counters. They are updated only by ServeClient(), from the accept task.
+    static uint32_t acceptedConnections;
+    static uint32_t rejectedConnections;
+    /// @brief Updated by the workers, possibly by two of them at once.
+    static std::atomic<uint32_t> expiredConnections;
+    static size_t maxQueuedConnections;
+    typedef PathTrie<GetControllerInstance> ControllersTrie;
+    /// @brief A trie of the paths of the controllers that handle specific client requests.
+    /// The trie is built while the controllers are registered by AddController(), before the server is started.
+    /// Upon receiving a client request, the server looks up the resource in the trie in a single pass
+    /// and retrieves an instance of the matching controller to handle the request.
+    static ControllersTrie controllers;
 };
 
 /// @brief Initializes the HTTP server.
 /// This function should be called once at the beginning of the program to set up the server.
-void InitHTTPServer();
-/// @brief Repeatedly calls the HTTP service function.
-/// This function should be called in the main loop of the program to handle incoming client requests.
-void DoHTTPService();
+/// Incoming client requests are then handled by the tasks of the server, the program loop is not involved.
+/// @param canServe Called before checking for incoming connections, connections are not accepted while it returns false.
+void InitHTTPServer(bool (*canServe)() = NULL);
 
 #endif // HTTPServer_h
\ No newline at end of file
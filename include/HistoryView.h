@@ -20,24 +20,54 @@
 #define HistoryView_h
 
 #include <FileView.h>
-#include <Lock.h>
+#include <memory>
 
-/// @brief History view file reader
-class HistoryViewReader : public FileViewReader
+/// @brief History view reader
+/// The history view is generated while it is read. The filler indicators in the history view file are replaced
+/// by the history, one history item at a time. So the generated view is neither kept in memory nor written to the SD card,
+/// and its size is not known in advance.
+class HistoryViewReader : public ViewReader
 {
 public:
     HistoryViewReader(const char *viewFile) :
-        FileViewReader(viewFile)
+        templateReader(new FileViewReader(viewFile))
     {}
 
     /// @brief Opens the history view file for reading.
-    /// @param buff The buffer to read the file contents into.
+    /// @param buff The buffer to read the generated view into.
     /// @param buffSize The size of the buffer.
     /// @return True if the operation was successful, false otherwise.
     virtual bool open(byte *buff, int buffSize);
+    virtual void close() { templateReader->close(); }
+    /// @brief The history view changes with the history, so it has no last modified time.
+    virtual bool getLastModifiedTime(String &lastModifiedTimeStr) { return false; }
+    virtual CONTENT_TYPE getContentType() { return templateReader->getContentType(); }
+    /// @brief The size of the generated view is not known in advance.
+    /// @return -1
+    virtual long getViewSize() { return -1; }
+    /// @brief Reads the next part of the generated view into the buffer.
+    /// @param offset offset in the buffer to start reading to.
+    /// @return The number of bytes read, or -1 if there is no more data or the generation failed.
+    virtual int read(int offset);
 
 private:
-    static CriticalSection cs;
+    bool readTemplate();
+
+private:
+    struct Filler;
+    static const Filler fillers[];
+    /// @brief The reader of the history view file, the template of the generated view.
+    std::unique_ptr<ViewReader> templateReader;
+    std::unique_ptr<byte[]> templateBuff;
+    int templateOffset;
+    int templateLength;
+    bool endOfTemplate;
+    /// @brief The filler that is currently generated, and the next part of it to generate.
+    const Filler *filler;
+    int part;
+    /// @brief The generated part of the current filler and the number of its bytes that were already read.
+    String fill;
+    unsigned int fillOffset;
 };
 
 /// @brief History view
@@ -25,6 +25,7 @@
 #include <MemViewReader.h>
 
 /// @brief HTML filler view
+/// The fillers of the view are expanded to the length of their values, so the view is sent in chunks.
 class HtmlFillerView : public View
 {
 public:
@@ -32,7 +33,7 @@ public:
     /// @param viewFilePath The path to the view file
     /// @param getFillers The function to get the fillers
     HtmlFillerView(const char *viewFilePath, GetFillers getFillers) :
-        View(std::unique_ptr<ViewReader>(new HtmlFillerViewReader(std::unique_ptr<ViewReader>(new FileViewReader(viewFilePath)), getFillers)))
+        View(std::unique_ptr<ViewReader>(new HtmlFillerViewReader(std::unique_ptr<ViewReader>(new FileViewReader(viewFilePath)), getFillers, true)))
     {
     }
 
@@ -42,7 +43,7 @@ public:
     /// @param contentType The content type of the view
     /// @param getFillers The function to get the fillers
     HtmlFillerView(const byte *mem, size_t size, CONTENT_TYPE contentType, GetFillers getFillers) :
-        View(std::unique_ptr<ViewReader>(new HtmlFillerViewReader(std::unique_ptr<ViewReader>(new MemViewReader(mem, size, contentType)), getFillers)))
+        View(std::unique_ptr<ViewReader>(new HtmlFillerViewReader(std::unique_ptr<ViewReader>(new MemViewReader(mem, size, contentType)), getFillers, true)))
     {
     }
 
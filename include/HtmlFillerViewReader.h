@@ -33,6 +33,9 @@ typedef int (*GetFillers)(const ViewFiller *&fillers);
 /// After the filler index there should be enough spaces to fill the value.
 /// If the filler index is not valid or there is not enough space in the buffer to fill the value, it will
 /// fill whatever possible and will continue processing rest of the buffer.
+/// When the reader expands the fillers, the filler index and the spaces that follow it are replaced by the
+/// filler value followed by a single space, whatever the length of the value is. In this case the size of the
+/// view is not known in advance and getViewSize() returns -1.
 class HtmlFillerViewReader : public ViewReader
 {
 public:
@@ -44,16 +47,19 @@ public:
     /// When the HtmlFillerViewReader is deleted, it will also delete the viewReader.
     /// @param getFillers A function that retrieves the fillers from the provided GetFillers function.
     /// It should return the number of fillers available and fill the fillers array with the appropriate values
-    HtmlFillerViewReader(std::unique_ptr<ViewReader> viewReader, GetFillers getFillers) :
+    /// @param expandFillers If true, the fillers are expanded to the length of their values.
+    /// Otherwise, the values are written over the spaces that follow the filler indices.
+    HtmlFillerViewReader(std::unique_ptr<ViewReader> viewReader, GetFillers getFillers, bool expandFillers = false) :
+        getFillers(getFillers),
         viewReader(std::move(viewReader)),
-        getFillers(getFillers)
+        expandFillers(expandFillers)
     {
     }
 
     virtual void close() { viewReader->close(); };
     virtual bool getLastModifiedTime(String &lastModifiedTimeStr) { return viewReader->getLastModifiedTime(lastModifiedTimeStr); };
     virtual CONTENT_TYPE getContentType() { return viewReader->getContentType(); };
-    virtual long getViewSize() { return viewReader->getViewSize(); };
+    virtual long getViewSize() { return expandFillers ? -1 : viewReader->getViewSize(); };
     virtual bool open(byte *buff, int buffSize);
     virtual int read();
     virtual int read(int offset) { return -1; }
@@ -65,10 +71,23 @@ protected:
 private:
     size_t viewHandler(size_t buffSize, bool last = false);
     bool DoFill(int nFill, String &fill);
+    int expandingRead();
+    bool readSource();
 
 private:
     int offset;
     bool endOfView;
+    bool expandFillers;
+    /// @brief The buffer that the underlying view is read into when the fillers are expanded.
+    std::unique_ptr<byte[]> source;
+    int sourceOffset;
+    int sourceLength;
+    bool endOfSource;
+    /// @brief The value of the current filler and the number of its bytes that were already read.
+    String fill;
+    unsigned int fillOffset;
+    /// @brief Indicates that the spaces after the current filler index should be skipped.
+    bool skipSpaces;
 };
 
 #endif // HtmlFillerViewReader_h
\ No newline at end of file
@@ -21,12 +21,20 @@
 
 #include <Arduino.h>
 #include <HttpHeaders.h>
+#include <HttpReceiveBuffer.h>
+#include <SocketBudget.h>
+#include <ConnectionDeadline.h>
 #include <array>
 
-#define N_COLLECTED_HEADERS 3
+#define N_COLLECTED_HEADERS 8
 #define IF_MODIFIED_SINCE_HEADER_NAME "If-Modified-Since"
 #define CONTENT_LENGTH_HEADER_NAME "Content-Length"
 #define CONTENT_TYPE_HEADER_NAME "Content-Type"
+#define CONNECTION_HEADER_NAME "Connection"
+#define ACCEPT_ENCODING_HEADER_NAME "Accept-Encoding"
+#define IF_NONE_MATCH_HEADER_NAME "If-None-Match"
+#define RANGE_HEADER_NAME "Range"
+#define LAST_EVENT_ID_HEADER_NAME "Last-Event-ID"
 
 typedef std::array<HttpHeaders::Header, N_COLLECTED_HEADERS> CollectedHeaders;
 #define GET_HEADER_BY_NAME(headerName) \
@@ -45,6 +53,11 @@ public:
     /// This constructor initializes the context with the client connection and prepares to parse the request headers.
     HttpClientContext(EthClient &client);
 
+    /// @brief Prepares the context for the next request on the same client connection.
+    /// This method clears everything that was parsed from the previous request.
+    /// Data that was already received for the next request is kept.
+    /// @param remainingRequests The number of requests that may still be served on the connection after the next one.
+    void reset(int remainingRequests);
     /// @brief Parses the request header section from the client connection.
     /// This method reads the HTTP request headers from the client connection and determines the request type (GET, POST, etc.).
     /// It also extracts the requested resource and collects relevant headers.
@@ -63,6 +76,55 @@ public:
     /// It allows the caller to interact with the client connection, such as reading data, writing responses, or checking connection status.
     /// @return Returns a reference to the EthClient instance associated with this context.
     EthClient &getClient() { return client; }
+    /// @brief Returns the number of bytes of the request that can be read without waiting.
+    /// @note Once the request header section is parsed, the rest of the request must be read through the context
+    /// and not directly from the client, because part of it may already be received.
+    int available() { return receiveBuffer.available(); }
+    /// @brief Reads a single byte of the request.
+    /// @return The byte, or -1 if no data is available.
+    int read()
+    {
+        int c = receiveBuffer.read();
+        if (c >= 0)
+            deadline.progress(1);
+        return c;
+    }
+    /// @brief Reads data of the request.
+    /// @param buf The buffer to read into.
+    /// @param size The size of buf.
+    /// @return The number of bytes read, or -1 if no data is available.
+    int read(uint8_t *buf, size_t size)
+    {
+        int n = receiveBuffer.read(buf, size);
+        if (n > 0)
+            deadline.progress(n);
+        return n;
+    }
+    /// @brief Waits for data of the request to be available.
+    /// The wait is bound by the deadline of the request, a client that stalls or trickles the data expires the request.
+    /// @return true if data is available, false if the client disconnected or the request expired.
+    bool waitForData();
+    /// @brief Writes data of the response to the client.
+    /// The data is written as the client makes room for it. The time the write waits for room counts against
+    /// the deadline of the request, and the write stops once the request expires.
+    /// @param buf The data.
+    /// @param size The size of the data.
+    /// @return The number of bytes that were written.
+    size_t write(const uint8_t *buf, size_t size);
+    /// @brief Indicates whether the request expired, because the client was too slow to send the request or to receive the response.
+    /// The connection of an expired request is closed once the request is done.
+    /// @param currentWait The time, in milliseconds, of a wait for the client that is in progress, and was not accounted for yet.
+    bool isExpired(unsigned long currentWait = 0) const { return expired || deadline.isExpired(currentWait); }
+    /// @brief Accounts for time that was spent waiting for the client outside of the context,
+    /// e.g. by a sender that writes the response directly to the socket.
+    /// @param time The time, in milliseconds.
+    void onWaited(unsigned long time)
+    {
+        // A single wait as long as the idle timeout expires the request, as well as a client that is too slow overall
+        if (deadline.isExpired(time))
+            expired = true;
+        deadline.waited(time);
+    }
     /// @brief Returns the remote port of the client connection.
     /// @return Returns the remote port as a uint16_t value.
     uint16_t getRemotePort() const { return remotePort; }
@@ -71,16 +133,75 @@ public:
     /// This header is typically used to determine if the requested resource has been modified since the specified date and time.
     /// If the header is not present, it will return an empty String.
     String getLastModified() const { return GET_HEADER_BY_NAME(IF_MODIFIED_SINCE_HEADER_NAME)->value; }
+    /// @brief Returns the value of the "If-None-Match" header.
+    /// @return Returns the value of the "If-None-Match" header as a String.
+    /// This header holds the entity tags of the copies of the requested resource that the client already has.
+    /// If the header is not present, it will return an empty String.
+    String getIfNoneMatch() const { return GET_HEADER_BY_NAME(IF_NONE_MATCH_HEADER_NAME)->value; }
+    /// @brief Returns the value of the "Range" header.
+    /// @return Returns the value of the "Range" header as a String.
+    /// This header requests only a part of the resource, e.g. "bytes=100-199".
+    /// If the header is not present, it will return an empty String.
+    String getRange() const { return GET_HEADER_BY_NAME(RANGE_HEADER_NAME)->value; }
+    /// @brief Returns the value of the "Last-Event-ID" header.
+    /// @return Returns the value of the "Last-Event-ID" header as a String.
+    /// A browser that reconnects to an event stream sends the ID of the last event it received in this header.
+    /// If the header is not present, it will return an empty String.
+    String getLastEventId() const { return GET_HEADER_BY_NAME(LAST_EVENT_ID_HEADER_NAME)->value; }
     /// @brief Returns the value of the "Content-Length" header.
     /// @return Returns the value of the "Content-Length" header as a size_t.
     size_t getContentLength() const { return atoi(GET_HEADER_BY_NAME(CONTENT_LENGTH_HEADER_NAME)->value.c_str()); }
     /// @brief Returns the value of the "Content-Type" header.
     /// @return Returns the value of the "Content-Type" header as a String.
     String getContentType() const { return GET_HEADER_BY_NAME(CONTENT_TYPE_HEADER_NAME)->value; }
+    /// @brief Indicates whether the client accepts gzip encoded content, according to the "Accept-Encoding" header.
+    /// @return Returns true if the client accepts gzip encoded content, false otherwise.
+    bool acceptsGzip() const;
     /// @brief Returns the requested resource from the HTTP request.
     /// @return Returns the requested resource as a String.
     /// The resource is typically the path or URL that the client is trying to access.
-    String getResource() const { return resource; }
+    const String &getResource() const { return resource; }
+    /// @brief Returns the HTTP version of the request, as sent in the request line (e.g. "HTTP/1.1").
+    /// @return Returns the HTTP version as a String.
+    const String &getHttpVersion() const { return httpVersion; }
+    /// @brief Indicates whether the connection persists after the response, so the client may send another request on it.
+    /// @return Returns true if the connection is persistent, false if it is closed after the response.
+    /// @note The persistence is determined when the request header section is parsed, according to the HTTP version
+    /// and the "Connection" header of the request.
+    bool isPersistent() const { return persistent; }
+    /// @brief Makes the connection close after the response to the current request.
+    /// This method must be called before the response headers are sent.
+    void closeAfterResponse() { persistent = false; }
+    /// @brief Returns the number of requests that may still be served on the connection after the current one.
+    /// @return Returns the number of remaining requests.
+    int getRemainingRequests() const { return remainingRequests; }
+    /// @brief Accounts for data of the response that was sent to the client.
+    /// The time of the first call is taken as the time of the first byte of the response.
+    /// @param size The number of bytes that were sent.
+    void onResponseSent(size_t size)
+    {
+        if (firstByteTime == 0)
+            firstByteTime = micros();
+        bytesSent += size;
+        deadline.progress(size);
+    }
+    /// @brief Returns the time, in microseconds, when the current request started to be served.
+    uint32_t getRequestStartTime() const { return requestStartTime; }
+    /// @brief Returns the time, in microseconds, when the request header section was parsed.
+    uint32_t getParsedTime() const { return parsedTime; }
+    /// @brief Returns the time, in microseconds, when the first byte of the response was sent, or 0 if nothing was sent yet.
+    uint32_t getFirstByteTime() const { return firstByteTime; }
+    /// @brief Returns the number of bytes that were sent in the response so far.
+    size_t getBytesSent() const { return bytesSent; }
+    /// @brief Returns the class of the socket of the connection in the socket budget.
+    SocketClass getSocketClass() const { return socketClass; }
+    /// @brief Moves the socket of the connection to another class of the socket budget.
+    /// @param cls The new class, e.g. SocketClass::SSE when the connection is handed over to an SSE stream.
+    void setSocketClass(SocketClass cls)
+    {
+        SocketBudget::reclassify(socketClass, cls);
+        socketClass = cls;
+    }
     /// @brief Indicates whether the connection should be kept alive after the request is processed.
     /// @return Returns true if the connection should be kept alive, false otherwise.
     bool keepAlive;
@@ -93,11 +214,31 @@ private:
     HTTP_REQ_TYPE requestType;
     /// @brief The EthClient instance representing the client connection.
     EthClient client;
+    /// @brief The buffer that the requests of the client connection are received into.
+    HttpReceiveBuffer receiveBuffer;
     /// @brief The remote port of the client connection.
     uint16_t remotePort;
     /// @brief The requested resource from the HTTP request.
     /// This string holds the path or URL that the client is trying to access.
     String resource;
+    /// @brief The HTTP version from the request line.
+    String httpVersion;
+    /// @brief Indicates whether the connection persists after the response.
+    bool persistent;
+    /// @brief The number of requests that may still be served on the connection after the current one.
+    int remainingRequests;
+    /// @brief Timing of the current request, in microseconds, for the metrics of the server.
+    uint32_t requestStartTime;
+    uint32_t parsedTime;
+    uint32_t firstByteTime;
+    /// @brief The number of bytes that were sent in the response to the current request.
+    size_t bytesSent;
+    /// @brief The class of the socket of the connection in the socket budget.
+    SocketClass socketClass;
+    /// @brief The deadline of the current request.
+    ConnectionDeadline deadline;
+    /// @brief Indicates that the current request expired while waiting for the client.
+    bool expired;
 };
 
 #endif // HttpClientContext_h
\ No newline at end of file
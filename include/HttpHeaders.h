@@ -56,22 +56,38 @@ enum class HTTP_REQ_TYPE
 
 #define DEFAULT_RECEIVE_TIMEOUT 3000
 
+#ifndef HTTP_HEADER_SECTION_BUFF_SIZE
+/// @brief The size of the buffer that the header section of a response is assembled in before it is sent.
+#define HTTP_HEADER_SECTION_BUFF_SIZE 512
+#endif
+
+class HttpClientContext;
+class HttpReceiveBuffer;
+
 class HttpHeaders
 {
 public:
     HttpHeaders(EthClient &client) : 
         client(client),
-        receiveTimeout(DEFAULT_RECEIVE_TIMEOUT)
+        context(NULL),
+        receiveTimeout(DEFAULT_RECEIVE_TIMEOUT),
+        persistent(false),
+        remainingRequests(0)
     {        
     }
 
+    /// @brief Constructs an HttpHeaders instance for sending the response to a request.
+    /// @param context The context of the request.
+    /// The "Connection" header of the response reflects whether the connection of the request is persistent.
+    HttpHeaders(HttpClientContext &context);
+
     /// @brief HTTP header structure
     typedef struct _header
     {
         _header() : _header("", "") {} // Default constructor, creates an empty header
         _header(String name) : _header(name, "") {} // Constructor with name only
         _header(const char *name) : _header(String(name), "") {} // Constructor with C-style string
-        _header(CONTENT_TYPE contentType) : _header("Content-Type", contentTypeValues.at(contentType)) {} // Constructor with content type
+        _header(CONTENT_TYPE contentType) : _header("Content-Type", getContentTypeValue(contentType)) {} // Constructor with content type
         _header(String name, String value) : name(name), value(value) {} // Constructor with name and value
         String name; // Header name
         String value; // Header value
@@ -83,7 +99,16 @@ public:
     /// @param headers Custom headers to include
     /// @param nHeaders Number of custom headers
     /// @param length The length to be set in the content length header. If includeDefaultHeaders is false, this value is ignored.
+    /// If the length is negative, the content length header is not sent (e.g. for a chunked response).
+    /// @note The header section is assembled in a buffer and sent to the client in a single write.
     void sendHeaderSection(int code, bool includeDefaultHeaders = true, Header headers[] = NULL, size_t nHeaders = 0, int length = 0);
+    /// @brief Sends an entire response, the header section along with a small body
+    /// @param code The HTTP status code
+    /// @param headers Custom headers to include, in addition to the default headers
+    /// @param nHeaders Number of custom headers
+    /// @param body The body of the response. The content length header is set to its length.
+    /// @note The body is sent in the same write as the header section, so a small response goes out in a single TCP segment.
+    void sendResponse(int code, Header headers[], size_t nHeaders, const String &body);
     /// @brief Sends an HTTP stream header section
     /// @note This function is used to send the headers for a streaming response such as SSE.
     void sendStreamHeaderSection();
@@ -95,33 +120,51 @@ public:
     /// @param header The header to send
     void sendHeader(const Header &header);
     /// @brief Parse the HTTP request header section
+    /// @param receiveBuffer The buffer that the request is received into
     /// @param requestType The request type
     /// @param resource The requested resource
-    /// @param collectedHeaders The headers collected from the request
+    /// @param collectedHeaders The headers collected from the request. Header names are matched case insensitively.
     /// @param nCollectedHeaders The number of collected headers
     /// @return True if the header section was successfully parsed, false otherwise
-    bool parseRequestHeaderSection(HTTP_REQ_TYPE &requestType, String &resource, Header collectedHeaders[] = NULL, size_t nCollectedHeaders = 0);
+    /// @note The request is received in bulk and each line is parsed in place in the receive buffer.
+    /// Data that follows the header section remains in the receive buffer.
+    bool parseRequestHeaderSection(HttpReceiveBuffer &receiveBuffer, HTTP_REQ_TYPE &requestType, String &resource, Header collectedHeaders[] = NULL, size_t nCollectedHeaders = 0);
     /// @brief Sets the receive timeout for the HTTP client
     /// @param timeout The timeout value in milliseconds
     void setReceiveTimeout(unsigned long timeout) { receiveTimeout = timeout; }
     /// @brief Gets the last parsed line
     /// @return The last parsed line
-    /// @note This function is used only for logging erroneous headers in debug builds
+    /// @note This function is used only for logging erroneous headers in debug builds, it is empty in other builds
     const String &getLastParsedLine() { return parsedLine; }
     /// @brief Gets the request line
     /// @return The request line
-    /// @note This function is used only for logging erroneous headers in debug builds
+    /// @note This function is used only for logging erroneous headers in debug builds, it is empty in other builds
     const String &getRequestLine() { return requestLine; }
+    /// @brief Gets the HTTP version from the last parsed request line
+    /// @return The HTTP version, e.g. "HTTP/1.1"
+    const String &getHttpVersion() { return httpVersion; }
+
+private:
+    void sendResponse(int code, bool includeDefaultHeaders, Header headers[], size_t nHeaders, int length, const char *body, size_t bodySize);
+    bool parseRequestLine(char *line, HTTP_REQ_TYPE &requestType, String &resource);
+    static const char *getCodeDescription(int code);
+    static const char *getContentTypeValue(CONTENT_TYPE contentType);
 
 private:
     String parsedLine; // The last parsed line
     String requestLine; // The request line
+    String httpVersion; // The HTTP version from the request line
     EthClient client; // The Ethernet client
+    HttpClientContext *context; // The context of the request that is responded to, NULL if there is none
     unsigned long receiveTimeout; // The receive timeout
-    static const std::map<int, String> codeDescriptions; // The HTTP status code descriptions
-    static const std::map<CONTENT_TYPE, String> contentTypeValues; // The content type values
-    typedef std::map<String, HTTP_REQ_TYPE> HttpReqTypesMap; // The HTTP request types map
-    static const HttpReqTypesMap httpReqTypesMap;
+    bool persistent; // Whether the connection persists after the response
+    int remainingRequests; // The number of requests that may still be sent on a persistent connection
+    typedef struct
+    {
+        const char *method;
+        HTTP_REQ_TYPE requestType;
+    } HttpReqType; // An HTTP request method and its type
+    static const HttpReqType httpReqTypes[];
 };
 #endif // TESTING
 #endif // HTTP_HEADERS_H
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef HttpMetrics_h
+#define HttpMetrics_h
+
+#include <Arduino.h>
+#include <Lock.h>
+#include <map>
+
+#ifndef HTTP_METRICS_MAX_ROUTES
+/// @brief The maximum number of routes that metrics are collected for. Requests of other routes are counted under OTHER_ROUTE.
+#define HTTP_METRICS_MAX_ROUTES 16
+#endif
+/// @brief The number of buckets of each latency histogram
+#define HTTP_METRICS_N_BUCKETS 12
+/// @brief The route that requests are counted under when there is no room for their own route
+#define HTTP_METRICS_OTHER_ROUTE "OTHER"
+
+/// @brief Collects request latency and throughput metrics of the HTTP server, per route.
+class HttpMetrics
+{
+public:
+    /// @brief A latency histogram. Times are in microseconds.
+    typedef struct
+    {
+        uint32_t count; // Number of samples
+        uint64_t sum; // Sum of the samples
+        uint32_t max; // The largest sample
+        uint32_t buckets[HTTP_METRICS_N_BUCKETS]; // Number of samples that are below each of bucketBounds, the last bucket counts the rest
+    } Histogram;
+
+    /// @brief The metrics of a route
+    typedef struct
+    {
+        uint32_t requests; // Number of requests
+        uint32_t failures; // Number of requests that the controller failed to serve
+        uint64_t bytesSent; // Number of bytes sent in responses
+        Histogram parse; // The time it took to receive and parse the request header section
+        Histogram firstByte; // The time from the start of the request to the first byte of the response
+        Histogram total; // The time from the start of the request to the end of the response
+    } RouteMetrics;
+
+    /// @brief The measurements of a single request. Times are in microseconds from the start of the request.
+    typedef struct
+    {
+        bool succeeded; // Whether the controller served the request
+        uint32_t parseTime; // The time when the request header section was parsed
+        uint32_t firstByteTime; // The time when the first byte of the response was sent, 0 if nothing was sent
+        uint32_t totalTime; // The time when the response ended
+        size_t bytesSent; // The number of bytes sent in the response
+    } Sample;
+
+    typedef std::map<String, RouteMetrics> Routes;
+
+    /// @brief Records the measurements of a request.
+    /// @param route The route that served the request, e.g. "/API/FILES".
+    /// @param sample The measurements.
+    static void record(const String &route, const Sample &sample);
+    /// @brief Gets a copy of the metrics of all the routes.
+    /// @param routes Filled with the metrics.
+    /// @return The time, in milliseconds, that the metrics are collected for.
+    static unsigned long getRoutes(Routes &routes);
+    /// @brief Clears all the metrics.
+    static void reset();
+
+    /// @brief The upper bounds, in microseconds, of all the histogram buckets but the last.
+    static const uint32_t bucketBounds[HTTP_METRICS_N_BUCKETS - 1];
+
+private:
+    static void addSample(Histogram &histogram, uint32_t value);
+
+private:
+    static CriticalSection cs;
+    static Routes routes;
+    /// @brief The time, in milliseconds, when the collection of the metrics started
+    static unsigned long startTime;
+};
+
+#endif // HttpMetrics_h
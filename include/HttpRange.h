@@ -0,0 +1,98 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef HttpRange_h
+#define HttpRange_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <strings.h>
+
+/// @brief A byte range of a resource, as requested by the "Range" header of a request.
+/// Only a single range is supported. A request for multiple ranges is answered with the entire resource,
+/// which is allowed by the HTTP specification.
+class HttpRange
+{
+public:
+    /// @brief The result of parsing a "Range" header
+    enum class Result
+    {
+        NONE, // There is no range, or it is ignored, the entire resource should be sent
+        SATISFIABLE, // The range is satisfiable, only the range should be sent (206)
+        UNSATISFIABLE // The range is not satisfiable (416)
+    };
+
+    /// @brief Parses the value of a "Range" header.
+    /// @param value The value of the header, e.g. "bytes=100-199", "bytes=100-" or "bytes=-100". May be empty.
+    /// @param size The size of the resource.
+    /// @param first Set to the offset of the first byte of the range, if the range is satisfiable.
+    /// @param last Set to the offset of the last byte of the range (inclusive), if the range is satisfiable.
+    /// @return The result of the parsing.
+    static Result parse(const char *value, size_t size, size_t &first, size_t &last)
+    {
+        static const char unit[] = "bytes=";
+        if (strncasecmp(value, unit, sizeof(unit) - 1) != 0)
+            return Result::NONE;
+        const char *p = value + sizeof(unit) - 1;
+
+        // The first byte position is missing in a suffix range, e.g. "bytes=-100", the last 100 bytes.
+        bool hasFirst = parseNumber(p, first);
+        if (*p++ != '-')
+            return Result::NONE;
+        bool hasLast = parseNumber(p, last);
+        // Multiple ranges, or trailing garbage
+        if (*p != '\0' || (!hasFirst && !hasLast))
+            return Result::NONE;
+
+        if (!hasFirst)
+        {
+            if (last == 0 || size == 0)
+                return Result::UNSATISFIABLE;
+            first = last < size ? size - last : 0;
+            last = size - 1;
+            return Result::SATISFIABLE;
+        }
+
+        if (hasLast && last < first)
+            // An invalid range is ignored
+            return Result::NONE;
+        if (first >= size)
+            return Result::UNSATISFIABLE;
+        if (!hasLast || last >= size)
+            last = size - 1;
+
+        return Result::SATISFIABLE;
+    }
+
+private:
+    /// @brief Parses a decimal number.
+    /// @param p The string to parse, it is advanced past the number.
+    /// @param number Set to the parsed number.
+    /// @return true if there was a number to parse, false otherwise.
+    static bool parseNumber(const char *&p, size_t &number)
+    {
+        number = 0;
+        const char *start = p;
+        for (; *p >= '0' && *p <= '9'; p++)
+            number = number * 10 + (*p - '0');
+
+        return p != start;
+    }
+};
+
+#endif // HttpRange_h
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef HttpReceiveBuffer_h
+#define HttpReceiveBuffer_h
+
+#include <Common.h>
+#include <EthernetUtil.h>
+
+#ifndef HTTP_RECEIVE_BUFF_SIZE
+/// @brief The size of the buffer that requests are received into.
+/// A request header line must fit in the buffer, unless it is a header that is not collected.
+#define HTTP_RECEIVE_BUFF_SIZE 1024
+#endif
+
+/// @brief A buffer that the requests of a client connection are received into in bulk.
+/// Reading the client one byte at a time costs an SPI transaction per byte on the wired build.
+/// Instead, whatever the client has sent is read into this buffer in a single read, and it is consumed from there.
+/// @note Data that was received beyond the request header section (the body, or the next request on a
+/// persistent connection) remains in the buffer. So once a request is parsed, it must be read through
+/// the buffer and not directly from the client.
+class HttpReceiveBuffer
+{
+public:
+    /// @brief Constructs a new, empty, receive buffer.
+    /// @param client The client connection to receive from.
+    HttpReceiveBuffer(EthClient &client) :
+        client(client),
+        offset(0),
+        length(0)
+    {
+    }
+
+    /// @brief Returns the number of bytes that can be read without waiting.
+    int available();
+    /// @brief Reads a single byte.
+    /// @return The byte, or -1 if no data is available.
+    int read();
+    /// @brief Reads data. Buffered data is returned first, and only then data is read from the client.
+    /// @param buf The buffer to read into.
+    /// @param size The size of buf.
+    /// @return The number of bytes read, or -1 if no data is available.
+    int read(uint8_t *buf, size_t size);
+
+    /// @brief Receives more data from the client into the buffer.
+    /// @param timeout The maximum time to wait for data, in milliseconds.
+    /// @return true if data was received, false on timeout, if the client disconnected, or if the buffer is full.
+    bool receive(unsigned long timeout);
+    /// @brief Returns the received data that was not consumed yet.
+    char *data() { return buff + offset; }
+    /// @brief Returns the number of received bytes that were not consumed yet.
+    size_t size() const { return length - offset; }
+    /// @brief Indicates whether no more data can be received before some of the data is consumed.
+    bool isFull() const { return size() == sizeof(buff); }
+    /// @brief Consumes received data.
+    /// @param n The number of bytes to consume.
+    /// @note The consumed data remains in place until more data is received.
+    void consume(size_t n) { offset += n; }
+
+private:
+    EthClient &client;
+    char buff[HTTP_RECEIVE_BUFF_SIZE];
+    size_t offset; // The offset of the data that was not consumed yet
+    size_t length; // The length of the received data
+};
+
+#endif // HttpReceiveBuffer_h
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#ifndef IdHashTable_h
+#define IdHashTable_h
+
+#include <Arduino.h>
+#include <Lock.h>
+
+/// @brief A thread-safe hash table of values that are keyed by numeric IDs.
+/// The table is an open addressing table with linear probing over a fixed array of slots,
+/// so inserting and deleting values does not allocate memory.
+/// @tparam T The type of the values stored in the table.
+/// @tparam N The number of slots, a power of 2. The table holds up to N values.
+template<typename T, size_t N>
+class IdHashTable
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "The number of slots must be a power of 2");
+
+private:
+    /// @brief A slot of the table.
+    struct Slot
+    {
+        bool used;
+        uint32_t id;
+        T value;
+    };
+
+public:
+    /// @brief Constructs a new empty IdHashTable.
+    IdHashTable() :
+        count(0)
+    {
+        for (Slot &slot : slots)
+            slot.used = false;
+    }
+
+    /// @brief Inserts a value into the table, replacing the value that has the same ID, if any.
+    /// @param id The ID of the value.
+    /// @param value The value to insert.
+    /// @return True if the value was inserted, false if the table is full.
+    bool Insert(uint32_t id, const T &value)
+    {
+        Lock lock(cs);
+
+        size_t i = FindSlot(id);
+        if (!IsSlotOf(i, id))
+        {
+            if (count == N)
+                return false;
+            slots[i].used = true;
+            slots[i].id = id;
+            count++;
+        }
+        slots[i].value = value;
+
+        return true;
+    }
+
+    /// @brief Finds the value that has a given ID and calls an action with it.
+    /// The action is called while the table is locked, and must not insert or delete values.
+    /// @param id The ID of the value.
+    /// @param action The action to call with the value.
+    /// @param param A parameter that is passed to the action.
+    /// @return True if the value was found, false otherwise.
+    bool Find(uint32_t id, void (*action)(T &value, void *param), void *param)
+    {
+        Lock lock(cs);
+
+        size_t i = FindSlot(id);
+        if (!IsSlotOf(i, id))
+            return false;
+        if (action != NULL)
+            action(slots[i].value, param);
+
+        return true;
+    }
+
+    /// @brief Checks if the table has a value with a given ID.
+    /// @param id The ID of the value.
+    /// @return True if the table has the value, false otherwise.
+    bool Contains(uint32_t id)
+    {
+        return Find(id, NULL, NULL);
+    }
+
+    /// @brief Deletes the value that has a given ID.
+    /// @param id The ID of the value.
+    /// @param action An optional action to call with the value before it is deleted, while the table is locked.
+    /// @param param A parameter that is passed to the action.
+    /// @return True if the value was found and deleted, false otherwise.
+    bool Delete(uint32_t id, void (*action)(T &value, void *param) = NULL, void *param = NULL)
+    {
+        Lock lock(cs);
+
+        size_t i = FindSlot(id);
+        if (!IsSlotOf(i, id))
+            return false;
+        if (action != NULL)
+            action(slots[i].value, param);
+
+        // Move back the values that follow in the same probe sequence, so there are no holes in it.
+        // The sequence ends at an empty slot, or after all the other slots if the table is full.
+        size_t j = i;
+        for (size_t n = 1; n < N && slots[j = Next(j)].used; n++)
+        {
+            size_t home = Hash(slots[j].id);
+            // The value stays if its home slot is cyclically in (i, j]
+            if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+                continue;
+            slots[i].id = slots[j].id;
+            slots[i].value = slots[j].value;
+            i = j;
+        }
+        slots[i].used = false;
+        slots[i].value = T();
+        count--;
+
+        return true;
+    }
+
+    /// @brief Returns the number of values in the table.
+    size_t Count()
+    {
+        Lock lock(cs);
+        return count;
+    }
+
+    /// @brief Scans the values of the table, in no particular order.
+    /// The action is called while the table is locked, and must not insert or delete values.
+    /// @param action The action to call for each value. It returns false to stop the scan.
+    /// @param param A parameter that is passed to the action.
+    void ScanNodes(bool (*action)(uint32_t id, T &value, void *param), void *param)
+    {
+        Lock lock(cs);
+
+        for (Slot &slot : slots)
+        {
+            if (slot.used && !action(slot.id, slot.value, param))
+                break;
+        }
+    }
+
+private:
+    /// @brief Returns the home slot of an ID.
+    static size_t Hash(uint32_t id)
+    {
+        // Fibonacci hashing spreads consecutive IDs over the table
+        return (id * 2654435769u) >> 16 & (N - 1);
+    }
+
+    /// @brief Returns the slot that follows a slot, cyclically.
+    static size_t Next(size_t i)
+    {
+        return (i + 1) & (N - 1);
+    }
+
+    /// @brief Indicates whether a slot holds the value of an ID.
+    bool IsSlotOf(size_t i, uint32_t id) const
+    {
+        return slots[i].used && slots[i].id == id;
+    }
+
+    /// @brief Returns the slot of an ID, or the empty slot where it would be inserted.
+    /// If the table is full and the ID is not in it, returns a slot of another ID.
+    size_t FindSlot(uint32_t id) const
+    {
+        size_t i = Hash(id);
+        for (size_t n = 0; n < N && slots[i].used && slots[i].id != id; n++)
+            i = Next(i);
+        return i;
+    }
+
+private:
+    Slot slots[N];
+    size_t count;
+    CriticalSection cs;
+};
+
+#endif // IdHashTable_h
@@ -29,7 +29,7 @@ class IndexView : public HtmlFillerView
 {
 public:
     IndexView();     
-    bool redirect(EthClient &client, const String &_id);
+    bool redirect(HttpClientContext &context, const String &_id);
     static std::shared_ptr<HttpController> getInstance() { return std::make_shared<IndexView>(); }
 
 protected:
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef LogStream_h
+#define LogStream_h
+
+#include <Arduino.h>
+#include <Lock.h>
+
+#ifndef LOG_STREAM_MAX_SUBSCRIBERS
+/// @brief The number of clients that may tail the log at once.
+#define LOG_STREAM_MAX_SUBSCRIBERS 2
+#endif
+#ifndef LOG_STREAM_BUFF_SIZE
+/// @brief The size of the buffer of each subscriber. Lines that do not fit while the subscriber is behind are dropped.
+#define LOG_STREAM_BUFF_SIZE 2048
+#endif
+#ifndef LOG_STREAM_LINE_SIZE
+/// @brief The longest line that is streamed, longer lines are truncated.
+#define LOG_STREAM_LINE_SIZE 160
+#endif
+
+/// @brief The level of a log line, in the order of the ESP log levels.
+enum class LogLevel
+{
+    Error = 1,
+    Warning,
+    Info,
+    Debug,
+    Verbose
+};
+
+/// @brief The source of a log line.
+enum class LogCategory
+{
+    App, // Traces of the application
+    Esp, // Logs of ESP-IDF and the Arduino core
+    COUNT
+};
+
+/// @brief The lines of the log that a subscriber is interested in.
+struct LogFilter
+{
+    /// @brief The most detailed level that passes the filter.
+    LogLevel maxLevel;
+    /// @brief The categories that pass the filter, a bit for each category.
+    uint8_t categories;
+
+    /// @brief Constructor for LogFilter, by default every line passes the filter.
+    LogFilter() : maxLevel(LogLevel::Verbose), categories((1 << static_cast<int>(LogCategory::COUNT)) - 1) {}
+    /// @brief Parses a filter from the segments of a path, e.g. "W", "WARN/ESP" or "APP".
+    /// Each segment is either a level (E, W, I, D, V or the full name) or a category (APP, ESP or ALL), in any order.
+    /// @param spec The filter. An empty filter passes every line.
+    /// @return false if a segment is not a level or a category.
+    bool parse(const String &spec);
+    /// @brief Checks whether a line passes the filter.
+    bool matches(LogLevel level, LogCategory category) const
+    {
+        return level <= maxLevel && (categories & (1 << static_cast<int>(category))) != 0;
+    }
+};
+
+/// @brief Tails the trace pipeline to subscribers, e.g. HTTP clients that watch the log live.
+/// The traces are split into lines, every line is classified by its level and category, and the lines that pass
+/// the filter of a subscriber are queued in its buffer as SSE events, until the subscriber takes them.
+/// The buffers are bounded, a subscriber that falls behind loses lines and is told how many it lost.
+/// @note The methods are thread safe. publish is called with the trace lock held, so the owner of a subscriber
+/// must not trace while it holds the lock of the stream, and the stream never traces.
+class LogStream
+{
+public:
+    LogStream();
+
+    /// @brief Adds a trace to the stream.
+    /// @param message The trace. It may hold several lines or a part of a line.
+    void publish(const char *message);
+    /// @brief Adds a subscriber. The subscriber is sent the lines that are published from now on.
+    /// @param filter The lines that the subscriber is interested in.
+    /// @return The subscriber, or -1 if there are already LOG_STREAM_MAX_SUBSCRIBERS subscribers.
+    int subscribe(const LogFilter &filter);
+    /// @brief Removes a subscriber and drops the lines it did not take.
+    /// @param subscriber The subscriber.
+    void unsubscribe(int subscriber);
+    /// @brief Copies the queued events of a subscriber, without removing them.
+    /// @param subscriber The subscriber.
+    /// @param buff The buffer to copy the events into.
+    /// @param size The size of buff.
+    /// @return The number of bytes that were copied.
+    size_t peek(int subscriber, char *buff, size_t size);
+    /// @brief Removes the first bytes of the queued events of a subscriber, once they were sent.
+    /// @param subscriber The subscriber.
+    /// @param size The number of bytes to remove.
+    void consume(int subscriber, size_t size);
+    /// @brief Classifies a log line by its prefix.
+    /// Lines of ESP-IDF start with the letter of the level, e.g. "W (1234) wifi: ...", and lines of the Arduino core
+    /// carry the letter after the time, e.g. "[  1234][E][WiFiClient.cpp:42] ...". The traces of the application
+    /// have no level, they are taken as info.
+    /// @param line The line, without the color escape sequences.
+    /// @param level Returns the level of the line.
+    /// @param category Returns the category of the line.
+    static void classify(const char *line, LogLevel &level, LogCategory &category);
+
+private:
+    /// @brief A subscriber and the events that are queued for it.
+    struct Subscriber
+    {
+        bool active;
+        LogFilter filter;
+        /// @brief A ring of the queued bytes, head is the offset of the first one.
+        char buff[LOG_STREAM_BUFF_SIZE];
+        size_t head;
+        size_t count;
+        /// @brief The number of lines that were dropped since the subscriber was last told.
+        uint32_t dropped;
+    };
+
+    /// @brief Queues the line that was gathered to the subscribers that it passes their filter.
+    void dispatchLine();
+    /// @brief Queues an event to a subscriber, if it has room for all of it.
+    /// @return false if there is no room for the event.
+    bool queue(Subscriber &subscriber, const char *event, size_t size);
+    /// @brief Queues a line as an event to a subscriber, after telling it about the lines it lost.
+    void queueLine(Subscriber &subscriber);
+
+private:
+    Subscriber subscribers[LOG_STREAM_MAX_SUBSCRIBERS];
+    /// @brief The number of active subscribers.
+    int nSubscribers;
+    /// @brief The current line, as it is gathered from the traces.
+    char line[LOG_STREAM_LINE_SIZE];
+    size_t lineLen;
+    /// @brief true while a color escape sequence is skipped.
+    bool inEscape;
+    /// @brief Serializes the access to the subscribers.
+    CriticalSection cs;
+};
+
+/// Global instance of the LogStream, that the traces are published to.
+extern LogStream logStream;
+
+#endif // LogStream_h
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef LogStreamController_h
+#define LogStreamController_h
+
+#include <Arduino.h>
+#include <HttpController.h>
+#include <LogStream.h>
+#include <Lock.h>
+
+#ifndef LOG_STREAM_SEND_INTERVAL
+/// @brief The interval, in milliseconds, of the task that sends the queued lines of the log to the clients.
+#define LOG_STREAM_SEND_INTERVAL 100
+#endif
+#ifndef LOG_STREAM_HEARTBEAT_INTERVAL
+/// @brief The time, in milliseconds, after which a client that was not sent any line is sent a comment,
+/// so the stream of a client that is gone fails and its socket is released.
+#define LOG_STREAM_HEARTBEAT_INTERVAL 1000
+#endif
+
+/// @brief This controller streams the log live to browsers, as Server-Sent Events.
+/// The lines are taken from the trace pipeline as they are traced, so the log file on the SD card is not read.
+/// The filter of the stream is given in the path, e.g. /API/LOGS/STREAM/W streams the warnings and the errors,
+/// and /API/LOGS/STREAM/D/ESP streams the logs of ESP-IDF and the Arduino core up to the debug level.
+class LogStreamController : public HttpController
+{
+public:
+    LogStreamController();
+
+    /// @brief Handles GET requests, opens a stream of the log.
+    /// @param context The HTTP client context.
+    /// @param id The filter of the stream, see LogFilter::parse.
+    /// @return True if the request was handled successfully, false if the filter is not valid.
+    bool Get(HttpClientContext &context, const String id);
+    // The log stream is read only, so the other methods are not handled.
+    bool Post(HttpClientContext &context, const String id) { return false; }
+    bool Put(HttpClientContext &context, const String id) { return false; }
+    bool Delete(HttpClientContext &context, const String id) { return false; }
+    /// @brief Starts the task that sends the lines of the log to the clients.
+    /// @note This method should be called once at the start of the program.
+    void Init();
+    /// @brief Closes the stream that has been open for the longest time.
+    /// The socket budget calls this method to make room for other sockets.
+    /// @return True if a stream was closed, false if there is no stream.
+    bool EvictOldestStream();
+    /// @brief Gets the age of the stream that has been open for the longest time.
+    /// @param age Returns the time, in milliseconds, since the stream was opened.
+    /// @return True if there is a stream.
+    bool GetOldestStreamAge(unsigned long &age);
+    /// @brief Gets the instance of the LogStreamController.
+    /// @return A pointer to the LogStreamController instance.
+    static std::shared_ptr<HttpController> getInstance();
+
+private:
+    /// @brief A client that tails the log.
+    struct StreamClient
+    {
+        EthClient client;
+        /// @brief The subscriber of the client in the log stream, or -1 if the slot is free.
+        int subscriber;
+        /// @brief The time, in milliseconds, when the client was last sent data.
+        unsigned long lastSentTime;
+        /// @brief The time, in milliseconds, when the stream was opened.
+        unsigned long openedTime;
+    };
+
+    /// @brief Sends the queued lines to a client, as much as it has room for.
+    /// @param streamClient The client.
+    /// @return false if the stream of the client failed and it should be closed.
+    bool SendLines(StreamClient &streamClient);
+    /// @brief Sends the queued lines to all the clients, and closes the streams that failed.
+    void SendToClients();
+    /// @brief Closes the stream of a client and frees its slot.
+    /// @param streamClient The client.
+    void CloseStream(StreamClient &streamClient);
+    /// @brief Finds the stream that has been open for the longest time.
+    /// @return The index of the client of the stream, or -1 if there is no stream.
+    /// @note csClients must be held by the caller.
+    int FindOldestStream();
+
+private:
+    /// @brief The clients, a slot for each subscriber of the log stream.
+    StreamClient clients[LOG_STREAM_MAX_SUBSCRIBERS];
+    /// @brief Serializes the access to the clients.
+    CriticalSection csClients;
+};
+
+/// Global instance of the LogStreamController.
+extern LogStreamController &logStreamController;
+
+#endif // LogStreamController_h
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MetricsController_h
+#define MetricsController_h
+
+#include <HttpController.h>
+#include <HttpMetrics.h>
+
+/// @brief This class exposes the latency and throughput metrics of the HTTP server as JSON.
+/// GET returns the metrics of every route, DELETE clears them.
+/// This controller is a singleton, meaning only one instance of it will exist in the system.
+class MetricsController : public HttpController
+{
+public:
+    MetricsController()
+    {
+    }
+
+    bool Get(HttpClientContext &context, const String id);
+    bool Post(HttpClientContext &context, const String id);
+    bool Put(HttpClientContext &context, const String id);
+    bool Delete(HttpClientContext &context, const String id);
+    static std::shared_ptr<HttpController> getInstance();
+
+private:
+    /// @brief Appends a latency histogram to a JSON string.
+    /// @param json The JSON string.
+    /// @param name The name of the histogram.
+    /// @param histogram The histogram.
+    static void appendHistogram(String &json, const char *name, const HttpMetrics::Histogram &histogram);
+};
+
+#endif // MetricsController_h
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef MultipartParser_h
+#define MultipartParser_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef MULTIPART_MAX_LINE_LENGTH
+/// @brief The maximum length of the delimiter line and of the header lines of a part. Longer header lines are truncated.
+#define MULTIPART_MAX_LINE_LENGTH 256
+#endif
+/// @brief The maximum length of a boundary, according to RFC 2046
+#define MULTIPART_MAX_BOUNDARY_LENGTH 70
+
+/// @brief A streaming parser of a multipart/form-data request body that carries a file upload.
+/// The body is fed to the parser in chunks of any size, as it is received. The content of the file is passed on
+/// as it is parsed, without holding more than a line of the body in memory.
+/// The parser handles the first part of the body that carries a file, the rest of the body is ignored.
+class MultipartParser
+{
+public:
+    /// @brief Called when the headers of the file part are parsed, before the content of the file.
+    /// @param fileName The name of the uploaded file.
+    /// @param context The context that was given to the parser.
+    /// @return true to continue parsing, false to fail.
+    typedef bool (*FileStartHandler)(const char *fileName, void *context);
+    /// @brief Called with the next part of the content of the file.
+    /// @param data The data.
+    /// @param size The size of the data.
+    /// @param context The context that was given to the parser.
+    /// @return true to continue parsing, false to fail.
+    typedef bool (*FileDataHandler)(const uint8_t *data, size_t size, void *context);
+
+    /// @brief Constructs a new MultipartParser.
+    /// @param boundary The boundary parameter of the "Content-Type" header of the request. If it is NULL or empty,
+    /// the boundary is taken from the first line of the body.
+    /// @param onFileStart Called when the headers of the file part are parsed.
+    /// @param onFileData Called with the content of the file.
+    /// @param context Passed to the handlers.
+    MultipartParser(const char *boundary, FileStartHandler onFileStart, FileDataHandler onFileData, void *context);
+
+    /// @brief Parses the next chunk of the body.
+    /// @param data The chunk.
+    /// @param size The size of the chunk.
+    /// @return false if the body is malformed, or if a handler failed, true otherwise.
+    bool parse(const uint8_t *data, size_t size);
+    /// @brief Indicates whether the entire file was parsed, up to the delimiter that follows it.
+    bool isDone() const { return state == State::DONE; }
+    /// @brief Indicates whether parsing failed.
+    bool hasFailed() const { return state == State::FAILED; }
+    /// @brief Returns the name of the uploaded file, or an empty string if the headers of the file part were not parsed yet.
+    const char *getFileName() const { return fileName; }
+
+    /// @brief Extracts the boundary parameter from the value of a "Content-Type" header.
+    /// @param contentType The value of the header, e.g. "multipart/form-data; boundary=----WebKitFormBoundary".
+    /// @param boundary Filled with the boundary, or with an empty string if there is none.
+    /// @param size The size of boundary.
+    static void getBoundary(const char *contentType, char *boundary, size_t size);
+
+private:
+    enum class State
+    {
+        DELIMITER, // Parsing the first delimiter line, when the boundary is not known in advance
+        DELIMITER_LINE, // Parsing the rest of the line of a delimiter that ended a part
+        HEADERS, // Parsing the header lines of a part
+        CONTENT, // Parsing the content of a part
+        DONE, // The file was parsed
+        FAILED // Parsing failed
+    };
+
+    bool parseLine(const uint8_t *data, size_t size, size_t &i);
+    bool onLine();
+    bool parseContent(const uint8_t *data, size_t size, size_t &i);
+    bool emit(const uint8_t *data, size_t size);
+
+private:
+    FileStartHandler onFileStart;
+    FileDataHandler onFileData;
+    void *context;
+    State state;
+    /// @brief The delimiter that ends the content of a part, "\r\n--" followed by the boundary
+    char delimiter[MULTIPART_MAX_BOUNDARY_LENGTH + 5];
+    size_t delimiterLength;
+    /// @brief The number of bytes of the delimiter that were matched so far
+    size_t matched;
+    /// @brief The line that is being parsed
+    char line[MULTIPART_MAX_LINE_LENGTH + 1];
+    size_t lineLength;
+    /// @brief Indicates whether the part that is being parsed carries the file
+    bool filePart;
+    char fileName[MULTIPART_MAX_LINE_LENGTH + 1];
+};
+
+#endif // MultipartParser_h
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PathTrie_h
+#define PathTrie_h
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/// @brief A case-insensitive prefix trie of URL paths.
+/// @tparam T The type of the values associated with the paths.
+/// Paths are inserted once at initialization. After that, looking up a path is done in a single
+/// pass over the looked up string, without any memory allocation.
+/// @note The trie is not thread-safe for insertions. All paths should be inserted before the trie is
+/// looked up concurrently. Lookups may run concurrently.
+template<typename T>
+class PathTrie
+{
+private:
+    /// @brief A node in the trie.
+    /// The children of a node are kept in a singly linked list of siblings.
+    /// Nodes refer to each other by their index in the nodes vector.
+    class TrieNode
+    {
+    public:
+        /// @brief Constructs a new TrieNode.
+        /// @param c The (upper case) character that leads to this node from its parent.
+        TrieNode(char c) :
+            c(c),
+            firstChild(NONE),
+            nextSibling(NONE),
+            hasValue(false),
+            value()
+        {
+        }
+
+    public:
+        char c;
+        int16_t firstChild;
+        int16_t nextSibling;
+        bool hasValue;
+        T value;
+    };
+
+public:
+    /// @brief Constructs a new, empty, PathTrie.
+    PathTrie()
+    {
+        // The root node represents the empty path
+        nodes.push_back(TrieNode('\0'));
+    }
+
+    /// @brief Inserts a path into the trie.
+    /// @param path The path to insert. Case is ignored.
+    /// @param value The value to associate with the path. If the path already exists, its value is replaced.
+    void Insert(const char *path, const T &value)
+    {
+        int16_t node = ROOT;
+        for (const char *p = path; *p != '\0'; p++)
+        {
+            char c = toupper(static_cast<unsigned char>(*p));
+            int16_t child = FindChild(node, c);
+            if (child == NONE)
+            {
+                // Add a new child at the head of the children list
+                child = static_cast<int16_t>(nodes.size());
+                nodes.push_back(TrieNode(c));
+                nodes[child].nextSibling = nodes[node].firstChild;
+                nodes[node].firstChild = child;
+            }
+            node = child;
+        }
+        nodes[node].hasValue = true;
+        nodes[node].value = value;
+    }
+
+    /// @brief Finds the longest path in the trie that matches the beginning of the given string.
+    /// @param str The string to look up. Case is ignored.
+    /// @param value Set to the value associated with the matched path.
+    /// @param length Set to the length of the matched path.
+    /// @return True if a match was found, false otherwise.
+    /// @note A path matches only on a segment boundary, that is, the character in str that follows the
+    /// matched path must be either the end of str or a '/'. A path that ends with a '/' (like the root "/")
+    /// matches only when it is equal to str.
+    /// For example: "/settings" matches "/SETTINGS" and "/SETTINGS/3", but it does not match "/SETTINGS3".
+    bool Find(const char *str, T &value, size_t &length) const
+    {
+        bool found = false;
+        int16_t node = ROOT;
+        for (size_t i = 0; node != NONE; i++)
+        {
+            char c = str[i];
+            const TrieNode &trieNode = nodes[node];
+            if (trieNode.hasValue && (c == '\0' || (c == '/' && trieNode.c != '/')))
+            {
+                // Remember the match, longer matches may follow.
+                found = true;
+                value = trieNode.value;
+                length = i;
+            }
+            if (c == '\0')
+                break;
+            node = FindChild(node, toupper(static_cast<unsigned char>(c)));
+        }
+
+        return found;
+    }
+
+private:
+    /// @brief Finds the child of a node that is reached by a character.
+    /// @param node The index of the parent node.
+    /// @param c The upper case character.
+    /// @return The index of the child node, or NONE if there is no such child.
+    int16_t FindChild(int16_t node, char c) const
+    {
+        for (int16_t child = nodes[node].firstChild; child != NONE; child = nodes[child].nextSibling)
+            if (nodes[child].c == c)
+                return child;
+
+        return NONE;
+    }
+
+private:
+    static const int16_t NONE = -1;
+    static const int16_t ROOT = 0;
+    std::vector<TrieNode> nodes;
+};
+
+#endif // PathTrie_h
@@ -22,17 +22,56 @@
 #include <Arduino.h>
 #include <HttpController.h>
 #include <RecoveryControl.h>
+#include <SSEStateModel.h>
+#include <SSEEventRing.h>
+#include <IdHashTable.h>
+#include <Lock.h>
+
+#ifndef SSE_MAX_CLIENTS
+/// @brief The number of clients that the SSEController keeps, streams and IDs that were given to browsers. A power of 2.
+#define SSE_MAX_CLIENTS 16
+#endif
+#ifndef SSE_BROADCAST_INTERVAL
+/// @brief The time, in milliseconds, after which the broadcaster task goes on sending events to clients
+/// that did not have room for them, even if there is no new event.
+#define SSE_BROADCAST_INTERVAL 50
+#endif
+#ifndef SSE_HEARTBEAT_INTERVAL
+/// @brief The time, in milliseconds, after which a client that was not sent anything is sent a comment as a heartbeat.
+/// The heartbeat makes the stream of a client that is gone fail, so its socket is released.
+#define SSE_HEARTBEAT_INTERVAL 1000
+#endif
+#ifndef SSE_REAP_INTERVAL
+/// @brief The interval, in milliseconds, of the background task that deletes the IDs that were given to browsers
+/// that did not connect their stream. Streams that fail are deleted right away by the broadcaster task.
+#define SSE_REAP_INTERVAL 5000
+#endif
+#ifndef SSE_DISCONNECT_LAGGARDS
+/// @brief What to do with a client that falls behind more than SSE_EVENT_RING_SIZE events.
+/// If 0, the events that the client missed are dropped and the client is sent a snapshot of the state instead.
+/// If 1, the stream of the client is closed.
+#define SSE_DISCONNECT_LAGGARDS 0
+#endif
 
 /// @brief This class contains information about clients connected to the SSEController. 
+/// The clients are kept in the slots of a table that is allocated once, so the information is held in fixed buffers,
+/// and inserting, copying and deleting a client does not allocate memory.
 struct ClientInfo
 {
 public:
     /// @brief Constructor for the ClientInfo class.
     /// @param _id The unique identifier for the client.
     /// @param _client The EthClient object associated with the client.
-    ClientInfo(const String &_id, EthClient &_client) :
+    ClientInfo(uint32_t _id, EthClient &_client) :
         id(_id),
-        client(_client)
+        client(_client),
+        streaming(true),
+        needsSnapshot(true),
+        sentSeq(0),
+        pendingLength(0),
+        pendingOffset(0),
+        lastSentTime(millis()),
+        createdTime(millis())
     {
     }
 
@@ -41,40 +80,59 @@ public:
     /// then a clientInfo will be added to the class. This instance in the list of clients is required so that SSEController will identify the ID as valid
     /// ID.
     /// @param _id The unique identifier for the client.
-    ClientInfo(const String &_id) :
-        id(_id)
-    {
-    }
-
-    /// @brief Copy constructor for the ClientInfo class.
-    /// @param clientInfo The ClientInfo object to copy.
-    ClientInfo(const ClientInfo &clientInfo)
+    ClientInfo(uint32_t _id) :
+        id(_id),
+        streaming(false),
+        needsSnapshot(false),
+        sentSeq(0),
+        pendingLength(0),
+        pendingOffset(0),
+        lastSentTime(0),
+        createdTime(millis())
     {
-        *this = clientInfo;
     }
 
-    /// @brief Assignment operator for the ClientInfo class.
-    /// @param clientInfo The ClientInfo object to copy.
-    /// @return A reference to this object. 
-    ClientInfo &operator=(const ClientInfo &clientInfo)
+    /// @brief Constructor for the ClientInfo class (overloaded). This constructor is used for the empty slots of the table of clients.
+    ClientInfo() :
+        id(0),
+        streaming(false),
+        needsSnapshot(false),
+        sentSeq(0),
+        pendingLength(0),
+        pendingOffset(0),
+        lastSentTime(0),
+        createdTime(0)
     {
-        *const_cast<String *>(&id) = clientInfo.id;
-        client = clientInfo.client;
-        return *this;
     }
 
-    /// @brief Equality operator for the ClientInfo class.
-    /// @param c The ClientInfo object to compare.
-    /// @return True if the objects are equal, false otherwise.
-    bool operator==(const ClientInfo &c) const
+    /// @brief Makes an event the one that is being sent to the client.
+    /// @param event The event. Events are made in buffers of SSE_EVENT_BUFF_SIZE, so the event fits.
+    void setPending(const char *event)
     {
-        return id == c.id;
+        pendingLength = std::min(strlen(event), sizeof(pending));
+        memcpy(pending, event, pendingLength);
+        pendingOffset = 0;
     }
 
-    /// @brief the unique identifier for the client.
-    const String id;
+    /// @brief the unique identifier for the client, the key of the client in the table of clients.
+    uint32_t id;
     /// @brief the EthClient object associated with the client.
     EthClient client;
+    /// @brief true if the client holds an SSE stream, false if it only holds the ID.
+    bool streaming;
+    // The progress of the stream. Only the broadcaster task updates it, on a copy of the client that is stored back in the table.
+    /// @brief true if the client should be sent a snapshot of the state before any other event.
+    bool needsSnapshot;
+    /// @brief The sequence number of the last event that the client was sent.
+    uint32_t sentSeq;
+    /// @brief The event that is being sent to the client, its length and the part of it that was already sent.
+    char pending[SSE_EVENT_BUFF_SIZE];
+    size_t pendingLength;
+    size_t pendingOffset;
+    /// @brief The time, in milliseconds, when the client was last sent data.
+    unsigned long lastSentTime;
+    /// @brief The time, in milliseconds, when the client was added.
+    unsigned long createdTime;
 };
 
 #undef ON_RECOVERY_STATE_CHANGED
@@ -91,7 +149,10 @@ public:
 class SSEController : public HttpController
 {
 public:
-    SSEController()
+    SSEController() :
+        notifiedSeq(0),
+        broadcasterTask(NULL),
+        bootId(0)
     {
     }
 
@@ -126,7 +187,7 @@ public:
     /// @param stopClient If true, the client will be stopped before deletion.
     /// @return True if the client was deleted successfully, false otherwise.
     bool DeleteClient(EthClient &client, bool stopClient);
-    /// @brief Checks if the given ID is valid. That is if it exists in the list of clients.
+    /// @brief Checks if the given ID is valid. That is if it exists in the table of clients.
     /// @param id The ID to check.
     /// @return True if the ID is valid, false otherwise.
     bool IsValidId(const String &id);
@@ -134,6 +195,15 @@ public:
     /// so that when the index page is called with that ID it will be recognized as a valid ID.
     /// @param id The unique identifier for the client.
     void AddClient(const String &id);
+    /// @brief Closes the stream of the client that has been connected for the longest time.
+    /// The socket budget calls this method to make room for other sockets.
+    /// @return True if a stream was closed, false if there is no stream.
+    bool EvictOldestClient();
+    /// @brief Gets the age of the stream of the client that has been connected for the longest time.
+    /// The socket budget compares it with the streams of the log, to close the oldest stream of all.
+    /// @param age Returns the time, in milliseconds, since the stream was opened.
+    /// @return True if there is a stream.
+    bool GetOldestClientAge(unsigned long &age);
     /// @brief Gets the instance of the SSEController.
     /// @return A pointer to the SSEController instance.
     static std::shared_ptr<HttpController> getInstance();
@@ -156,43 +226,79 @@ private:
     /// @param context The context for the HTTP client.
     ON_ROUTER_POWER_STATE_CHANGED(OnRouterPowerStateChanged);
     /// @brief Notifies the state of a client.
-    /// @param id The unique identifier for the client. If empty, the state will be notified to all clients.
-    /// @note This method is used to send updates to the clients about the current state of the controller.
+    /// @param id The unique identifier for the client. If empty, the fields of the state that changed since the last
+    /// notification are sent to all clients. Otherwise, the client with that ID has just connected, and it is sent
+    /// a snapshot of the whole state, or the events that it missed if it resumes its stream.
+    /// @note The events are queued for the broadcaster task, which sends them to the clients, so this method does not
+    /// wait for the clients. It is safe to call it from the observers of the recovery state.
     void NotifyState(const String &id);
+    /// @brief Sends the queued events to all the clients, as much as each client has room for.
+    /// This method is called by the broadcaster task. The clients are written to out of the lock of the table of clients.
+    void Broadcast();
+    /// @brief Sends the queued events to a client, as much as it has room for.
+    /// A client that was not sent anything for SSE_HEARTBEAT_INTERVAL is sent a heartbeat.
+    /// @param clientInfo A copy of the client, its progress is updated as the events are sent.
+    /// @return false if the stream of the client failed, or the client fell behind, and it should be deleted.
+    bool SendEvents(ClientInfo &clientInfo);
+    /// @brief Writes the ID line of an event.
+    /// @param seq The sequence number of the event.
+    /// @param buff The buffer to write the line into.
+    /// @param size The size of buff.
+    /// @return The length of the line.
+    size_t WriteEventId(uint32_t seq, char *buff, size_t size) const;
+    /// @brief Checks whether a stream can be resumed after the last event that the client received.
+    /// @param lastEventId The ID of the last event that the client received, from the Last-Event-ID header.
+    /// @param seq Returns the sequence number of that event.
+    /// @return true if the events that follow that event are still in the ring.
+    bool GetResumeSeq(const String &lastEventId, uint32_t &seq);
     /// @brief Updates the last recovery time in the state.
     void UpdateStateLastRecoveryTime();
     /// @brief Deletes a client from the controller.
-    /// @param clientInfo The information of the client to delete.
+    /// @param id The numeric ID of the client to delete.
     /// @param stopClient If true, the client will be stopped before deletion.
-    void DeleteClient(const ClientInfo &clientInfo, bool stopClient);
+    /// @return True if the client was deleted, false if there is no client with that ID.
+    bool DeleteClient(uint32_t id, bool stopClient);
+    /// @brief Adds a client to the table of clients, replacing the client with the same ID.
+    /// If the table is full, the oldest client that only holds an ID is deleted to make room.
+    /// @param id The numeric ID of the client.
+    /// @param clientInfo The client.
+    /// @return True if the client was added, false if there is no room for it.
+    bool InsertClient(uint32_t id, const ClientInfo &clientInfo);
+    /// @brief Finds the oldest client that matches a condition.
+    /// @param streaming true to find the oldest stream, false to find the oldest client that only holds an ID.
+    /// @param id Returns the numeric ID of the client.
+    /// @param age Returns the time, in milliseconds, since the client was added.
+    /// @return True if a client was found.
+    bool FindOldestClient(bool streaming, uint32_t &id, unsigned long &age);
+    /// @brief Deletes the oldest client that matches a condition.
+    /// @param streaming true to delete the oldest stream, false to delete the oldest client that only holds an ID.
+    /// @return True if a client was deleted.
+    bool DeleteOldestClient(bool streaming);
     /// @brief Deletes unused clients from the controller.
-    /// This method scans the list of clients and deletes those that are no longer active or have been disconnected.
+    /// This method scans the table of clients and deletes those that are no longer active or have been disconnected.
     /// @note This method is typically called periodically to clean up the list of clients. 
     void DeleteUnusedClients();
 
 private:
-    /// @brief A linked list to store the clients connected to the SSEController.
-    typedef LinkedList<ClientInfo> ClientsList;
-    ClientsList clients;
-
-    /// @brief The state of the SSEController.
-    /// This state contains information about the current recovery type, modem state, router state, etc.
-    class SSEControllerState
-    {
-    public:
-        bool autoRecovery; // true if auto-recovery is enabled, false otherwise
-        RecoveryTypes recoveryType; // the current recovery type
-        PowerState modemState; // the current power state of the modem
-        PowerState routerState; // the current power state of the router
-        bool showLastRecovery; // true if the last recovery time should be shown, false otherwise
-        int days; // the number of days since the last recovery
-        int hours; // the number of hours since the last recovery
-        int minutes; // the number of minutes since the last recovery
-        int seconds; // the number of seconds since the last recovery
-    };
+    /// @brief The clients connected to the SSEController, by their numeric IDs.
+    typedef IdHashTable<ClientInfo, SSE_MAX_CLIENTS> ClientsTable;
+    ClientsTable clients;
 
     /// @brief The current state of the SSEController.
-    SSEControllerState state;
+    /// This state contains information about the current recovery type, modem state, router state, etc.
+    SSEStateModel state;
+    /// @brief The sequence number of the state that was last sent to all the clients.
+    uint32_t notifiedSeq;
+    /// @brief The recent changes of the state, that the broadcaster task sends to the clients.
+    SSEEventRing events;
+    /// @brief Serializes the updates of the state and the taking of the events by the clients, so the clients get the changes in order.
+    /// It is not held while the events are written to the clients.
+    CriticalSection csState;
+    /// @brief The task that sends the events to the clients.
+    TaskHandle_t broadcasterTask;
+    /// @brief A random number that is part of the IDs of the events, so a client does not resume
+    /// its stream with the ID of an event from before the last restart.
+    uint32_t bootId;
 };
 
 /// Global instance of the SSEController.
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#ifndef SSEEventRing_h
+#define SSEEventRing_h
+
+#include <Arduino.h>
+
+#ifndef SSE_EVENT_RING_SIZE
+/// @brief The number of recent events that are kept for the SSE clients that did not receive them yet.
+/// A client that falls further behind than that is a laggard.
+#define SSE_EVENT_RING_SIZE 8
+#endif
+
+/// @brief A ring of the recent events that were broadcast to the SSE clients.
+/// Events are identified by consecutive sequence numbers, every client keeps the sequence number
+/// of the last event it received and takes the following events from the ring at its own pace.
+/// @note The ring is not thread safe, the owner must serialize the access to it.
+class SSEEventRing
+{
+public:
+    SSEEventRing();
+
+    /// @brief Adds an event to the ring, replacing the oldest event if the ring is full.
+    /// @param seq The sequence number of the event. If it does not follow the last event, the ring starts over with this event.
+    /// @param event The event.
+    void push(uint32_t seq, const char *event);
+    /// @brief Returns the event with a given sequence number.
+    /// @param seq The sequence number.
+    /// @return The event, or NULL if it is not in the ring.
+    const String *get(uint32_t seq) const;
+    /// @brief Returns the sequence number of the oldest event in the ring.
+    uint32_t getFirstSeq() const { return firstSeq; }
+    /// @brief Returns the sequence number of the last event in the ring, or getFirstSeq() - 1 if the ring is empty.
+    uint32_t getLastSeq() const { return nextSeq - 1; }
+
+private:
+    /// @brief The events, the event with sequence number seq is at seq % SSE_EVENT_RING_SIZE.
+    String events[SSE_EVENT_RING_SIZE];
+    /// @brief The sequence number of the oldest event in the ring.
+    uint32_t firstSeq;
+    /// @brief The sequence number of the next event.
+    uint32_t nextSeq;
+};
+
+#endif // SSEEventRing_h
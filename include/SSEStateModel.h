@@ -0,0 +1,95 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#ifndef SSEStateModel_h
+#define SSEStateModel_h
+
+#include <Arduino.h>
+
+/// @brief The size of the buffer that an event of the state is written into.
+/// It is large enough for a snapshot of all the fields of the state.
+#define SSE_EVENT_BUFF_SIZE 512
+
+/// @brief The fields of the state that is streamed to the SSE clients.
+enum class SSEStateField
+{
+    AutoRecovery,
+    ModemState,
+    RouterState,
+    RecoveryType,
+    ShowLastRecovery,
+    Days,
+    Hours,
+    Minutes,
+    Seconds,
+    RDisco,
+    MDisco,
+    RPeriodic,
+    MPeriodic,
+    COUNT
+};
+
+/// @brief A versioned model of the state that is streamed to the SSE clients.
+/// Every field remembers the sequence number of the change that last modified it,
+/// so an event may carry only the fields that changed since a given sequence number.
+/// @note The model is not thread safe, the owner must serialize the access to it.
+class SSEStateModel
+{
+public:
+    SSEStateModel();
+
+    /// @brief Sets the value of a field. The change is part of the next sequence number, once it is committed.
+    /// @param field The field.
+    /// @param value The new value. Boolean fields take 0 or 1.
+    /// @return true if the value of the field changed.
+    bool set(SSEStateField field, int value);
+    /// @brief Returns the value of a field.
+    int get(SSEStateField field) const { return values[static_cast<int>(field)]; }
+    /// @brief Commits the changes that were set since the last commit under a new sequence number.
+    /// @return true if there were changes to commit.
+    bool commit();
+    /// @brief Returns the sequence number of the last committed change.
+    uint32_t getSeq() const { return seq; }
+    /// @brief Writes an event with all the fields of the state.
+    /// The client replaces its copy of the state with the snapshot.
+    /// @param buff The buffer to write the event into.
+    /// @param size The size of buff, at least SSE_EVENT_BUFF_SIZE.
+    /// @return The length of the event.
+    size_t writeSnapshot(char *buff, size_t size) const;
+    /// @brief Writes an event with only the fields that changed since a given sequence number.
+    /// The client merges the delta into its copy of the state.
+    /// @param since The sequence number that the client is known to be up to date with.
+    /// @param buff The buffer to write the event into.
+    /// @param size The size of buff, at least SSE_EVENT_BUFF_SIZE.
+    /// @return The length of the event, or 0 if no field changed since the sequence number.
+    size_t writeDelta(uint32_t since, char *buff, size_t size) const;
+
+private:
+    size_t writeEvent(bool snapshot, uint32_t since, char *buff, size_t size) const;
+
+private:
+    /// @brief The values of the fields.
+    int values[static_cast<int>(SSEStateField::COUNT)];
+    /// @brief The sequence number of the change that last modified each field.
+    uint32_t versions[static_cast<int>(SSEStateField::COUNT)];
+    /// @brief The sequence number of the last committed change.
+    uint32_t seq;
+    /// @brief true if there are changes that were not committed yet.
+    bool dirty;
+};
+
+#endif // SSEStateModel_h
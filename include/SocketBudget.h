@@ -0,0 +1,182 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#ifndef SocketBudget_h
+#define SocketBudget_h
+
+#include <Arduino.h>
+#include <Lock.h>
+#include <EthernetUtil.h>
+
+#ifndef SOCKET_BUDGET_SOCKETS
+#ifndef USE_WIFI
+/// @brief The number of hardware sockets of the Ethernet controller.
+#define SOCKET_BUDGET_SOCKETS MAX_SOCK_NUM
+#else
+/// @brief The number of sockets of the network stack.
+#define SOCKET_BUDGET_SOCKETS CONFIG_LWIP_MAX_SOCKETS
+#endif
+#endif
+#ifndef SOCKET_BUDGET_SYSTEM_RESERVE
+/// @brief The number of sockets that are reserved for the probes and the name and time queries of the system.
+/// Client connections of the HTTP server are not admitted into these sockets.
+#define SOCKET_BUDGET_SYSTEM_RESERVE 2
+#endif
+#ifndef SOCKET_BUDGET_MAX_SSE
+/// @brief The maximum number of sockets that SSE streams may hold, the streams of the state and of the log together.
+/// When another stream is opened, the oldest one is closed.
+#define SOCKET_BUDGET_MAX_SSE 2
+#endif
+#ifndef SOCKET_BUDGET_MAX_SSE_EVICTORS
+/// @brief The maximum number of owners of SSE streams that can close their streams, e.g. the state events and the log stream.
+#define SOCKET_BUDGET_MAX_SSE_EVICTORS 2
+#endif
+#ifndef SOCKET_BUDGET_EVICTION_TIMEOUT
+/// @brief The time, in milliseconds, that the system waits for an idle persistent connection to be closed,
+/// before it closes the oldest SSE stream to make room for a probe or a query.
+#define SOCKET_BUDGET_EVICTION_TIMEOUT 200
+#endif
+/// @brief The number of sockets that client connections of the HTTP server may hold.
+/// One socket is always held by the HTTP server for listening.
+#define SOCKET_BUDGET_HTTP_SOCKETS (SOCKET_BUDGET_SOCKETS - SOCKET_BUDGET_SYSTEM_RESERVE - 1)
+
+/// @brief The classes of the users of the sockets.
+enum class SocketClass
+{
+    PROBE, // ICMP echo of the connectivity checks
+    NAME, // DNS and NTP queries
+    API, // Connections of the HTTP server that request /API/...
+    STATIC, // Connections of the HTTP server that request views and files
+    SSE, // Connections of the HTTP server that were handed over to SSE streams
+    COUNT
+};
+
+/// @brief Keeps the budget of the sockets, so client connections cannot starve the probes and the queries of the system.
+/// The network library allocates the sockets by itself, so the budget does not hand out sockets, it accounts for the sockets
+/// that each class holds. The HTTP server admits a connection only when it fits the budget, and when the system needs a socket
+/// that is not free, idle persistent connections and then the oldest SSE stream are closed to make room for it.
+class SocketBudget
+{
+public:
+    /// @brief The statistics of a class of sockets
+    typedef struct
+    {
+        uint16_t inUse; // Number of sockets that the class holds
+        uint16_t peak; // The largest number of sockets that the class held at once
+        uint32_t acquired; // Number of sockets that were acquired by the class
+        uint32_t denied; // Number of sockets that were denied to the class
+    } ClassStats;
+
+    /// @brief The statistics of the budget
+    typedef struct
+    {
+        ClassStats classes[static_cast<int>(SocketClass::COUNT)];
+        uint32_t idleEvictions; // Number of idle persistent connections that were closed to make room for other sockets
+        uint32_t sseEvictions; // Number of SSE streams that were closed to make room for other sockets
+        int freeSockets; // Number of free hardware sockets, or -1 if it is not known
+    } Stats;
+
+    /// @brief Closes the oldest SSE stream of an owner of streams, to make room for another socket.
+    /// @param context The context that was passed to addSSEEvictor.
+    /// @return true if a stream was closed.
+    typedef bool (*SSEEvictor)(void *context);
+    /// @brief Returns the age of the oldest SSE stream of an owner of streams.
+    /// @param context The context that was passed to addSSEEvictor.
+    /// @param age Returns the time, in milliseconds, since the oldest stream was opened.
+    /// @return true if the owner has a stream.
+    typedef bool (*SSEOldestAge)(void *context, unsigned long &age);
+
+    /// @brief Acquires a socket for a class.
+    /// For a connection of the HTTP server, the socket is already allocated. It is acquired only if the connection fits the budget,
+    /// otherwise an idle persistent connection is asked to close, so the next connection may fit.
+    /// For the system classes, the socket is always acquired. If no hardware socket is free, room is made for it first.
+    /// @param cls The class.
+    /// @return true if the socket was acquired, for the system classes true if a hardware socket is free.
+    static bool acquire(SocketClass cls);
+    /// @brief Releases a socket of a class.
+    /// @param cls The class.
+    static void release(SocketClass cls);
+    /// @brief Moves a socket from one class to another, e.g. when a connection of the HTTP server turns into an SSE stream.
+    /// When the SSE streams exceed their budget, the oldest stream is closed.
+    /// @param from The class that holds the socket.
+    /// @param to The new class of the socket.
+    static void reclassify(SocketClass from, SocketClass to);
+    /// @brief Returns the class of a connection of the HTTP server by the resource that it requests.
+    /// @param resource The requested resource.
+    static SocketClass classify(const String &resource);
+    /// @brief Called by idle persistent connections of the HTTP server to check whether one of them should be closed.
+    /// @return true if the connection should be closed.
+    static bool takeIdleEviction();
+    /// @brief Adds an owner of SSE streams, so its streams are closed to make room for other sockets.
+    /// The streams of all the owners share the SSE budget, and the oldest stream among all the owners is closed first.
+    /// @param evictor The function that closes the oldest stream of the owner.
+    /// @param oldestAge The function that returns the age of the oldest stream of the owner.
+    /// @param context A context that is passed to the functions.
+    static void addSSEEvictor(SSEEvictor evictor, SSEOldestAge oldestAge, void *context);
+    /// @brief Returns the number of free hardware sockets, or -1 if it is not known.
+    static int getFreeSockets();
+    /// @brief Gets the statistics of the budget.
+    /// @param stats Filled with the statistics.
+    static void getStats(Stats &stats);
+    /// @brief Returns the name of a class.
+    static const char *getClassName(SocketClass cls);
+
+    /// @brief Holds a socket of a system class for the lifetime of the lease.
+    class Lease
+    {
+    public:
+        /// @brief Acquires a socket for a class.
+        /// @param cls The class.
+        Lease(SocketClass cls) : cls(cls) { available = acquire(cls); }
+        /// @brief Releases the socket.
+        ~Lease() { release(cls); }
+        /// @brief Returns true if a hardware socket was free when the lease was taken.
+        operator bool() const { return available; }
+
+    private:
+        SocketClass cls;
+        bool available;
+    };
+
+private:
+    /// @brief Makes room for a socket of a system class. Idle persistent connections are asked to close first,
+    /// and if none does within SOCKET_BUDGET_EVICTION_TIMEOUT, the oldest SSE stream is closed.
+    /// @return true if a hardware socket is free.
+    static bool makeRoom();
+    /// @brief Closes the oldest SSE stream among all the owners of streams.
+    /// @return true if a stream was closed.
+    static bool evictSSE();
+    /// @brief Returns the statistics of a class.
+    static ClassStats &getClassStats(SocketClass cls) { return stats.classes[static_cast<int>(cls)]; }
+
+private:
+    static CriticalSection cs;
+    static Stats stats;
+    /// @brief The number of idle persistent connections that are asked to close
+    static int pendingIdleEvictions;
+    /// @brief An owner of SSE streams
+    typedef struct
+    {
+        SSEEvictor evictor;
+        SSEOldestAge oldestAge;
+        void *context;
+    } SSEOwner;
+    static SSEOwner sseOwners[SOCKET_BUDGET_MAX_SSE_EVICTORS];
+    static int nSSEOwners;
+};
+
+#endif // SocketBudget_h
@@ -43,6 +43,15 @@ public:
         if (id.equals("info"))
             // Send system version information as a JSON response.
             return sendVersionInfo(context);
+        else if (id.equals("cache"))
+            // Send the file cache statistics as a JSON response.
+            return sendCacheInfo(context);
+        else if (id.equals("server"))
+            // Send the connections admission statistics as a JSON response.
+            return sendServerInfo(context);
+        else if (id.equals("sockets"))
+            // Send the socket budget statistics as a JSON response.
+            return sendSocketsInfo(context);
         else if (id.equals("update"))
             // Handle system firmware update requests.
             return updateVersion(context);
@@ -95,6 +104,18 @@ private:
     /// @param context The HTTP client context.
     /// @return True if the response was sent successfully, false otherwise.
     static bool sendVersionInfo(HttpClientContext &context);
+    /// @brief Sends the file cache statistics to the client.
+    /// @param context The HTTP client context.
+    /// @return True if the response was sent successfully, false otherwise.
+    static bool sendCacheInfo(HttpClientContext &context);
+    /// @brief Sends the admission statistics of the client connections of the HTTP server to the client.
+    /// @param context The HTTP client context.
+    /// @return True if the response was sent successfully, false otherwise.
+    static bool sendServerInfo(HttpClientContext &context);
+    /// @brief Sends the statistics of the socket budget to the client.
+    /// @param context The HTTP client context.
+    /// @return True if the response was sent successfully, false otherwise.
+    static bool sendSocketsInfo(HttpClientContext &context);
     /// @brief Updates the system firmware.
     /// @param context The HTTP client context.
     /// @return True if the update was initiated successfully, false otherwise.
@@ -69,11 +69,11 @@ public:
 
 protected:
     /// @brief This method is called to redirect the client to a different resource, if necessary.
-    /// @param client The EthClient instance representing the client connection.
+    /// @param context The context of the HTTP client that made the request.
     /// @param id An optional identifier for the resource being redirected to.
     /// @return True if the redirection is required, false otherwise. 
     /// @note If redirection is required, the method should send a redirect response to the client.
-    virtual bool redirect(EthClient &client, const String &id) { return false; }
+    virtual bool redirect(HttpClientContext &context, const String &id) { return false; }
 
 protected:
     std::unique_ptr<ViewReader> viewReader;
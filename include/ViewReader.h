@@ -22,6 +22,8 @@
 #include <Arduino.h>
 #include <HttpHeaders.h>
 
+class HttpClientContext;
+
 class ViewReader {
 public:
     virtual ~ViewReader() {}
@@ -40,6 +42,19 @@ public:
     /// @note The last modified time is in the format "YYYY-MM-DD HH:MM:SS". This format
     /// is used in the HTTP headers to indicate the last modified time of the file.
     virtual bool getLastModifiedTime(String &lastModifiedTimeStr) = 0;
+    /// @brief Gets the entity tag of the view
+    /// @param etag A string to fill with the entity tag of the view, including the quotes
+    /// @return true if the view has an entity tag, false otherwise
+    /// @note The entity tag identifies the content of the view. It is sent in the ETag header of the HTTP response
+    /// and is compared with the If-None-Match header of later requests. A view whose content is generated has no entity tag.
+    virtual bool getETag(String &etag) { return false; }
+    /// @brief Gets the cached validators of the view, without opening it
+    /// @param etag A string to fill with the entity tag of the view
+    /// @param lastModifiedTimeStr A string to fill with the last modified time of the view
+    /// @return true if the validators of the view are cached, false otherwise
+    /// @note This function is called before the view reader is opened, so a conditional request may be
+    /// answered without reading the view.
+    virtual bool getCachedValidators(String &etag, String &lastModifiedTimeStr) { return false; }
     /// @brief Gets the content type of the file
     /// @return The content type of the file
     /// @note The content type is used in the HTTP headers to indicate the type of the file.
@@ -48,6 +63,8 @@ public:
     virtual CONTENT_TYPE getContentType() = 0;
     /// @brief The size of the view in bytes
     /// @return This is required to send the correct Content-Length header in the HTTP response.
+    /// A view that is generated while it is read may return -1, when its size is not known in advance.
+    /// Such a view is sent with the chunked transfer encoding, and it is read until read() returns -1.
     virtual long getViewSize() = 0;
     /// @brief Reads data from the view into the buffer beginning at offset 0
     /// @note This function reads data from the view and fills the buffer with the data. If the view is larger than the buffer,
@@ -60,10 +77,29 @@ public:
     /// it will read only the first buffSize bytes. Next call to read() will continue reading from the view from where it left off.
     /// @return The number of bytes read from the view, or -1 if there was an error, or there is no more data.
     virtual int read(int offset) = 0;
+#ifndef TESTING
+    /// @brief Sends the next part of the view directly to the client, without passing it through the buffer of the reader.
+    /// @param context The context of the request to send the view in. The view reader accounts for what it sends in the context.
+    /// @param size The number of bytes to send.
+    /// @return The number of bytes sent, or -1 if the view reader does not send directly. The view is then read with read().
+    virtual long send(HttpClientContext &context, long size) { return -1; }
+#endif
+    /// @brief Indicates whether the view reader can read a gzip encoded variant of the view.
+    /// @return true if the view reader supports gzip encoding, false otherwise.
+    /// @note When this function returns true, the response varies according to the "Accept-Encoding" header of the request.
+    virtual bool supportsGzip() { return false; }
+    /// @brief Indicates whether the opened view is gzip encoded.
+    /// @return true if the view is gzip encoded, false otherwise.
+    virtual bool isGzipEncoded() { return false; }
+    /// @brief Sets whether the client accepts a gzip encoded view.
+    /// @param accepted true if the client accepts gzip encoding, false otherwise.
+    /// @note This function should be called before the view reader is opened.
+    void setGzipAccepted(bool accepted) { gzipAccepted = accepted; }
 
 protected:
     byte *buff;
     int buffSize;
+    bool gzipAccepted = false;
 };
 
 #endif // ViewReader_h
\ No newline at end of file
@@ -53,6 +53,13 @@ public:
 
   uint16_t getRXReceivedSize(SOCKET s);
 
+  /**
+   * @brief Returns the free size of the Tx buffer of a socket.
+   *
+   * The register is read until two consecutive reads agree, because it may change while it is read.
+   */
+  uint16_t getTXFreeSize(SOCKET s);
+
 private:
   static const uint16_t RMASK = 0x07FF; // Rx buffer MASK
   static const uint16_t RSIZE = 2048; // Max Rx buffer size
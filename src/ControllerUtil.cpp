@@ -17,6 +17,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <SSEController.h>
+#include <LogStreamController.h>
 #include <RecoveryController.h>
 #include <HistoryControl.h>
 #include <ManualControl.h>
@@ -27,6 +28,7 @@ void InitControllers()
     historyControl.init();
     recoveryControl.Init();
     sseController.Init();
+    logStreamController.Init();
 }
 
 void PerformControllersCycles()
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <DoubleBufferedFileWriter.h>
+#ifdef DEBUG_HTTP_SERVER
+#include <Trace.h>
+#endif
+
+DoubleBufferedFileWriter::DoubleBufferedFileWriter(SdFile &file) :
+    file(file),
+    buffers{NULL, NULL},
+    fullBlocks(NULL),
+    freeBlocks(NULL),
+    taskEnded(NULL),
+    taskRunning(false),
+    current{NULL, 0},
+    failed(false)
+{
+}
+
+DoubleBufferedFileWriter::~DoubleBufferedFileWriter()
+{
+    end();
+    if (fullBlocks != NULL)
+        vQueueDelete(fullBlocks);
+    if (freeBlocks != NULL)
+        vQueueDelete(freeBlocks);
+    if (taskEnded != NULL)
+        vSemaphoreDelete(taskEnded);
+    free(buffers[0]);
+    free(buffers[1]);
+}
+
+void DoubleBufferedFileWriter::begin()
+{
+    buffers[0] = static_cast<byte *>(malloc(FILE_WRITER_BUFF_SIZE));
+    buffers[1] = static_cast<byte *>(malloc(FILE_WRITER_BUFF_SIZE));
+    fullBlocks = xQueueCreate(2, sizeof(Block));
+    freeBlocks = xQueueCreate(2, sizeof(Block));
+    taskEnded = xSemaphoreCreateBinary();
+    if (buffers[0] == NULL || buffers[1] == NULL || fullBlocks == NULL || freeBlocks == NULL || taskEnded == NULL)
+    {
+#ifdef DEBUG_HTTP_SERVER
+        Traceln("Not enough memory for the file writer buffers, writing directly to the file");
+#endif
+        return;
+    }
+
+    for (byte *buffer : buffers)
+    {
+        Block block = {buffer, 0};
+        xQueueSend(freeBlocks, &block, 0);
+    }
+
+    // The task runs at the priority of the caller, so neither of them starves the other
+    taskRunning = xTaskCreate(WriterTask, "FileWriter", FILE_WRITER_STACK_SIZE, this, uxTaskPriorityGet(NULL), NULL) == pdPASS;
+#ifdef DEBUG_HTTP_SERVER
+    if (!taskRunning)
+        Traceln("Failed to create the file writer task, writing directly to the file");
+#endif
+}
+
+void DoubleBufferedFileWriter::WriterTask(void *param)
+{
+    DoubleBufferedFileWriter *writer = static_cast<DoubleBufferedFileWriter *>(param);
+    Block block;
+
+    while (xQueueReceive(writer->fullBlocks, &block, portMAX_DELAY) == pdPASS && block.size > 0)
+    {
+        // After a failure the rest of the data is dropped, but the buffers keep circulating
+        if (!writer->failed && writer->file.write(block.data, block.size) != block.size)
+        {
+#ifdef DEBUG_HTTP_SERVER
+            Tracef("Failed to write %lu bytes to the file\n", block.size);
+#endif
+            writer->failed = true;
+        }
+        block.size = 0;
+        xQueueSend(writer->freeBlocks, &block, portMAX_DELAY);
+    }
+
+    xSemaphoreGive(writer->taskEnded);
+    vTaskDelete(NULL);
+}
+
+void DoubleBufferedFileWriter::handOver()
+{
+    xQueueSend(fullBlocks, &current, portMAX_DELAY);
+    current = {NULL, 0};
+}
+
+bool DoubleBufferedFileWriter::write(const byte *data, size_t size)
+{
+    if (failed)
+        return false;
+
+    if (!taskRunning)
+    {
+        failed = file.write(data, size) != size;
+        return !failed;
+    }
+
+    while (size > 0)
+    {
+        // Wait for the writing task to release a buffer
+        if (current.data == NULL)
+            xQueueReceive(freeBlocks, &current, portMAX_DELAY);
+
+        size_t len = min<size_t>(size, FILE_WRITER_BUFF_SIZE - current.size);
+        memcpy(current.data + current.size, data, len);
+        current.size += len;
+        data += len;
+        size -= len;
+        if (current.size == FILE_WRITER_BUFF_SIZE)
+            handOver();
+    }
+
+    return !failed;
+}
+
+bool DoubleBufferedFileWriter::end()
+{
+    if (!taskRunning)
+        return !failed;
+
+    if (current.data != NULL && current.size > 0)
+        handOver();
+    // Let the task know that there is no more data, and wait for it to write the rest of the data
+    Block last = {NULL, 0};
+    xQueueSend(fullBlocks, &last, portMAX_DELAY);
+    xSemaphoreTake(taskEnded, portMAX_DELAY);
+    taskRunning = false;
+
+    return !failed;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <EmbeddedAssets.h>
+#include <strings.h>
+
+const EmbeddedAsset *EmbeddedAssets::find(const char *path)
+{
+    // Binary search the manifest
+    size_t low = 0;
+    size_t high = nAssets;
+    while (low < high)
+    {
+        size_t mid = (low + high) / 2;
+        int cmp = strcasecmp(path, assets[mid].path);
+        if (cmp == 0)
+            return &assets[mid];
+        if (cmp < 0)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
+    return NULL;
+}
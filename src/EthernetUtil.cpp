@@ -30,6 +30,7 @@
 #endif
 #else
 #include <Dns.h>
+#include <SocketBudget.h>
 #endif
 #ifdef DEBUG_ETHERNET
 #include <Trace.h>
@@ -410,6 +411,18 @@ bool IsZeroIPAddress(const IPAddress &ip)
   return ip == IPAddress(0, 0, 0, 0);
 }
 
+size_t GetRoomForWrite(EthClient &client, size_t size)
+{
+#ifndef USE_WIFI
+  // The free space in the Tx buffer of the socket
+  int room = client.availableForWrite();
+  return room > 0 ? min<size_t>(room, size) : 0;
+#else
+  // The WiFi client does not report the free space of its send buffer, lwIP buffers the data instead.
+  return size;
+#endif
+}
+
 bool InitEthernet()
 {
   // start the Ethernet connection:
@@ -706,6 +719,8 @@ bool TryGetHostAddress(IPAddress &address, String server)
 	error = WiFi.hostByName(server.c_str(), address);
 #else
   // Try to resolve the server name using DNS
+  // Make sure there is a socket for the query. The lease is taken before the bus is locked, since making room may close other sockets.
+  SocketBudget::Lease lease(SocketClass::NAME);
 	DNSClient dns;
   {
     Lock lock(csSpi);
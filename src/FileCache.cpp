@@ -0,0 +1,190 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <FileCache.h>
+#ifdef DEBUG_HTTP_SERVER
+#include <Trace.h>
+#endif
+
+FileCache::LruList FileCache::lru;
+FileCache::EntriesMap FileCache::entries;
+std::set<String> FileCache::missing;
+size_t FileCache::bytes = 0;
+uint32_t FileCache::hits = 0;
+uint32_t FileCache::misses = 0;
+uint32_t FileCache::evictions = 0;
+uint32_t FileCache::generation = 0;
+CriticalSection FileCache::cs;
+
+String FileCache::key(const String &path)
+{
+    // File names on the SD card are case insensitive
+    String key = path;
+    key.toUpperCase();
+    return key;
+}
+
+FileCache::EntryPtr FileCache::get(const String &filePath, bool countMiss)
+{
+    Lock lock(cs);
+
+    EntriesMap::iterator i = entries.find(key(filePath));
+    if (i == entries.end())
+    {
+        if (countMiss)
+            misses++;
+        return EntryPtr();
+    }
+
+    // Make the file the most recently used one
+    lru.splice(lru.begin(), lru, i->second);
+    hits++;
+    return *i->second;
+}
+
+void FileCache::evict(size_t size)
+{
+    // Drop the least recently used files until there is room for size more bytes
+    while (!lru.empty() && bytes + size > FILE_CACHE_SIZE)
+    {
+        const EntryPtr &entry = lru.back();
+#ifdef DEBUG_HTTP_SERVER
+        Tracef("Evicting %s from the file cache\n", entry->path.c_str());
+#endif
+        bytes -= entry->size;
+        entries.erase(key(entry->path));
+        lru.pop_back();
+        evictions++;
+    }
+}
+
+FileCache::EntryPtr FileCache::load(const String &filePath, SdFile &file)
+{
+    size_t size = file.size();
+    if (size == 0 || size > FILE_CACHE_MAX_FILE_SIZE || size > FILE_CACHE_SIZE)
+        return EntryPtr();
+
+    // Read the file outside of the lock, so other files can be served from the cache meanwhile
+    uint32_t loadGeneration;
+    {
+        Lock lock(cs);
+        loadGeneration = generation;
+    }
+    std::shared_ptr<Entry> entry = std::make_shared<Entry>(filePath, size, file.getLastWrite());
+    if (entry->data == NULL)
+        return EntryPtr();
+    for (size_t offset = 0; offset < size;)
+    {
+        size_t nBytes = file.read(entry->data + offset, size - offset);
+        if (nBytes == 0 || nBytes > size - offset)
+            return EntryPtr();
+        offset += nBytes;
+    }
+
+    Lock lock(cs);
+
+    // If files were invalidated while this file was read, it may have been changed.
+    // It is sent to the client as read, but it is not cached.
+    if (loadGeneration != generation)
+        return entry;
+
+    // Another request may have loaded the same file meanwhile
+    String entryKey = key(filePath);
+    EntriesMap::iterator i = entries.find(entryKey);
+    if (i != entries.end())
+    {
+        bytes -= (*i->second)->size;
+        lru.erase(i->second);
+        entries.erase(i);
+    }
+
+    evict(size);
+    lru.push_front(entry);
+    entries[entryKey] = lru.begin();
+    bytes += size;
+#ifdef DEBUG_HTTP_SERVER
+    Tracef("Cached %s, %lu bytes, %lu bytes in the file cache\n", filePath.c_str(), size, bytes);
+#endif
+
+    return entry;
+}
+
+bool FileCache::isMissing(const String &filePath)
+{
+    Lock lock(cs);
+
+    return missing.find(key(filePath)) != missing.end();
+}
+
+bool FileCache::exists(const String &filePath)
+{
+    uint32_t checkGeneration;
+    {
+        Lock lock(cs);
+        if (missing.find(key(filePath)) != missing.end())
+            return false;
+        checkGeneration = generation;
+    }
+
+    if (SD.exists(filePath))
+        return true;
+
+    // The file may have been written while it was checked, then it is not remembered as missing
+    Lock lock(cs);
+    if (checkGeneration == generation)
+    {
+        // Every path that a client asks for may be missing, so the memory they take is bound
+        if (missing.size() >= FILE_CACHE_MAX_MISSING)
+            missing.clear();
+        missing.insert(key(filePath));
+    }
+    return false;
+}
+
+void FileCache::invalidate(const String &path)
+{
+    Lock lock(cs);
+
+    // Drop the file itself, its compressed copy, and the files under it if it is a directory
+    generation++;
+    String prefix = key(path);
+    for (EntriesMap::iterator i = entries.lower_bound(prefix); i != entries.end() && i->first.startsWith(prefix);)
+    {
+#ifdef DEBUG_HTTP_SERVER
+        Tracef("Dropping %s from the file cache\n", i->first.c_str());
+#endif
+        bytes -= (*i->second)->size;
+        lru.erase(i->second);
+        i = entries.erase(i);
+    }
+    // The file may exist now
+    for (std::set<String>::iterator i = missing.lower_bound(prefix); i != missing.end() && i->startsWith(prefix);)
+        i = missing.erase(i);
+}
+
+void FileCache::getStats(Stats &stats)
+{
+    Lock lock(cs);
+
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.entries = entries.size();
+    stats.bytes = bytes;
+    stats.missing = missing.size();
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <FileSender.h>
+#include <Common.h>
+#ifndef USE_WIFI
+#include <w5100ex.h>
+#endif
+#ifdef DEBUG_HTTP_SERVER
+#include <Trace.h>
+#endif
+
+size_t FileSender::send(HttpClientContext &context, const byte *data, size_t size)
+{
+    size_t sent = 0;
+    // A single write to the client sends at most the size of the Tx buffer of the socket
+    while (sent < size && !context.isExpired())
+    {
+        size_t len = context.write(data + sent, min<size_t>(FILE_SENDER_CHUNK_SIZE, size - sent));
+        if (len == 0)
+            break;
+        sent += len;
+    }
+
+    return sent;
+}
+
+#ifdef USE_WIFI
+
+size_t FileSender::send(HttpClientContext &context, SdFile &file, size_t size)
+{
+    byte *buff = static_cast<byte *>(malloc(FILE_SENDER_CHUNK_SIZE));
+    if (buff == NULL)
+        return 0;
+
+    size_t sent = 0;
+    while (sent < size && !context.isExpired())
+    {
+        size_t len = file.read(buff, min<size_t>(FILE_SENDER_CHUNK_SIZE, size - sent));
+        if (len == 0 || len > FILE_SENDER_CHUNK_SIZE)
+            // The file could not be read
+            break;
+        if (context.write(buff, len) != len)
+            break;
+        context.getClient().flush();
+        sent += len;
+    }
+
+    free(buff);
+    return sent;
+}
+
+#else
+
+bool FileSender::waitForSendDone(HttpClientContext &context, SOCKET s)
+{
+    unsigned long t0 = millis();
+    bool done = false;
+    while (true)
+    {
+        {
+            Lock lock(csSpi);
+            uint8_t ir = W5100Ex.readSnIR(s);
+            if (ir & SnIR::SEND_OK)
+            {
+                W5100Ex.writeSnIR(s, SnIR::SEND_OK);
+                done = true;
+                break;
+            }
+            if ((ir & SnIR::TIMEOUT) || W5100Ex.readSnSR(s) == SnSR::CLOSED)
+                break;
+        }
+        if (context.isExpired(millis() - t0))
+            break;
+        delay(1);
+    }
+    // The time the client takes to acknowledge the data counts against the deadline of the request
+    context.onWaited(millis() - t0);
+
+    return done;
+}
+
+size_t FileSender::sendChunk(HttpClientContext &context, SOCKET s, const byte *data, size_t size)
+{
+    unsigned long t0 = millis();
+    size_t len = 0;
+    while (true)
+    {
+        {
+            // The bus is held once for copying the chunk to the Tx buffer and sending it
+            Lock lock(csSpi);
+            uint8_t status = W5100Ex.readSnSR(s);
+            if (status != SnSR::ESTABLISHED && status != SnSR::CLOSE_WAIT)
+                break;
+            size_t freeSize = W5100Ex.getTXFreeSize(s);
+            if (freeSize >= min<size_t>(size, FILE_SENDER_MIN_CHUNK_SIZE))
+            {
+                len = min<size_t>(freeSize, size);
+                W5100Ex.send_data_processing(s, data, len);
+                W5100Ex.execCmdSn(s, Sock_SEND);
+                break;
+            }
+        }
+        // Wait for the client to acknowledge the data that was sent so far
+        if (context.isExpired(millis() - t0))
+            break;
+        delay(1);
+    }
+    context.onWaited(millis() - t0);
+    if (len > 0)
+        context.onResponseSent(len);
+
+    return len;
+}
+
+size_t FileSender::send(HttpClientContext &context, SdFile &file, size_t size)
+{
+    byte *buff = static_cast<byte *>(malloc(FILE_SENDER_CHUNK_SIZE));
+    if (buff == NULL)
+        return 0;
+
+    SOCKET s = context.getClient().getSocketNumber();
+    size_t sent = 0;
+    size_t read = 0;
+    // The part of the buffer that was read from the file and not sent yet
+    size_t pending = 0;
+    size_t pendingLen = 0;
+    bool sending = false;
+    while (sent < size)
+    {
+        // The buffer is copied to the Tx buffer of the socket before the SEND command is issued,
+        // so the next chunk is read from the SD card while the W5500 transmits the previous one.
+        if (pending == pendingLen)
+        {
+            size_t expected = min<size_t>(FILE_SENDER_CHUNK_SIZE, size - read);
+            size_t len = file.read(buff, expected);
+            if (len == 0 || len > expected)
+                // The file could not be read
+                break;
+            read += len;
+            pending = 0;
+            pendingLen = len;
+        }
+        // A SEND command may be issued only after the previous one is done
+        if (sending && !waitForSendDone(context, s))
+        {
+            sending = false;
+            break;
+        }
+        size_t len = sendChunk(context, s, buff + pending, pendingLen - pending);
+        sending = len > 0;
+        if (len == 0)
+            break;
+        pending += len;
+        sent += len;
+    }
+    // Leave the socket ready for the next write of the client
+    if (sending)
+        waitForSendDone(context, s);
+
+#ifdef DEBUG_HTTP_SERVER
+    if (sent < size)
+        Tracef("%d Sent %lu bytes of %lu\n", context.getRemotePort(), sent, size);
+#endif
+    free(buff);
+    return sent;
+}
+
+#endif // USE_WIFI
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <FileValidatorsCache.h>
+#ifdef DEBUG_HTTP_SERVER
+#include <Trace.h>
+#endif
+
+FileValidatorsCache::ValidatorsMap FileValidatorsCache::validatorsMap;
+CriticalSection FileValidatorsCache::cs;
+
+String FileValidatorsCache::key(const String &path)
+{
+    // File names on the SD card are case insensitive
+    String key = path;
+    key.toUpperCase();
+    return key;
+}
+
+bool FileValidatorsCache::get(const String &filePath, Validators &validators)
+{
+    Lock lock(cs);
+
+    ValidatorsMap::const_iterator i = validatorsMap.find(key(filePath));
+    if (i == validatorsMap.end())
+        return false;
+
+    validators = i->second;
+    return true;
+}
+
+void FileValidatorsCache::put(const String &filePath, const Validators &validators)
+{
+    Lock lock(cs);
+
+    if (validatorsMap.size() >= FILE_VALIDATORS_CACHE_SIZE)
+        // The cache is full, make room for the new file
+        validatorsMap.erase(validatorsMap.begin());
+    validatorsMap[key(filePath)] = validators;
+}
+
+void FileValidatorsCache::invalidate(const String &path)
+{
+    Lock lock(cs);
+
+    // Drop the file itself, its compressed copy, and the files under it if it is a directory
+    String prefix = key(path);
+    for (ValidatorsMap::iterator i = validatorsMap.lower_bound(prefix); i != validatorsMap.end() && i->first.startsWith(prefix);)
+    {
+#ifdef DEBUG_HTTP_SERVER
+        Tracef("Invalidating validators of %s\n", i->first.c_str());
+#endif
+        i = validatorsMap.erase(i);
+    }
+}
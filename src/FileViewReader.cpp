@@ -17,19 +17,75 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <map>
+#include <algorithm>
 #include <FileViewReader.h>
+#ifndef TESTING
+#include <FileSender.h>
+#endif
 #ifdef DEBUG_HTTP_SERVER
 #include <Trace.h>
 #endif
 
+const EmbeddedAsset *FileViewReader::findEmbeddedAsset()
+{
+    const EmbeddedAsset *asset = EmbeddedAssets::find(viewFilePath.c_str());
+    // A compressed asset can be sent only to a client that accepts gzip encoding.
+    // Other clients get the file from the SD card.
+    if (asset != NULL && asset->gzipped && !gzipAccepted)
+        return NULL;
+
+    return asset;
+}
+
+bool FileViewReader::openMem(byte *buff, int buffSize, const byte *data, size_t size)
+{
+    memData = data;
+    memSize = size;
+    memOffset = 0;
+    return ViewReader::open(buff, buffSize);
+}
+
 bool FileViewReader::open(byte *buff, int buffSize)
 {
+    // Files that are embedded in the firmware are read from flash, without accessing the SD card at all.
+    embeddedAsset = findEmbeddedAsset();
+    if (embeddedAsset != NULL)
+    {
+        gzipEncoded = embeddedAsset->gzipped;
+        return openMem(buff, buffSize, embeddedAsset->data, embeddedAsset->size);
+    }
+
+    String fileName;
+    fileName = "/wwwroot" + viewFilePath;
+    String gzFileName = fileName + ".GZ";
+
+    // Look for the file in the file cache first. If it is there, there is no need to access the SD card.
+    // If the client accepts gzip encoding, prefer the compressed copy of the file. The cached plain copy is sent
+    // to such a client only once the compressed copy is known not to exist, otherwise it is looked for on the SD card.
+    gzipEncoded = gzipAccepted && (cachedFile = FileCache::get(gzFileName, false));
+    bool plainLookedUp = !gzipEncoded && (!gzipAccepted || FileCache::isMissing(gzFileName));
+    if (plainLookedUp)
+        cachedFile = FileCache::get(fileName);
+    if (cachedFile)
+        return openMem(buff, buffSize, cachedFile->data, cachedFile->size);
+
     // Ensure SD card is mounted
     AutoSD autoSD;
     // Open the file on the SD card for reading
-    String fileName;
-    fileName = "/wwwroot" + viewFilePath;
-    SdFile file = SD.open(fileName, FILE_READ);
+    SdFile file;
+    // If the client accepts gzip encoding, prefer the compressed copy of the file, if there is one.
+    if (gzipAccepted && !plainLookedUp && FileCache::exists(gzFileName))
+    {
+        file = SD.open(gzFileName, FILE_READ);
+        gzipEncoded = static_cast<bool>(file);
+    }
+    if (!gzipEncoded)
+    {
+        // There is no compressed copy, the plain copy may be cached after all.
+        if (!plainLookedUp && (cachedFile = FileCache::get(fileName)))
+            return openMem(buff, buffSize, cachedFile->data, cachedFile->size);
+        file = SD.open(fileName, FILE_READ);
+    }
 #ifdef DEBUG_HTTP_SERVER
     if (!file)
 	{
@@ -39,6 +95,19 @@ bool FileViewReader::open(byte *buff, int buffSize)
     }
 #endif
 
+    if (file)
+    {
+        // Small files are loaded into the file cache, and served from memory from now on.
+        cachedFile = FileCache::load(gzipEncoded ? gzFileName : fileName, file);
+        if (cachedFile)
+        {
+            file.close();
+            return openMem(buff, buffSize, cachedFile->data, cachedFile->size);
+        }
+        // The file could not be cached, so read it from the beginning.
+        file.seek(0);
+    }
+
     // Open the reader by giving it the file object
     return open(buff, buffSize, file);
 }
@@ -63,6 +132,10 @@ bool FileViewReader::open(byte *buff, int buffSize, SdFile file)
 
 void FileViewReader::close()
 {
+    // Release the cached file, it is freed if it was evicted from the cache meanwhile
+    cachedFile.reset();
+    embeddedAsset = NULL;
+    memData = NULL;
     if (file)
     {
         // Close the file
@@ -74,18 +147,100 @@ void FileViewReader::close()
 
 int FileViewReader::read(int offset)
 {
-    return file.read(buff + offset, buffSize - offset);
+    if (memData == NULL)
+        return file.read(buff + offset, buffSize - offset);
+
+    // Copy the next part of the file from memory
+    int nBytes = std::min(static_cast<size_t>(buffSize - offset), memSize - memOffset);
+    if (nBytes == 0)
+        return -1;
+    memcpy(buff + offset, memData + memOffset, nBytes);
+    memOffset += nBytes;
+    return nBytes;
+}
+
+#ifndef TESTING
+long FileViewReader::send(HttpClientContext &context, long size)
+{
+    if (memData == NULL)
+        return FileSender::send(context, file, size);
+
+    size_t nBytes = FileSender::send(context, memData + memOffset, std::min(static_cast<size_t>(size), memSize - memOffset));
+    memOffset += nBytes;
+    return nBytes;
 }
+#endif
 
 long FileViewReader::getViewSize()
 {
-    return file.size();
+    return memData != NULL ? memSize : file.size();
+}
+
+/// @brief FNV-1a 32 bit hash parameters
+#define FNV_OFFSET_BASIS 2166136261U
+#define FNV_PRIME 16777619U
+
+/// @brief Adds data to an FNV-1a hash.
+/// @param hash The hash of the data that precedes this data.
+/// @param data The data to hash.
+/// @param size The size of the data.
+/// @return The updated hash.
+static uint32_t fnv1a(uint32_t hash, const byte *data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    return hash;
+}
+
+bool FileViewReader::getValidators(FileValidatorsCache::Validators &validators)
+{
+    // The validators of embedded files are computed at build time
+    if (embeddedAsset != NULL)
+    {
+        validators.etag = embeddedAsset->etag;
+        validators.lastModified = embeddedAsset->lastModified;
+        return true;
+    }
+
+    if (!cachedFile && !file)
+        return false;
+
+    String filePath = cachedFile ? cachedFile->path : String(file.path());
+    if (FileValidatorsCache::get(filePath, validators))
+        return true;
+
+    // Hash the content of the file. This is done before the view is read, so the view buffer is free to be used.
+    uint32_t hash = FNV_OFFSET_BASIS;
+    if (cachedFile)
+        hash = fnv1a(hash, cachedFile->data, cachedFile->size);
+    else
+    {
+        for (size_t nBytes = file.read(buff, buffSize); nBytes > 0 && nBytes <= static_cast<size_t>(buffSize); nBytes = file.read(buff, buffSize))
+            hash = fnv1a(hash, buff, nBytes);
+        // Rewind the file for reading the view
+        if (!file.seek(0))
+            return false;
+    }
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%08x-%x\"", hash, static_cast<unsigned>(getViewSize()));
+    validators.etag = etag;
+    getLastModifiedTime(validators.lastModified);
+
+    FileValidatorsCache::put(filePath, validators);
+
+    return true;
 }
 
 bool FileViewReader::getLastModifiedTime(String &lastModifiedTimeStr)
 {
+    if (embeddedAsset != NULL)
+    {
+        lastModifiedTimeStr = embeddedAsset->lastModified;
+        return true;
+    }
+
     tm tr;
-    time_t fileTime = file.getLastWrite();
+    time_t fileTime = cachedFile ? cachedFile->lastWrite : file.getLastWrite();
     gmtime_r(&fileTime, &tr);
     char lastModifiedTime[64];
     // Last-Modified: Sun, 21 Jun 2020 14:33:06 GMT
@@ -95,6 +250,40 @@ bool FileViewReader::getLastModifiedTime(String &lastModifiedTimeStr)
     return true;
 }
 
+bool FileViewReader::getETag(String &etag)
+{
+    FileValidatorsCache::Validators validators;
+    if (!getValidators(validators))
+        return false;
+
+    etag = validators.etag;
+    return true;
+}
+
+bool FileViewReader::getCachedValidators(String &etag, String &lastModifiedTimeStr)
+{
+    const EmbeddedAsset *asset = findEmbeddedAsset();
+    if (asset != NULL)
+    {
+        etag = asset->etag;
+        lastModifiedTimeStr = asset->lastModified;
+        return true;
+    }
+
+    String fileName = "/wwwroot" + viewFilePath;
+    FileValidatorsCache::Validators validators;
+    // The compressed copy of the file is the one that is sent when the client accepts gzip encoding.
+    // The validators of the plain copy are used for such a client only if the compressed copy is known not to exist.
+    String gzFileName = fileName + ".GZ";
+    if (!(gzipAccepted && FileValidatorsCache::get(gzFileName, validators)) &&
+        !((!gzipAccepted || FileCache::isMissing(gzFileName)) && FileValidatorsCache::get(fileName, validators)))
+        return false;
+
+    etag = validators.etag;
+    lastModifiedTimeStr = validators.lastModified;
+    return true;
+}
+
 /// @brief Map file extensions to their content types
 typedef std::map<String, CONTENT_TYPE> FileTypesMap;
 static FileTypesMap fileTypesMap = 
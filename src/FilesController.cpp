@@ -22,6 +22,12 @@
 #include <SDUtil.h>
 #include <TimeUtil.h>
 #include <HttpHeaders.h>
+#include <FileValidatorsCache.h>
+#include <FileCache.h>
+#include <HttpRange.h>
+#include <MultipartParser.h>
+#include <DoubleBufferedFileWriter.h>
+#include <FileSender.h>
 #ifdef DEBUG_HTTP_SERVER
 #include <Trace.h>
 #endif
@@ -30,6 +36,11 @@
 /// These headers are sent with every response to ensure proper caching and CORS support.
 static HttpHeaders::Header commonHeaders[] = { {"Access-Control-Allow-Origin", "*" }, {"Cache-Control", "no-cache"} };
 
+#ifndef UPLOAD_RECEIVE_BUFF_SIZE
+/// @brief The size of the buffer that the body of an upload request is received into
+#define UPLOAD_RECEIVE_BUFF_SIZE 512
+#endif
+
 void FilesController::normalizePath(String &path)
 {
     path.replace("%20", " ");
@@ -40,6 +51,7 @@ void FilesController::normalizePath(String &path)
 /// @param id The ID of the file to retrieve.
 /// @return True if the request was successful, false otherwise.
 /// This method reads the specified file from the SD card and downloads it to the client.
+/// If the request has a "Range" header, only the requested range of the file is sent, so a download can be resumed.
 /// If the file does not exist, it returns false.
 bool FilesController::Get(HttpClientContext &context, const String id)
 {
@@ -61,27 +73,40 @@ bool FilesController::Get(HttpClientContext &context, const String id)
     if (!file)
         return false;
 
-    // Send the headers section with the file size and common headers.
-    HttpHeaders headers(client);
-    headers.sendHeaderSection(200, true, commonHeaders, NELEMS(commonHeaders), file.size());
-
-    byte buff[1024];
+    // Check if only a range of the file is requested.
     size_t fileSize = file.size();
-    size_t nBytes = 0;
-
-    // Pump the file content to the client in chunks.
-    // This loop reads the file in chunks of 1024 bytes until the entire file is sent.
-    // It ensures that the client receives the data in a timely manner.
-    while (nBytes < fileSize)
+    size_t first = 0;
+    size_t last = fileSize - 1;
+    HttpRange::Result range = HttpRange::parse(context.getRange().c_str(), fileSize, first, last);
+    HttpHeaders headers(context);
+    if (range == HttpRange::Result::UNSATISFIABLE || (range == HttpRange::Result::SATISFIABLE && !file.seek(first)))
     {
-        size_t len = file.read(buff, min<size_t>(sizeof(buff), fileSize - nBytes));
-        nBytes += len;
-        client.write(buff, len);
-#ifdef USE_WIFI
-        client.flush();
+#ifdef DEBUG_HTTP_SERVER
+        Tracef("Range not satisfiable: %s, file size: %lu\n", context.getRange().c_str(), fileSize);
 #endif
+        // Let the client know the actual size of the file.
+        HttpHeaders::Header rangeHeaders[] = { commonHeaders[0], commonHeaders[1], {"Content-Range", String("bytes */") + fileSize} };
+        headers.sendHeaderSection(416, true, rangeHeaders, NELEMS(rangeHeaders));
+        file.close();
+        return true;
     }
 
+    // Send the headers section with the size of the content and common headers.
+    // Clients are told that they can request ranges of the file.
+    size_t contentSize = range == HttpRange::Result::SATISFIABLE ? last - first + 1 : fileSize;
+    HttpHeaders::Header rangeHeaders[] = { commonHeaders[0], commonHeaders[1], {"Accept-Ranges", "bytes"}, {} };
+    if (range == HttpRange::Result::SATISFIABLE)
+        rangeHeaders[3] = {"Content-Range", String("bytes ") + first + "-" + last + "/" + fileSize};
+    headers.sendHeaderSection(range == HttpRange::Result::SATISFIABLE ? 206 : 200, true, rangeHeaders, NELEMS(rangeHeaders), contentSize);
+
+    // Send the file content to the client in large chunks.
+    // A client that is too slow to receive it expires the request.
+    // If the file could not be read, the client will find out that the content is incomplete,
+    // and the connection is closed since the rest of the announced content will never come.
+    size_t nBytes = FileSender::send(context, file, contentSize);
+    if (nBytes < contentSize)
+        context.closeAfterResponse();
+
 #ifndef USE_WIFI
     client.flush();
 #endif
@@ -90,37 +115,30 @@ bool FilesController::Get(HttpClientContext &context, const String id)
     return true;
 }
 
-void FilesController::parseUploadHeaders(const String &header, String &boundary, String &fileName)
+/// @brief The state of a file upload, passed to the handlers of the multipart parser.
+struct FileUpload
 {
-    // This method parses the upload headers from the HTTP request.
-    // It extracts the boundary and file name from the header line.
-    // The boundary is used to separate different parts of the multipart form data,
-    if (header.startsWith("---"))
-        boundary = header;
-    else if (header.startsWith("Content-Disposition: "))
-    {
-        // Extract the file name from the header.
-        char fileNameId[] = "; filename=";
-        fileName = header.substring(header.indexOf(fileNameId) + NELEMS(fileNameId));
-        fileName = fileName.substring(0, fileName.indexOf("\""));
-#ifdef DEBUG_HTTP_SERVER
-        Tracef("File Name=%s\n", fileName.c_str());
-#endif
-    }
-}
+    FileUpload(const String &dirPath) : dirPath(dirPath), writer(file) {}
+
+    /// @brief The directory that the file is uploaded to
+    String dirPath;
+    /// @brief The path of the uploaded file
+    String filePath;
+    SdFile file;
+    DoubleBufferedFileWriter writer;
+};
 
 /// @brief Handle POST requests for file uploads.
 /// @param context The HTTP client context.
 /// @param id The ID of the file to upload.
 /// @return True if the request was successful, false otherwise.
 /// This method uploads a file from the client and saves it to the SD card.
-/// It reads the file data from the client, writes it to the SD card, and sends a response back to the client.
+/// The multipart body is parsed as it is received, and the file data is written to the SD card while the next part is received.
 /// If the upload fails, it removes the file from the SD card and returns false.
 bool FilesController::Post(HttpClientContext &context, const String id)
 {
-    // Initialize the SD card and get the client and resource from the context.
+    // Initialize the SD card and get the resource from the context.
     AutoSD autoSD;
-    EthClient client = context.getClient();
     String resource = context.getResource();
 
     // Normalize the file path to ensure it is properly formatted.
@@ -129,118 +147,71 @@ bool FilesController::Post(HttpClientContext &context, const String id)
     Tracef("FilesController Post resource=%s, contentLength=%lu, contentType=%s\n", resource.c_str(), context.getContentLength(), context.getContentType().c_str());
 #endif
 
-    // We get here after the headers section has been read and interpreted.
-    // In case of a file upload, the message body contains at the beginning some other headers that we need to parse.
-    // The headers are separated by a blank line from the file data, so we read until we find an empty line.
-    // After that, we can read the file data.
-    String content;
-    bool endOfHeaders = false;
-    String boundary;
-    String fileName;
-    size_t nBytes = 0;
-    while (!endOfHeaders && client.available())
-    {
-        // Read a character from the client.
-        char c = client.read();
-        nBytes++;
-        switch (c)
+    // The directory path on the local SD card is set in the id parameter.
+    String dirPath = id;
+    normalizePath(dirPath);
+    // If the directory path is not empty, we prepend a slash to it.
+    if (!dirPath.equals(""))
+        dirPath = "/" + dirPath;
+
+    FileUpload upload(dirPath);
+    char boundary[MULTIPART_MAX_BOUNDARY_LENGTH + 1];
+    MultipartParser::getBoundary(context.getContentType().c_str(), boundary, sizeof(boundary));
+    MultipartParser parser(boundary,
+        [](const char *fileName, void *param)
         {
-            case '\r':
-                // Ignore carriage return characters.
-                break;
-            case '\n':
-                // If we reach a new line, check if we have reached the end of the headers.
-                if (content.equals(""))
-                    // If the content is empty, we have reached the end of the headers.
-                    endOfHeaders = true;
-                else
-                {
-                    // If we have a header line, parse it.
-                    parseUploadHeaders(content, boundary, fileName);
-                    // Reset the content for the next header line.
-                    content = "";
-                }
-                break;
-            default:
-                // Append the character to the content line.
-                content += c;
-                break;
-        }
-    }
-
-    // The file path on the local SD card is set in the id parameter.
-    String filePath = id;
-    normalizePath(filePath);
-    // If the file path is not empty, we prepend a slash to it.
-    if (!filePath.equals(""))
-        filePath = "/" + filePath;
-    // Open the file on the SD card for writing.
-    SdFile file = SD.open(filePath + "/" + fileName, FILE_WRITE);
-
-    // If the file could not be opened, return false.
-    if (!file)
-        return false;
-
-    bool failed = false;
-    size_t boundaryLen = boundary.length() + 6;
-    // The size of the file is the content length minus the number of bytes read so far.
-    size_t restOfContent = context.getContentLength() - nBytes;
-    byte buff[1024];
-    size_t buffSize = sizeof(buff);
-    // Find a buffer length that will entirely contain the boundary on the last read. 
-    // This is done because the boundary is at the end of the file, and we need to remove it.
-    // We don't want to remove it in parts, if it is not entirely contained in the buffer.
-    for(;restOfContent % buffSize <= boundaryLen; buffSize--);
+            // The headers of the file part were parsed, open the file on the SD card for writing.
+            FileUpload *upload = static_cast<FileUpload *>(param);
+            upload->filePath = upload->dirPath + "/" + fileName;
 #ifdef DEBUG_HTTP_SERVER
-    Tracef("File name: %s, File size: %lu, Boundary: %s %lu, Buff size: %lu, Reminder: %lu\n", fileName.c_str(), restOfContent - boundaryLen, boundary.c_str(), boundaryLen, buffSize, restOfContent % buffSize);
+            Tracef("File Name=%s\n", fileName);
 #endif
-    nBytes = 0;
-    // Read the file data from the client in chunks.
-    while (!failed && nBytes < restOfContent)
-    {
-        // Calculate the expected length of the next chunk.
-        size_t expected = min<size_t>(buffSize, restOfContent - nBytes);
-        size_t len = 0;
-        time_t t0 = t_now;
-        
-        // Read the next chunk from the client.
-        // This can be done in several reads, because the data may not be available if the connection is slow.
-        while(len < expected && t_now - t0 < 3)
-        {
-            size_t readRes = client.read(buff + len, buffSize - len);
-            if (readRes != 0xffffffff)
-                len += readRes;
-        }
-
-        // If the length of the read data is less than the expected length, we have a problem.
-        if (len != expected)
+            upload->file = SD.open(upload->filePath, FILE_WRITE);
+            if (!upload->file)
+                return false;
+            upload->writer.begin();
+            return true;
+        },
+        [](const uint8_t *data, size_t size, void *param)
         {
-#ifdef DEBUG_HTTP_SERVER
-            Tracef("File was not entirely received. Expected: %lu, received: %lu\n", restOfContent, nBytes);
-#endif
-            failed = true;
+            return static_cast<FileUpload *>(param)->writer.write(data, size);
+        },
+        &upload);
+
+    // Part of the body may already be received along with the request header section, so it is read through the context.
+    // The whole body is read, even after the file was parsed, so the next request on the connection is not corrupted.
+    size_t contentLength = context.getContentLength();
+    size_t received = 0;
+    // The upload goes on as long as the client keeps sending, the deadline of the request closes a client that stalls or trickles the body.
+    byte buff[UPLOAD_RECEIVE_BUFF_SIZE];
+    while (received < contentLength && !parser.hasFailed() && context.waitForData())
+    {
+        int len = context.read(buff, min<size_t>(sizeof(buff), contentLength - received));
+        if (len <= 0)
             break;
-        }
-
-        // Calculate the number of bytes written so far.
-        nBytes += len;
-        if (nBytes >= restOfContent)
-            // If we have read all the data, we need to remove the boundary from the end of the file.
-            len -= boundaryLen;
-        // Write the data to the file.
-        size_t written = file.write(buff, len);
-        if (written != len)
-        {
-            // If the number of bytes written is not equal to the number of bytes in the buffer, we have a problem.
+        received += len;
+        parser.parse(buff, len);
+    }
+
+    // If the file was never opened, there is nothing to clean up
+    if (!upload.file)
+    {
 #ifdef DEBUG_HTTP_SERVER
-            Tracef("Written %lu bytes, expected: %lu\n", written, len);
+        Traceln("File upload failed, no file was received!");
 #endif
-            failed = true;
-        }
-        file.flush();
+        return false;
     }
 
-    file.close();
+    // Wait for the rest of the file to be written. The file is flushed once, when it is closed.
+    bool failed = !upload.writer.end() || !parser.isDone();
+#ifdef DEBUG_HTTP_SERVER
+    if (!parser.isDone())
+        Tracef("File was not entirely received. Expected: %lu, received: %lu\n", contentLength, received);
+#endif
+    upload.file.close();
+    // The content of the file was replaced, its cached content and validators are no longer valid.
+    FileCache::invalidate(upload.filePath);
+    FileValidatorsCache::invalidate(upload.filePath);
 
     if (failed)
     {
@@ -248,12 +219,12 @@ bool FilesController::Post(HttpClientContext &context, const String id)
 #ifdef DEBUG_HTTP_SERVER
         Traceln("File upload failed!");
 #endif
-        SD.remove(resource + "/" + fileName);
+        SD.remove(upload.filePath);
         return false;
     }
 
     // If the upload was successful, we send an OK response back to the client.
-    HttpHeaders headers(client);
+    HttpHeaders headers(context);
     headers.sendHeaderSection(200, true, commonHeaders, NELEMS(commonHeaders));
 
     return true;
@@ -281,7 +252,7 @@ bool FilesController::Put(HttpClientContext &context, const String id)
         return false;
 
     // If the directory was created successfully, send an OK response back to the client.
-    HttpHeaders headers(context.getClient());
+    HttpHeaders headers(context);
     headers.sendHeaderSection(200, true, commonHeaders, NELEMS(commonHeaders));
 
     return true;
@@ -337,6 +308,9 @@ bool FilesController::Delete(HttpClientContext &context, const String id)
 
     // Remove  the directory or the file depending on the type.
     bool success = isDir ? SD.rmdir(path) : SD.remove(path);
+    // Drop the cached content and validators of the removed file, or of the files in the removed directory.
+    FileCache::invalidate(path);
+    FileValidatorsCache::invalidate(path);
 
     if (!success)
     {
@@ -348,7 +322,7 @@ bool FilesController::Delete(HttpClientContext &context, const String id)
     }
 
     // If the removal was successful, send an OK response back to the client.
-    HttpHeaders headers(context.getClient());
+    HttpHeaders headers(context);
     headers.sendHeaderSection(200, true, commonHeaders, NELEMS(commonHeaders));
 
     return true;
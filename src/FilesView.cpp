@@ -90,18 +90,10 @@ bool FilesView::Post(HttpClientContext &context, const String id)
     // The response is sent as a JSON object with the file details.
     // The content type is set to application/json.
     // The response length is calculated and included in the headers.
-    unsigned int len = resp.length();
+    // The response is sent along with the headers, in slices of the header section buffer, because of a limitation of W5500.
     HttpHeaders::Header additionalHeaders[] = {{CONTENT_TYPE::JSON}};
-    EthClient client = context.getClient();
-    HttpHeaders headers(client);
-    headers.sendHeaderSection(200, true, additionalHeaders, NELEMS(additionalHeaders), len);
-
-    // Send the response in slices because of a limitation of W5500. In case of WiFi this doesn't matter.
-    unsigned int index = 0;
-    #define BUFF_SIZE 1024U
-
-    for (unsigned int index = 0; index < len; index += BUFF_SIZE)
-        client.print(resp.substring(index, min<unsigned int>(index + BUFF_SIZE, len)));
+    HttpHeaders headers(context);
+    headers.sendResponse(200, additionalHeaders, NELEMS(additionalHeaders), resp);
 
     return true;
 }
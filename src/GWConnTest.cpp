@@ -23,6 +23,7 @@
 #include <ESP32ping.h>
 #else
 #include <ICMPPingEx.h>
+#include <SocketBudget.h>
 #endif
 #ifdef DEBUG_ETHERNET
 #include <Trace.h>
@@ -72,6 +73,8 @@ bool GWConnTest::ping()
 #else
     // Use the ICMPEchoReplyEx class to ping the gateway
     // The ping method returns true if the gateway is reachable, false otherwise
+    // Make sure there is a socket for the ping, so a busy server does not look like a gateway failure
+    SocketBudget::Lease lease(SocketClass::PROBE);
     ICMPPingEx ping(MAX_SOCK_NUM, 2);
     ICMPEchoReplyEx result = ping(gw, 1);
     return result.pingSent && result.reply.status == SUCCESS;
@@ -19,25 +19,142 @@
 #include <Arduino.h>
 #include <Common.h>
 #include <HTTPServer.h>
+#include <HttpMetrics.h>
 
 std::shared_ptr<HttpController> (*HTTPServer::getDefaultController)(const char *resource) = NULL;
 
 HttpClientContext::HttpClientContext(EthClient &client) :
     keepAlive(false), // default to false
-    client(client), // Store the client connection
-    requestType(HTTP_REQ_TYPE::HTTP_UNKNOWN), // Initialize request type to unknown
     // Initializes the collected headers with the names of the headers we are interested in
     // This allows us to easily access these headers later in the code.
-    collectedHeaders{IF_MODIFIED_SINCE_HEADER_NAME, CONTENT_LENGTH_HEADER_NAME, CONTENT_TYPE_HEADER_NAME} 
+    collectedHeaders{IF_MODIFIED_SINCE_HEADER_NAME, CONTENT_LENGTH_HEADER_NAME, CONTENT_TYPE_HEADER_NAME, CONNECTION_HEADER_NAME, ACCEPT_ENCODING_HEADER_NAME, IF_NONE_MATCH_HEADER_NAME, RANGE_HEADER_NAME, LAST_EVENT_ID_HEADER_NAME},
+    requestType(HTTP_REQ_TYPE::HTTP_UNKNOWN), // Initialize request type to unknown
+    client(client), // Store the client connection
+    // Receive the requests from the stored client connection. The buffer is declared after the client, so the client is already stored.
+    receiveBuffer(this->client),
+    persistent(false),
+    remainingRequests(0),
+    requestStartTime(0),
+    parsedTime(0),
+    firstByteTime(0),
+    bytesSent(0),
+    // The connection is acquired as static until its first request is parsed
+    socketClass(SocketClass::STATIC),
+    expired(false)
 {
     remotePort = client.remotePort();
 }
 
+void HttpClientContext::reset(int remainingRequests)
+{
+    for (HttpHeaders::Header &header : collectedHeaders)
+        header.value = "";
+    requestType = HTTP_REQ_TYPE::HTTP_UNKNOWN;
+    resource = "";
+    httpVersion = "";
+    persistent = false;
+    this->remainingRequests = remainingRequests;
+    // The request starts once its first data is available
+    requestStartTime = micros();
+    parsedTime = 0;
+    firstByteTime = 0;
+    bytesSent = 0;
+    deadline.restart();
+    expired = false;
+}
+
+bool HttpClientContext::waitForData()
+{
+    unsigned long t0 = millis();
+    while (receiveBuffer.available() == 0)
+    {
+        unsigned long waited = millis() - t0;
+        if (!client.connected())
+        {
+            deadline.waited(waited);
+            return false;
+        }
+        if (deadline.isExpired(waited))
+        {
+            deadline.waited(waited);
+            expired = true;
+            return false;
+        }
+        delay(1);
+    }
+    deadline.waited(millis() - t0);
+
+    return true;
+}
+
+size_t HttpClientContext::write(const uint8_t *buf, size_t size)
+{
+    // A write to the client blocks while the client does not make room for the data, holding the SPI bus on the wired build.
+    // So only as much as the client has room for is written at once, and the waits for room are bound by the deadline.
+    size_t written = 0;
+    // The time when data last moved
+    unsigned long t0 = millis();
+    while (written < size)
+    {
+        size_t room = GetRoomForWrite(client, size - written);
+        if (room > 0)
+        {
+            size_t len = client.write(buf + written, room);
+            if (len == 0)
+                break;
+            written += len;
+            deadline.waited(millis() - t0);
+            onResponseSent(len);
+            t0 = millis();
+            continue;
+        }
+        if (!client.connected() || deadline.isExpired(millis() - t0))
+            break;
+        delay(1);
+    }
+    onWaited(millis() - t0);
+    if (deadline.isExpired())
+        expired = true;
+
+    return written;
+}
+
+bool HttpClientContext::acceptsGzip() const
+{
+    // Look for gzip in the list of accepted encodings, e.g. "gzip, deflate, br".
+    // An encoding with a zero quality value, e.g. "gzip;q=0", is not acceptable.
+    String acceptEncoding = GET_HEADER_BY_NAME(ACCEPT_ENCODING_HEADER_NAME)->value;
+    acceptEncoding.toLowerCase();
+    acceptEncoding.replace(" ", "");
+    int gzip = acceptEncoding.indexOf("gzip");
+    if (gzip == -1)
+        return false;
+
+    String parameters = acceptEncoding.substring(gzip + 4);
+    if (parameters.startsWith(";q="))
+        return parameters.substring(3).toFloat() > 0;
+
+    return true;
+}
+
 bool HttpClientContext::parseRequestHeaderSection()
 {
     HttpHeaders headers(client); // Create an instance of HttpHeaders to handle the request headers
 
-    bool res = headers.parseRequestHeaderSection(requestType, resource, collectedHeaders.data(), collectedHeaders.size());
+    bool res = headers.parseRequestHeaderSection(receiveBuffer, requestType, resource, collectedHeaders.data(), collectedHeaders.size());
+    httpVersion = headers.getHttpVersion();
+    parsedTime = micros();
+    if (res && remainingRequests > 0)
+    {
+        // HTTP/1.1 connections are persistent unless the client asks to close them.
+        // HTTP/1.0 connections are persistent only when the client asks to keep them alive.
+        String connection = GET_HEADER_BY_NAME(CONNECTION_HEADER_NAME)->value;
+        connection.toLowerCase();
+        if (httpVersion.equals("HTTP/1.1"))
+            persistent = connection.indexOf("close") == -1;
+        else
+            persistent = connection.indexOf("keep-alive") != -1;
+    }
 #ifdef DEBUG_HTTP_SERVER
     Tracef("%d %s\n", remotePort, headers.getRequestLine().c_str());
     if (!res)
@@ -47,105 +164,98 @@ bool HttpClientContext::parseRequestHeaderSection()
     return res;
 }
 
-HTTPServer::ControllersDataList HTTPServer::controllersData;
+HTTPServer::ControllersTrie HTTPServer::controllers;
 
 void HTTPServer::AddController(const String path, GetControllerInstance instanceGetter)
 {
-    HttpControllerCreatorData creatorData(path, instanceGetter);
-    controllersData.Insert(creatorData);
+    controllers.Insert(path.c_str(), instanceGetter);
 }
 
-bool HTTPServer::GetController(HttpClientContext *context, std::shared_ptr<HttpController> &controller, String &id)
+bool HTTPServer::GetController(HttpClientContext *context, std::shared_ptr<HttpController> &controller, String &id, String &route)
 {
-    // Get the resource pf the request from the context
-    String resource = context->getResource();
-
-    // Prepare the parameters to the function that will be used to find the controller
-    // that will handle the request.
-    struct Params
+    // Get the resource of the request from the context
+    const String &resource = context->getResource();
+
+    // Find the controller with the longest path that matches the beginning of the resource.
+    // The trie matches only on a segment boundary. For example: if the controller path is /settings and the resource is /settings3,
+    // we don't want to identify the resource as settings and the id as 3.
+    // A correct example is /settings/3, where the resource is settings and the id is 3.
+    GetControllerInstance instanceGetter;
+    size_t pathLength;
+    controller = NULL;
+    id = "";
+    route = HTTP_METRICS_NOT_FOUND_ROUTE;
+    if (controllers.Find(resource.c_str(), instanceGetter, pathLength))
     {
-        String id;
-        String resource;
-        std::shared_ptr<HttpController> controller;
-    } params = {"", resource, NULL };
-
-    // Scan the list of controllers to find the best matching controller for the request
-    controllersData.ScanNodes([](HttpControllerCreatorData const &creatorData, void *param)->bool
+        route = resource.substring(0, pathLength);
+        route.toUpperCase();
+        // The id is the part of the resource that comes after the path and the '/' that follows it.
+        if (pathLength < resource.length())
+            id = resource.substring(pathLength + 1);
+        controller = instanceGetter();
+    }
+    else if (getDefaultController != NULL)
     {
-        Params *params = static_cast<Params *>(param);
-        String path = creatorData.getPath();
-        String resource = params->resource;
-        resource.toUpperCase();
-
-        if (path.equals("/"))
-        {
-            // If the path is "/", we need to check if the resource is also "/"
-            if (resource.equals("/"))
-            {
-                // Get an instance for the controller that handles the root path.
-                // This is typically the index.htm file or a controller that handles the root path.
-                params->controller = creatorData.getInstanceGetter()();
-                return false;
-            }
-            return true; // Stop iterating the list nodes
-        }
-
-        if (resource.startsWith(path))
-        {
-            if (!resource.equals(path))
-            {
-                // If the resource is not exactly the same as the path, we need to extract the id
-                // from the resource. The id is the part of the resource that comes after the path.
-                params->id = params->resource.substring(path.length());
-                // The id must start with a '/' otherwise it is not a valid id.
-                // For example: if the controller path is settings and the resource is /settings3,
-                // We don't want to identify the resource as settings and the id as 3.
-                // A correct example is /settings/3, where the idresource is settings and the id is 3.
-                if (params->id[0] != '/')
-                    return true; // Continue searching.
-                params->id = params->id.substring(1);
-            }
-            // If the resource starts with the path, we have found a controller that can handle the request.
-            params->controller = creatorData.getInstanceGetter()();
-            return false; // Stop searching
-        }
-
-        return true; // Continue searching
-    }, &params);
-
-    // Extract the results returned from the scan function
-    id = params.id;
-    controller = params.controller;
-    if (controller == NULL && getDefaultController != NULL)
         // If no controller was found, we return a controller that attemps to open the file specified in the resource
         // part of the URL. If this file exists, the content of the file will be return to the client.
         controller = getDefaultController(resource.c_str());
+        route = HTTP_METRICS_FILES_ROUTE;
+    }
 
     return controller != NULL;
 }
 
-void HTTPServer::NotModified(EthClient &client)
+void HTTPServer::NotModified(HttpClientContext &context, const String &etag)
 {
-    HttpHeaders headers(client);
-    headers.sendHeaderSection(304);
+    HttpHeaders::Header additionalHeaders[] = { {} };
+    if (!etag.isEmpty())
+        additionalHeaders[0] = {"ETag", etag};
+    HttpHeaders headers(context);
+    headers.sendHeaderSection(304, true, additionalHeaders, NELEMS(additionalHeaders));
 }
 
-void HTTPServer::PageNotFound(EthClient &client)
+void HTTPServer::PageNotFound(HttpClientContext &context)
 {
-    HttpHeaders headers(client);
+    HttpHeaders headers(context);
     headers.sendHeaderSection(404);
 }
 
+void HTTPServer::ServiceUnavailable(EthClient &client)
+{
+    // Drain what the client has sent so far, so the connection is not reset before the response is read.
+    // Only the data that was already received is drained, the program loop should not be blocked.
+    while(client.available())
+    {
+        uint8_t buff[128];
+        client.read(buff, NELEMS(buff));
+    }
+    HttpHeaders::Header additionalHeaders[] = { {"Retry-After", String(HTTP_RETRY_AFTER)} };
+    HttpHeaders headers(client);
+    headers.sendHeaderSection(503, true, additionalHeaders, NELEMS(additionalHeaders));
+    client.stop();
+}
+
+void HTTPServer::getAdmissionStats(AdmissionStats &stats)
+{
+    stats.accepted = acceptedConnections;
+    stats.rejected = rejectedConnections;
+    stats.expired = expiredConnections;
+    stats.queued = requestsQueue == NULL ? 0 : uxQueueMessagesWaiting(requestsQueue);
+    stats.maxQueued = maxQueuedConnections;
+}
+
 void HTTPServer::ServiceRequest(HttpClientContext *context)
 {
     std::shared_ptr<HttpController> controller;
     String id;
+    String route;
 
     // Get the controller that will handle the request.
     // If no controller is found, we will return a 404 Not Found response.
-    if (!GetController(context, controller, id))
+    if (!GetController(context, controller, id, route))
     {
-        PageNotFound(context->getClient());
+        PageNotFound(*context);
+        RecordMetrics(context, route, false);
         return;
     }
 
@@ -183,11 +293,31 @@ void HTTPServer::ServiceRequest(HttpClientContext *context)
     // This can happen if the controller does not implement the requested method
     // or the controller failed to serve the request.
     if (!ret)
-        PageNotFound(context->getClient());
+    {
+        // The controller may have left part of the request body unread.
+        // Close the connection, so that the rest of the body is not taken for the next request.
+        if (context->getContentLength() > 0)
+            context->closeAfterResponse();
+        PageNotFound(*context);
+    }
+
+    RecordMetrics(context, route, ret);
 
     // If the controller is not singleton, we delete it.
 }
 
+void HTTPServer::RecordMetrics(HttpClientContext *context, const String &route, bool succeeded)
+{
+    uint32_t start = context->getRequestStartTime();
+    HttpMetrics::Sample sample;
+    sample.succeeded = succeeded;
+    sample.parseTime = context->getParsedTime() - start;
+    sample.firstByteTime = context->getFirstByteTime() == 0 ? 0 : context->getFirstByteTime() - start;
+    sample.totalTime = micros() - start;
+    sample.bytesSent = context->getBytesSent();
+    HttpMetrics::record(route, sample);
+}
+
 #ifndef USE_WIFI
 // If we are not using WiFi, we use the Ethernet server
 EthServer HTTPServer::server(80);
@@ -198,24 +328,64 @@ WiFiServer HTTPServer::server(80, MAX_CLIENTS);
 #endif
 
 bool HTTPServer::stopServer = false;
-
-void HTTPServer::Init()
+bool (*HTTPServer::canServe)() = NULL;
+QueueHandle_t HTTPServer::requestsQueue = NULL;
+uint32_t HTTPServer::acceptedConnections = 0;
+uint32_t HTTPServer::rejectedConnections = 0;
+std::atomic<uint32_t> HTTPServer::expiredConnections(0);
+size_t HTTPServer::maxQueuedConnections = 0;
+
+/// @brief Statically allocated storage of the requests queue and the worker tasks.
+/// This memory is reserved once, so serving a request does not involve creating tasks or allocating stacks.
+static StaticQueue_t requestsQueueBuffer;
+static uint8_t requestsQueueStorage[HTTP_REQUESTS_QUEUE_DEPTH * sizeof(HttpClientContext *)];
+static StackType_t workersStacks[HTTP_WORKERS_POOL_SIZE][HTTP_WORKER_STACK_SIZE];
+static StaticTask_t workersTasks[HTTP_WORKERS_POOL_SIZE];
+static StackType_t acceptStack[HTTP_ACCEPT_STACK_SIZE];
+static StaticTask_t acceptTask;
+
+void HTTPServer::Init(bool (*canServe)())
 {
+    HTTPServer::canServe = canServe;
+    // Create the queue that feeds the workers with accepted client connections
+    requestsQueue = xQueueCreateStatic(HTTP_REQUESTS_QUEUE_DEPTH, sizeof(HttpClientContext *), requestsQueueStorage, &requestsQueueBuffer);
+    // Create the pool of worker tasks
+    for (int i = 0; i < HTTP_WORKERS_POOL_SIZE; i++)
+    {
+        char taskName[16];
+        snprintf(taskName, sizeof(taskName), "HTTPWorker%d", i);
+        xTaskCreateStatic(RequestWorker, taskName, HTTP_WORKER_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, workersStacks[i], &workersTasks[i]);
+    }
     server.begin();
+    // Create the task that accepts client connections and hands them over to the workers.
+    // It runs at the priority of the workers, so a burst of connections does not hold up the requests that are being served.
+    xTaskCreateStatic(AcceptTask, "HTTPAccept", HTTP_ACCEPT_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, acceptStack, &acceptTask);
 #ifdef DEBUG_HTTP_SERVER
-    Traceln("HTTP Server has started");
+    Tracef("HTTP Server has started, %d workers, queue depth %d\n", HTTP_WORKERS_POOL_SIZE, HTTP_REQUESTS_QUEUE_DEPTH);
 #endif
 }
 
-#define TASK_CREATE_MAX_RETRIES 20
+void HTTPServer::AcceptTask(void *params)
+{
+    while (true)
+    {
+        // Check again right away as long as clients keep connecting
+        if ((canServe == NULL || canServe()) && ServeClient())
+        {
+            taskYIELD();
+            continue;
+        }
+        vTaskDelay(pdMS_TO_TICKS(HTTP_ACCEPT_POLL_INTERVAL));
+    }
+}
 
-void HTTPServer::ServeClient()
+bool HTTPServer::ServeClient()
 {
     // Listen for incoming clients
     EthClient client = server.accept();
     // If no client is connected, return
     if (!client.connected())
-        return;
+        return false;
     if (stopServer)
     {
         // If the server is stopped, we send a 403 Forbidden response
@@ -223,7 +393,7 @@ void HTTPServer::ServeClient()
         HttpHeaders headers(client);
         headers.sendHeaderSection(403);
         client.stop();
-        return;
+        return true;
     }
     #ifdef DEBUG_HTTP_SERVER
     // Log the new client connection details
@@ -233,113 +403,153 @@ void HTTPServer::ServeClient()
     Tracef("New client: IP=%s, port=%d\n", client.remoteIP().toString().c_str(), client.remotePort());
 #endif
 #endif
-    // Create a new HttpClientContext for the request
-    HttpClientContext *context = new HttpClientContext(client);
-    BaseType_t ret;
-    for (int i = 0; i <= TASK_CREATE_MAX_RETRIES; i++)
+    // Admission control: when all the workers are busy and the queue is full, the client is rejected right away.
+    // The client is asked to retry later, rather than the program loop being blocked until a worker is free.
+    if (uxQueueSpacesAvailable(requestsQueue) == 0)
     {
-        // Create a new task to handle the request
-        ret = xTaskCreate(RequestTask, "HTTPRequest", 4*1024, context, tskIDLE_PRIORITY + 1, NULL);
-        // If the task was created successfully, break the loop
-        // Otherwise, wait for a while and try again
-        if (ret == pdPASS)
-        {
 #ifdef DEBUG_HTTP_SERVER
-            if (i > 0)
-                Tracef("%d Succeeded to create request task after %d retries\n", client.remotePort(), i);
+        Tracef("%d Requests queue is full\n", client.remotePort());
 #endif
-            break;
-        }
-#ifdef DEBUG_HTTP_SERVER
-        if (i == 0)
-            Tracef("%d Failed to create request task, error = %d will attempt again\n", client.remotePort(), ret);
-#endif
-        delay(1000); // Wait before reattempting creating the task
+        rejectedConnections++;
+        ServiceUnavailable(client);
+        return true;
     }
 
-    // If the task was not created successfully after the maximum number of retries,
-    // drain the client and send a 500 Internal Server Error response.
-    if (ret != pdPASS)
+    // The connection must also fit the socket budget, so it does not take the sockets that are reserved for the system.
+    if (!SocketBudget::acquire(SocketClass::STATIC))
     {
 #ifdef DEBUG_HTTP_SERVER
-        // Log the failure to create the request task
-        Tracef("%d Failed to create request task after %d attempts, error = %d\n", client.remotePort(), TASK_CREATE_MAX_RETRIES, ret);
+        Tracef("%d No room in the socket budget\n", client.remotePort());
 #endif
-        // Drain the client
-        while(client.available())
-        {
-            uint8_t buff[128];
-            client.read(buff, NELEMS(buff));
-        }
-        // Send 500 reply
-        HttpHeaders headers(client);
-        headers.sendHeaderSection(500);
-        // Stop the client connection
-        client.stop();
-        // Delete the context to free resources
+        rejectedConnections++;
+        ServiceUnavailable(client);
+        return true;
+    }
+
+    // Create a new HttpClientContext for the request and hand it over to the workers.
+    // There is room in the queue, and this is the only task that adds to it, so sending does not wait.
+    HttpClientContext *context = new HttpClientContext(client);
+    if (xQueueSend(requestsQueue, &context, 0) != pdPASS)
+    {
         delete context;
+        SocketBudget::release(SocketClass::STATIC);
+        rejectedConnections++;
+        ServiceUnavailable(client);
+        return true;
     }
+
+    acceptedConnections++;
+    size_t queued = uxQueueMessagesWaiting(requestsQueue);
+    if (queued > maxQueuedConnections)
+        maxQueuedConnections = queued;
+
+    return true;
 }
 
-void HTTPServer::RequestTask(HttpClientContext *context)
+bool HTTPServer::WaitForRequest(HttpClientContext *context, unsigned long timeout, bool yieldToQueue)
 {
-    EthClient client = context->getClient();
-
-    // Wait for the client to send data
-    // We wait for up to 3 seconds for the client to send data
+    EthClient &client = context->getClient();
     unsigned long t0 = millis();
-    while (!client.available() && millis() - t0 < 3000);
-    if (!client.available())
-        return;
-
-    // Parse the request header section from the client
-    // This will read the HTTP request headers and determine the request type (GET, POST, etc.)
-    // It will also extract the requested resource and collect relevant headers.
-    if (!context->parseRequestHeaderSection())
+    unsigned long pollInterval = 1;
+    // The next request may already be received, if the client sent it along with the previous one
+    while (!context->available())
     {
-        // If the request header section could not be parsed, we send a 400 Bad Request response
-        HttpHeaders headers(context->getClient());
-        headers.sendHeaderSection(400);
-        return;
+        if (!client.connected() || millis() - t0 >= timeout)
+            return false;
+        // An idle persistent connection should not hold a worker while other clients wait for one.
+        // It is also closed when the socket budget needs room for another socket.
+        if (yieldToQueue && (uxQueueMessagesWaiting(requestsQueue) > 0 || SocketBudget::takeIdleEviction()))
+            return false;
+        // Sleep between the checks, so other tasks may run. Every check is a transaction on the SPI bus on the wired build,
+        // so a connection that stays idle is checked less and less often.
+        vTaskDelay(pdMS_TO_TICKS(pollInterval));
+        if (pollInterval < HTTP_IDLE_POLL_INTERVAL)
+            pollInterval *= 2;
     }
-    // Do the actual request handling
-    ServiceRequest(context);
+
+    return true;
 }
 
-void HTTPServer::RequestTask(void *params)
+void HTTPServer::RequestTask(HttpClientContext *context)
 {
-    HttpClientContext *context = static_cast<HttpClientContext *>(params);
-    // Serve the request
-    RequestTask(context);
-
-    // If the client should not be kept alive, then stop the client connection.
-    if (!context->keepAlive)
+    for (int nRequests = 1; nRequests <= HTTP_KEEP_ALIVE_MAX_REQUESTS; nRequests++)
     {
+        // Wait for the client to send data
+        // We wait for up to 3 seconds for the first request, and for the keep-alive timeout for the next ones.
+        bool firstRequest = nRequests == 1;
+        if (!WaitForRequest(context, firstRequest ? DEFAULT_RECEIVE_TIMEOUT : HTTP_KEEP_ALIVE_TIMEOUT, !firstRequest))
+            return;
+
+        context->reset(stopServer ? 0 : HTTP_KEEP_ALIVE_MAX_REQUESTS - nRequests);
+
+        // Parse the request header section from the client
+        // This will read the HTTP request headers and determine the request type (GET, POST, etc.)
+        // It will also extract the requested resource and collect relevant headers.
+        if (!context->parseRequestHeaderSection())
+        {
+            // If the request header section could not be parsed, we send a 400 Bad Request response
+            context->closeAfterResponse();
+            HttpHeaders headers(*context);
+            headers.sendHeaderSection(400);
+            return;
+        }
+        // Account for the socket by the kind of the resource that is requested
+        context->setSocketClass(SocketBudget::classify(context->getResource()));
+        // Do the actual request handling
+        ServiceRequest(context);
+
+        // A client that was too slow to send the request or to receive the response has its connection closed.
+        // A connection that was handed over (e.g. SSE) is no longer bound by the deadline of the request.
+        if (!context->keepAlive && context->isExpired())
+        {
 #ifdef DEBUG_HTTP_SERVER
-        Tracef("%d Stopping client\n", context->getRemotePort());
-#endif
-        context->getClient().stop();
-    }
-#ifdef DEBUG_HTTP_SERVER
-    else
-        Tracef("%d Keeping alive\n", context->getRemotePort());
+            Tracef("%d Request expired, closing the connection\n", context->getRemotePort());
 #endif
-    // Delete the context to free resources
-    delete context;
+            expiredConnections++;
+            return;
+        }
+
+        // Stop if the connection was handed over to someone else (e.g. SSE) or if it should be closed.
+        if (context->keepAlive || !context->isPersistent())
+            return;
 #ifdef DEBUG_HTTP_SERVER
-    Tracef("%d Task stack high watermark: %d\n", context->getRemotePort(), uxTaskGetStackHighWaterMark(NULL));
+        Tracef("%d Waiting for the next request on the connection\n", context->getRemotePort());
 #endif
-    // Delete the task that was created to handle the request
-    // This will free the resources allocated for the task
-    vTaskDelete(NULL);
+    }
 }
 
-void InitHTTPServer()
+void HTTPServer::RequestWorker(void *params)
 {
-    HTTPServer::Init();
+    while (true)
+    {
+        // Wait for the next accepted client
+        HttpClientContext *context;
+        if (xQueueReceive(requestsQueue, &context, portMAX_DELAY) != pdPASS)
+            continue;
+
+        // Serve the request
+        RequestTask(context);
+
+        // If the client should not be kept alive, then stop the client connection.
+        if (!context->keepAlive)
+        {
+#ifdef DEBUG_HTTP_SERVER
+            Tracef("%d Stopping client\n", context->getRemotePort());
+#endif
+            context->getClient().stop();
+            SocketBudget::release(context->getSocketClass());
+        }
+#ifdef DEBUG_HTTP_SERVER
+        else
+            Tracef("%d Keeping alive\n", context->getRemotePort());
+        Tracef("%d Worker stack high watermark: %d\n", context->getRemotePort(), uxTaskGetStackHighWaterMark(NULL));
+#endif
+        // Delete the context to free resources
+        delete context;
+    }
 }
 
-void DoHTTPService()
+void InitHTTPServer(bool (*canServe)())
 {
-    HTTPServer::ServeClient();
+    HTTPServer::Init(canServe);
 }
\ No newline at end of file
@@ -48,21 +48,31 @@ static const RecoverySourcesMap recoverySourcesMap =
 };
 #undef X
 
-typedef bool(*fillFile)(SdFile &file);
+/// @brief A Print that appends everything that is printed to a String.
+class StringPrint : public Print
+{
+public:
+    StringPrint(String &str) : str(str) {}
+    virtual size_t write(uint8_t c) { str += static_cast<char>(c); return 1; }
+    virtual size_t write(const uint8_t *buffer, size_t size) { str.concat(reinterpret_cast<const char *>(buffer), size); return size; }
+
+private:
+    String &str;
+};
 
-/// @brief Check and print a buffer to the file
-/// @param f The file to print to
+/// @brief Check and print a buffer to the output
+/// @param f The output to print to
 /// @param b The buffer to print
 /// @param l The length of the buffer
 /// @note l is the return value of a call to sprintf(), b is the buffer passed to 
 /// sprintf(). So we check that the return value of sprintf() is not more than the
 /// size of the buffer. Otherwise, we have a buffer overflow. We also check that
-/// the file was written successfully.
+/// the output was written successfully.
 #define CHECK_PRINT(f, b, l) if ((l) > NELEMS(b) || f.print(b) != (l)) return false
-/// @brief Check and print a string literal to the file.
+/// @brief Check and print a string literal to the output.
 /// @note We call the CHECK_PRINT macro with the length of the string literal.
 /// This should eliminate the length check because the length check always
-/// calculates to false. So in this case, we only check that the file was 
+/// calculates to false. So in this case, we only check that the output was 
 /// written successfully.
 #define CHECK_PRINT_STRL(f, s) \
     REQUIRE_STRING_LITERAL(s); \
@@ -80,79 +90,87 @@ static int formatTime(time_t time, char *buff, size_t buffSize)
     return static_cast<int>(strftime(buff, buffSize, "%d/%m/%Y %T", &tr));
 }
 
-/// @brief Fill the alerts section of the history view
-/// @param file The SD file to write to
+/// @brief Get the number of parts of the alerts section of the history view
+/// @return One part per history item, or a single part when there is no history yet.
+static int alertsParts()
+{
+    return std::max(1, historyControl.Available());
+}
+
+/// @brief Fill a part of the alerts section of the history view
+/// @param out The output to write to
+/// @param i The index of the history item to write
 /// @return True if successful, false otherwise
-/// @note This function writes the HTML for the alerts section of the history view.
-static bool fillAlerts(SdFile &file)
+/// @note This function writes the HTML for the alert of a single history item.
+static bool fillAlert(Print &out, int i)
 {
     if (historyControl.Available() == 0)
     {
         // No history available
-        CHECK_PRINT_STRL(file, "<div class=\"alert alert-success\">There is no history yet.</div>\n");
+        CHECK_PRINT_STRL(out, "<div class=\"alert alert-success\">There is no history yet.</div>\n");
         return true;
     }
 
-    // Iterate over the available history items
-    for(int i = 0; i < historyControl.Available(); i++)
+    if (i >= historyControl.Available())
+        // The history has shrunk while the view was generated
+        return true;
+
+    HistoryStorageItem hItem = historyControl.GetHistoryItem(i);
+    CHECK_PRINT_STRL(out, "<div class=\"col-lg-3 col-md-4 col-sm-6 col-xs-12\">\n");
+    char buff[128];
+    // Start the history alert item div element
+    int len = snprintf(buff, NELEMS(buff), "<div id=\"historyItem%d\" class=\"alert\">\n", i);
+    CHECK_PRINT(out, buff, len);
+    // Write the recovery source alert header element
+    len = snprintf(buff, NELEMS(buff), "<h4 id=\"recoverySource%d\" class=\"alert-heading\"></h4>\n<hr />\n<p><span class=\"attribute-name\">\n", i);
+    CHECK_PRINT(out, buff, len);
+    if (hItem.endTime() != INT32_MAX)
     {
-        HistoryStorageItem hItem = historyControl.GetHistoryItem(i);
-        CHECK_PRINT_STRL(file, "<div class=\"col-lg-3 col-md-4 col-sm-6 col-xs-12\">\n");
-        char buff[128];
-        // Start the history alert item div element
-        int len = snprintf(buff, NELEMS(buff), "<div id=\"historyItem%d\" class=\"alert\">\n", i);
-        CHECK_PRINT(file, buff, len);
-        // Write the recovery source alert header element
-        len = snprintf(buff, NELEMS(buff), "<h4 id=\"recoverySource%d\" class=\"alert-heading\"></h4>\n<hr />\n<p><span class=\"attribute-name\">\n", i);
-        CHECK_PRINT(file, buff, len);
-        if (hItem.endTime() != INT32_MAX)
-        {
-            // If there is end time for the recovery, then write the start time first.
-            CHECK_PRINT_STRL(file, "Start ");
-        }
+        // If there is end time for the recovery, then write the start time first.
+        CHECK_PRINT_STRL(out, "Start ");
+    }
 
-        // Write the recovery time.
-        char timeBuff[64];
-        len = formatTime(hItem.startTime(), timeBuff, NELEMS(timeBuff));
-        if (len == 0)
-            return false;
-        len = snprintf(buff, NELEMS(buff), "Time:</span><br /><span class=\"indented\">%s</span></p>\n<p ", timeBuff);
-        CHECK_PRINT(file, buff, len);
+    // Write the recovery time.
+    char timeBuff[64];
+    len = formatTime(hItem.startTime(), timeBuff, NELEMS(timeBuff));
+    if (len == 0)
+        return false;
+    len = snprintf(buff, NELEMS(buff), "Time:</span><br /><span class=\"indented\">%s</span></p>\n<p ", timeBuff);
+    CHECK_PRINT(out, buff, len);
 
-        if (hItem.endTime() == INT32_MAX)
-        {
-            // If there in no end time for the recovery then hide the end time element.
-            CHECK_PRINT_STRL(file, "style=\"visibility:hidden\"");
-        }
-        // Write the end time span element.
-        CHECK_PRINT_STRL(file, "><span class=\"attribute-name\">End Time:</span><br /><span class=\"indented\">");
-        // Write the end time
-        len = formatTime(hItem.endTime(), timeBuff, NELEMS(timeBuff));
-        if (len == 0)
-            return false;
-        CHECK_PRINT(file, timeBuff, len);
-        // Close the end time span and paragraph elements and start the modem/router recovery counters paragraph element
-        CHECK_PRINT_STRL(file, "</span></p>\n<p ");
-        if (hItem.modemRecoveries() == 0 && hItem.routerRecoveries() == 0)
-        {
-            // If both modem and router recovery counters are zero, hide the recoveries counters element
-            CHECK_PRINT_STRL(file, "style=\"visibility:hidden\"");
-        }
-        // Write the recoveries counters element header
-        CHECK_PRINT_STRL(file, "><span class=\"attribute-name\">Recoveries:</span><br />");
-        // Write the router recovery counter span element
-        len = snprintf(buff, NELEMS(buff), "<span class=\"indented\">%s: %d</span>", Config::deviceName, hItem.routerRecoveries());
-        CHECK_PRINT(file, buff, len);
-        if (!Config::singleDevice)
-        {
-            // Write the modem recovery counter span element
-            len = snprintf(buff, NELEMS(buff), "<span class=\"indented\">Modem: %d</span>", hItem.modemRecoveries());
-            CHECK_PRINT(file, buff, len);
-        }
-        // Close the recoveries counters paragraph element and write the recovery status element
-        len = snprintf(buff, NELEMS(buff), "</p>\n<hr />\n<h4 id=\"recoveryStatus%d\"></h4>\n</div>\n</div>\n", i);
-        CHECK_PRINT(file, buff, len);
+    if (hItem.endTime() == INT32_MAX)
+    {
+        // If there in no end time for the recovery then hide the end time element.
+        CHECK_PRINT_STRL(out, "style=\"visibility:hidden\"");
     }
+    // Write the end time span element.
+    CHECK_PRINT_STRL(out, "><span class=\"attribute-name\">End Time:</span><br /><span class=\"indented\">");
+    // Write the end time
+    len = formatTime(hItem.endTime(), timeBuff, NELEMS(timeBuff));
+    if (len == 0)
+        return false;
+    CHECK_PRINT(out, timeBuff, len);
+    // Close the end time span and paragraph elements and start the modem/router recovery counters paragraph element
+    CHECK_PRINT_STRL(out, "</span></p>\n<p ");
+    if (hItem.modemRecoveries() == 0 && hItem.routerRecoveries() == 0)
+    {
+        // If both modem and router recovery counters are zero, hide the recoveries counters element
+        CHECK_PRINT_STRL(out, "style=\"visibility:hidden\"");
+    }
+    // Write the recoveries counters element header
+    CHECK_PRINT_STRL(out, "><span class=\"attribute-name\">Recoveries:</span><br />");
+    // Write the router recovery counter span element
+    len = snprintf(buff, NELEMS(buff), "<span class=\"indented\">%s: %d</span>", Config::deviceName, hItem.routerRecoveries());
+    CHECK_PRINT(out, buff, len);
+    if (!Config::singleDevice)
+    {
+        // Write the modem recovery counter span element
+        len = snprintf(buff, NELEMS(buff), "<span class=\"indented\">Modem: %d</span>", hItem.modemRecoveries());
+        CHECK_PRINT(out, buff, len);
+    }
+    // Close the recoveries counters paragraph element and write the recovery status element
+    len = snprintf(buff, NELEMS(buff), "</p>\n<hr />\n<h4 id=\"recoveryStatus%d\"></h4>\n</div>\n</div>\n", i);
+    CHECK_PRINT(out, buff, len);
 
     return true;
 }
@@ -160,232 +178,249 @@ static bool fillAlerts(SdFile &file)
 #define recoveryStatusEnumName "recoveryStatus"
 #define recoverySourceEnumName "recoverySource"
 
-/// @brief Fills the JS enum definition in the specified file.
+/// @brief Fills the JS enum definition in the specified output.
 /// @tparam T The type of the map containing the enum values.
-/// @param file The file to write the enum definition to.
+/// @param out The output to write the enum definition to.
 /// @param map The map containing the enum values.
 /// @param varName The name of the enum variable.
 /// @return True if the operation was successful, false otherwise.
 template <typename T>
-static bool fillEnum(SdFile &file, T map, const char *varName)
+static bool fillEnum(Print &out, T map, const char *varName)
 {
     char buff[128];
 
     // Write the enum definition header
     size_t len = snprintf(buff, NELEMS(buff), "\tconst %s = {\n", varName);
-    CHECK_PRINT(file, buff, len);
+    CHECK_PRINT(out, buff, len);
     // Write the enum values
     for (typename T::const_iterator i = map.begin(); i != map.end(); i++)
     {
         len = snprintf(buff, NELEMS(buff), "\t\t%s: %d,\n", i->second.c_str(), static_cast<int>(i->first));
-        CHECK_PRINT(file, buff, len);
+        CHECK_PRINT(out, buff, len);
     };
     // Write the enum definition footer
-    CHECK_PRINT_STRL(file, "\t};\n");
+    CHECK_PRINT_STRL(out, "\t};\n");
 
     return true;
 }
 
 /// @brief Fill the enums section of the history view
-/// @param file The file to write the enums section to
+/// @param out The output to write the enums section to
 /// @return True if the operation was successful, false otherwise
-static bool fillEnums(SdFile &file)
+static bool fillEnums(Print &out)
 {
-    return fillEnum<RecoveryStatusesMap>(file, recoveryStatusesMap, recoveryStatusEnumName) && 
-           fillEnum<RecoverySourcesMap>(file, recoverySourcesMap, recoverySourceEnumName);
+    return fillEnum<RecoveryStatusesMap>(out, recoveryStatusesMap, recoveryStatusEnumName) && 
+           fillEnum<RecoverySourcesMap>(out, recoverySourcesMap, recoverySourceEnumName);
 }
 
-/// @brief Fill the recovery source enum value in the specified file.
-/// @param file The file to write the enum value to.
+/// @brief Fill the recovery source enum value in the specified output.
+/// @param out The output to write the enum value to.
 /// @param source The recovery source enum value to write.
 /// @return True if the operation was successful, false otherwise.
-static bool fillRecoverySourceEnum(SdFile file, RecoverySource source)
+static bool fillRecoverySourceEnum(Print &out, RecoverySource source)
 {
     char buff[128];
 
     size_t len = snprintf(buff, NELEMS(buff), "%s.%s", recoverySourceEnumName, recoverySourcesMap.at(source).c_str());
 
-    CHECK_PRINT(file, buff, len);
+    CHECK_PRINT(out, buff, len);
 
     return true;
 }
 
-/// @brief Fill the recovery status enum value in the specified file.
-/// @param file The file to write the enum value to.
+/// @brief Fill the recovery status enum value in the specified output.
+/// @param out The output to write the enum value to.
 /// @param status The recovery status enum value to write.
 /// @return True if the operation was successful, false otherwise.
-static bool fillRecoveryStatusEnum(SdFile file, RecoveryStatus status)
+static bool fillRecoveryStatusEnum(Print &out, RecoveryStatus status)
 {
     char buff[128];
 
     size_t len = snprintf(buff, NELEMS(buff), "%s.%s", recoveryStatusEnumName, recoveryStatusesMap.at(status).c_str());
 
-    CHECK_PRINT(file, buff, len);
+    CHECK_PRINT(out, buff, len);
 
     return true;
 }
 
-/// @brief Fills the JavaScript section of the history view
-/// @param file The file to write the JavaScript section to
+/// @brief Fills a part of the JavaScript section of the history view
+/// @param out The output to write the JavaScript section to
+/// @param i The index of the history item to write
 /// @return True if the operation was successful, false otherwise
-/// @note This function writes JavaScript code that initializes the recovery source and status for each history item.
-static bool fillJS(SdFile &file)
+/// @note This function writes JavaScript code that initializes the recovery source and status of a history item.
+static bool fillJS(Print &out, int i)
 {
+    if (i >= historyControl.Available())
+        // The history has shrunk while the view was generated
+        return true;
+
     char buff[128];
-    // Iterate through history items
-    for (int i = 0; i < historyControl.Available(); i++)
-    {
-        HistoryStorageItem hItem = historyControl.GetHistoryItem(i);
-        // Write a call to setRecoverySource for the given history item
-        int len = snprintf(buff, NELEMS(buff), "\t\tsetRecoverySource(%d, ", i);
-        CHECK_PRINT(file, buff, len);
-        fillRecoverySourceEnum(file, hItem.recoverySource());
-        char closeCall[] = ");\n";
-        CHECK_PRINT_STRL(file, closeCall);
-        // Write a call to setRecoveryStatus for the given history item
-        len = snprintf(buff, NELEMS(buff), "\t\tsetRecoveryStatus(%d, ", i);
-        CHECK_PRINT(file, buff, len);
-        fillRecoveryStatusEnum(file, hItem.recoveryStatus());
-        CHECK_PRINT_STRL(file, closeCall);
-    }
+    HistoryStorageItem hItem = historyControl.GetHistoryItem(i);
+    // Write a call to setRecoverySource for the given history item
+    int len = snprintf(buff, NELEMS(buff), "\t\tsetRecoverySource(%d, ", i);
+    CHECK_PRINT(out, buff, len);
+    fillRecoverySourceEnum(out, hItem.recoverySource());
+    char closeCall[] = ");\n";
+    CHECK_PRINT_STRL(out, closeCall);
+    // Write a call to setRecoveryStatus for the given history item
+    len = snprintf(buff, NELEMS(buff), "\t\tsetRecoveryStatus(%d, ", i);
+    CHECK_PRINT(out, buff, len);
+    fillRecoveryStatusEnum(out, hItem.recoveryStatus());
+    CHECK_PRINT_STRL(out, closeCall);
+
     return true;
 }
 
-CriticalSection HistoryViewReader::cs;
-
-#define TEMP_HISTORY_FILE_DIR "/wwwroot/temp"
-#define TEMP_HISTORY_FILE_PATH TEMP_HISTORY_FILE_DIR "/history.htm"
-#define fillerChar '%'
-#define STRNCHR(b, c, n) static_cast<char *>(memchr(b, c, n))
+/// @brief A filler of the history view.
+/// The value of a filler is generated in parts, e.g. a part per history item,
+/// so only a single part is kept in memory at a time.
+struct HistoryViewReader::Filler
+{
+    /// @brief Gets the number of parts of the filler value.
+    int (*nParts)();
+    /// @brief Generates a part of the filler value.
+    bool (*fillPart)(Print &out, int part);
+};
 
-bool HistoryViewReader::open(byte *buff, int buffSize)
+/// @brief Gets the number of parts of a filler value that is generated at once.
+static int singlePart()
 {
-    // Initialize the SD card
-    AutoSD autoSD;
-    // Avoid multiple view accesses
-    Lock lock(cs);
+    return 1;
+}
 
-    // Check if the temporary history file directory exists
-    if (!SD.exists(TEMP_HISTORY_FILE_DIR))
-    {
-        // Create the temporary history file directory
-        if (!SD.mkdir(TEMP_HISTORY_FILE_DIR))
-        {
-#ifdef DEBUG_HTTP_SERVER
-            Tracef("Failed to create directory %s\n", TEMP_HISTORY_FILE_DIR);
-#endif
-            return false;
-        }
-    }
+/// @brief Filler functions array. The filler index corresponds to the filler indicator index in history.htm file
+const HistoryViewReader::Filler HistoryViewReader::fillers[] =
+{
+    /* 1 */ { alertsParts, fillAlert },
+    /* 2 */ { singlePart, [](Print &out, int part)->bool { return fillEnums(out); } },
+    /* 3 */ { []()->int { return historyControl.Available(); }, fillJS },
+    /* 4 */ { singlePart, [](Print &out, int part)->bool { return fillRecoveryStatusEnum(out, RecoveryStatus::RecoveryFailure); } },
+    /* 5 */ { singlePart, [](Print &out, int part)->bool { return fillRecoveryStatusEnum(out, RecoveryStatus::RecoverySuccess); } },
+    /* 6 */ { singlePart, [](Print &out, int part)->bool { return fillRecoveryStatusEnum(out, RecoveryStatus::OnGoingRecovery); } },
+    /* 7 */ { singlePart, [](Print &out, int part)->bool { return fillRecoverySourceEnum(out, RecoverySource::Auto); } },
+    /* 8 */ { singlePart, [](Print &out, int part)->bool { return fillRecoverySourceEnum(out, RecoverySource::UserInitiated); } },
+    /* 9 */ { singlePart, [](Print &out, int part)->bool { return fillRecoverySourceEnum(out, RecoverySource::Periodic); } },
+};
 
-    // Open the history file for reading
-    SdFile historyFile = SD.open(TEMP_HISTORY_FILE_PATH, FILE_READ);
+#define fillerChar '%'
 
-    if (historyFile && 
-        historyFile.getLastWrite() < t_now && // Handle case where current time wasn't set well
-        historyFile.getLastWrite() > historyControl.getLastUpdate())
-    {
-#ifdef DEBUG_HTTP_SERVER
-        Tracef("Reusing %s\n", TEMP_HISTORY_FILE_PATH);
-#endif
-        // Use the existing history file
-        return FileViewReader::open(buff, buffSize, historyFile);
-    }
+bool HistoryViewReader::open(byte *buff, int buffSize)
+{
+    // The view file is read into a buffer of its own, because the generated view is longer than the view file.
+    templateBuff.reset(new byte[buffSize]);
+    templateOffset = 0;
+    templateLength = 0;
+    endOfTemplate = false;
+    filler = NULL;
+    part = 0;
+    fill = "";
+    fillOffset = 0;
+
+    // Open the reader of the history.htm file
+    return ViewReader::open(buff, buffSize) && templateReader->open(templateBuff.get(), buffSize);
+}
 
-    // If the history file is outdated, or doesn't exist, create a new one
-    if (historyFile)
-        historyFile.close();
+/// @brief Moves the unprocessed bytes to the beginning of the template buffer and reads more of the view file after them.
+/// @return true if more data was read from the view file, false if the end of the file was reached, or the template buffer is full.
+bool HistoryViewReader::readTemplate()
+{
+    if (endOfTemplate)
+        return false;
 
-    historyFile = SD.open(TEMP_HISTORY_FILE_PATH, FILE_WRITE);
-    if (!historyFile)
-    {
-#ifdef DEBUG_HTTP_SERVER
-        Tracef("Failed to create %s\n", TEMP_HISTORY_FILE_PATH);
-#endif
+    templateLength -= templateOffset;
+    memmove(templateBuff.get(), templateBuff.get() + templateOffset, templateLength);
+    templateOffset = 0;
+    if (templateLength == buffSize)
         return false;
-    }
 
-    // Open the base view reader, this will open the history.htm file
-    if (!FileViewReader::open(buff, buffSize))
+    int nBytes = templateReader->read(templateLength);
+    if (nBytes <= 0)
     {
-        // If we couldn't open the base view reader, delete the temporary history file
-        historyFile.close();
-        SD.remove(TEMP_HISTORY_FILE_PATH);
+        endOfTemplate = true;
         return false;
     }
+    templateLength += nBytes;
 
-    // Filler functions array. The filler index corresponds to the filler indicator index in history.htm file
-    fillFile fillers[] = 
-    { 
-        /* 1 */ fillAlerts, 
-        /* 2 */ fillEnums, 
-        /* 3 */ fillJS, 
-        /* 4 */ [](SdFile &file)->bool { return fillRecoveryStatusEnum(file, RecoveryStatus::RecoveryFailure); },
-        /* 5 */ [](SdFile &file)->bool { return fillRecoveryStatusEnum(file, RecoveryStatus::RecoverySuccess); },
-        /* 6 */ [](SdFile &file)->bool { return fillRecoveryStatusEnum(file, RecoveryStatus::OnGoingRecovery); },
-        /* 7 */ [](SdFile &file)->bool { return fillRecoverySourceEnum(file, RecoverySource::Auto); },
-        /* 8 */ [](SdFile &file)->bool { return fillRecoverySourceEnum(file, RecoverySource::UserInitiated); },
-        /* 9 */ [](SdFile &file)->bool { return fillRecoverySourceEnum(file, RecoverySource::Periodic); },
-    };
+    return true;
+}
 
-    int offset = 0;
-    // Read the file contents using the base view reader
-    for (int nBytes = read(offset) + offset; nBytes; nBytes = read(offset) + offset)
+int HistoryViewReader::read(int offset)
+{
+    int nBytes = offset;
+    while (nBytes < buffSize)
     {
-        bool eof = nBytes == offset; // Check if we reached the end of the file
-        const char *pBuff = reinterpret_cast<const char *>(buff);
-        offset = 0;
-        // Find the next filler delimiter and fill
-        for (const char *delim = STRNCHR(pBuff, fillerChar, nBytes); 
-             delim != NULL; 
-             delim = STRNCHR(pBuff, fillerChar, nBytes))
+        // First, read what is left of the current part of the filler value.
+        if (fillOffset < fill.length())
         {
-            size_t delimIndex = delim - pBuff;
-            // Write everything up to the delimiter
-            historyFile.write(pBuff, delimIndex);
-            // Get the filler index
-            size_t fillerIndex = delimIndex + 1;
-            for(; isdigit(pBuff[fillerIndex]) && fillerIndex < nBytes; fillerIndex++);
-
-            if (!eof && nBytes == fillerIndex)
-            {
-                // The filler indicator may span over to the next buffer,
-                // So move the beginning of the filler indicator to the start of the buffer
-                offset = fillerIndex - delimIndex;
-                memcpy(buff, delim, offset);
-                nBytes = 0;
-                // Break the loop to read the next buffer
-                break;
-            }
-            // Skip the filler indicator.
-            nBytes -= fillerIndex;
-            pBuff += fillerIndex;
-            if (fillerIndex == delimIndex + 1)
+            size_t len = std::min<size_t>(fill.length() - fillOffset, buffSize - nBytes);
+            memcpy(buff + nBytes, fill.c_str() + fillOffset, len);
+            fillOffset += len;
+            nBytes += len;
+            continue;
+        }
+
+        if (filler != NULL)
+        {
+            if (part == filler->nParts())
             {
-                // Not a filler
-                historyFile.write(fillerChar);
+                // Done with this filler
+                filler = NULL;
                 continue;
             }
-            // Get the filler index
-            int n = atoi(delim + 1);
-            // Call the appropriate filler function
-            if (!fillers[n - 1](historyFile))
+            // Generate the next part of the filler value
+            fill = "";
+            fillOffset = 0;
+            StringPrint out(fill);
+            if (!filler->fillPart(out, part++))
             {
-                // If the filler function failed, close the history file and remove the temporary file
-                historyFile.close();
-                SD.remove(TEMP_HISTORY_FILE_PATH);
-                return false;
+#ifdef DEBUG_HTTP_SERVER
+                Tracef("Failed to fill history view, filler %d\n", static_cast<int>(filler - fillers) + 1);
+#endif
+                return -1;
             }
+            continue;
         }
-        // Write any remaining bytes to the history file
-        historyFile.write(pBuff, nBytes);
-    }
 
-    // Close the history file and the base view reader
-    historyFile.close();
-    // Close the base view reader
-    close();
+        if (templateOffset == templateLength && !readTemplate())
+            break; // End of view
+
+        const byte *pTemplate = templateBuff.get() + templateOffset;
+        if (*pTemplate != (byte)fillerChar)
+        {
+            // Copy everything up to the next filler indicator
+            size_t len = templateLength - templateOffset;
+            const byte *delim = static_cast<const byte *>(memchr(pTemplate, fillerChar, len));
+            if (delim != NULL)
+                len = delim - pTemplate;
+            len = std::min<size_t>(len, buffSize - nBytes);
+            memcpy(buff + nBytes, pTemplate, len);
+            templateOffset += len;
+            nBytes += len;
+            continue;
+        }
+
+        // Get the filler index
+        int indexLength = 1;
+        int n = 0;
+        for (; templateOffset + indexLength < templateLength && isdigit(pTemplate[indexLength]); indexLength++)
+            n = n * 10 + pTemplate[indexLength] - '0';
+        // The filler indicator may span over to the next buffer
+        if (templateOffset + indexLength == templateLength && readTemplate())
+            continue;
+
+        if (indexLength == 1 || n < 1 || n > static_cast<int>(NELEMS(fillers)))
+        {
+            // Not a filler
+            buff[nBytes++] = (byte)fillerChar;
+            templateOffset++;
+            continue;
+        }
+
+        // Skip the filler indicator and start generating the filler value
+        templateOffset += indexLength;
+        filler = &fillers[n - 1];
+        part = 0;
+    }
 
-    // Reopen the base view reader with the history file object
-    return FileViewReader::open(buff, buffSize, SD.open(TEMP_HISTORY_FILE_PATH, FILE_READ));
+    return nBytes > offset ? nBytes - offset : -1;
 }
@@ -115,11 +115,123 @@ bool HtmlFillerViewReader::open(byte *buff, int buffSize)
 {
     offset = buffSize;
     endOfView = false;
-    return ViewReader::open(buff, buffSize) && viewReader->open(buff, buffSize);
+    if (!expandFillers)
+        return ViewReader::open(buff, buffSize) && viewReader->open(buff, buffSize);
+
+    // When the fillers are expanded, the output may be longer than the view, so the view is read into a buffer of its own.
+    source.reset(new byte[buffSize]);
+    sourceOffset = 0;
+    sourceLength = 0;
+    endOfSource = false;
+    fill = "";
+    fillOffset = 0;
+    skipSpaces = false;
+    return ViewReader::open(buff, buffSize) && viewReader->open(source.get(), buffSize);
+}
+
+/// @brief Moves the unprocessed bytes to the beginning of the source buffer and reads more of the view after them.
+/// @return true if more data was read from the view, false if the end of the view was reached, or the source buffer is full.
+bool HtmlFillerViewReader::readSource()
+{
+    if (endOfSource)
+        return false;
+
+    sourceLength -= sourceOffset;
+    memmove(source.get(), source.get() + sourceOffset, sourceLength);
+    sourceOffset = 0;
+    if (sourceLength == buffSize)
+        return false;
+
+    int nBytes = viewReader->read(sourceLength);
+    if (nBytes <= 0)
+    {
+        endOfSource = true;
+        return false;
+    }
+    sourceLength += nBytes;
+
+    return true;
+}
+
+/// @brief Reads the view while replacing each filler index and the spaces that follow it with the filler value and a single space.
+/// @return The number of bytes read into the buffer, or -1 if there is no more data.
+int HtmlFillerViewReader::expandingRead()
+{
+    int nBytes = 0;
+    while (nBytes < buffSize)
+    {
+        // First, read what is left of the current filler value.
+        if (fillOffset < fill.length())
+        {
+            size_t len = std::min<size_t>(fill.length() - fillOffset, buffSize - nBytes);
+            memcpy(buff + nBytes, fill.c_str() + fillOffset, len);
+            fillOffset += len;
+            nBytes += len;
+            continue;
+        }
+
+        if (sourceOffset == sourceLength && !readSource())
+            break; // End of view
+
+        const byte *pSource = source.get() + sourceOffset;
+        if (skipSpaces)
+        {
+            if (*pSource == (byte)' ')
+            {
+                sourceOffset++;
+                continue;
+            }
+            skipSpaces = false;
+        }
+
+        if (*pSource != (byte)'%')
+        {
+            // Copy everything up to the next '%'
+            size_t len = sourceLength - sourceOffset;
+            const byte *percent = static_cast<const byte *>(memchr(pSource, '%', len));
+            if (percent != NULL)
+                len = percent - pSource;
+            len = std::min<size_t>(len, buffSize - nBytes);
+            memcpy(buff + nBytes, pSource, len);
+            sourceOffset += len;
+            nBytes += len;
+            continue;
+        }
+
+        // Find the end of the filler index
+        int indexLength = 1;
+        for (; sourceOffset + indexLength < sourceLength && isdigit(source[sourceOffset + indexLength]); indexLength++);
+        // The filler index may span beyond the current source buffer
+        if (sourceOffset + indexLength == sourceLength && readSource())
+            continue;
+        int j = sourceOffset + indexLength;
+
+        // A filler index is a '%' followed by a number and a space.
+        if (j == sourceOffset + 1 || j == sourceLength || source[j] != (byte)' ' ||
+            !DoFill(atoi(reinterpret_cast<const char *>(source.get()) + sourceOffset + 1), fill))
+        {
+            // Not a filler, just a '%'
+            fill = "";
+            buff[nBytes++] = (byte)'%';
+            sourceOffset++;
+            continue;
+        }
+
+        // Leave a single space after the filler value and skip the rest of the spaces.
+        fill += ' ';
+        fillOffset = 0;
+        sourceOffset = j;
+        skipSpaces = true;
+    }
+
+    return nBytes == 0 ? -1 : nBytes;
 }
 
 int HtmlFillerViewReader::read()
 {
+    if (expandFillers)
+        return expandingRead();
+
     if (endOfView)
         return -1;
 
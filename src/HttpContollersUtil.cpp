@@ -25,9 +25,11 @@
 #include <HistoryView.h>
 #include <Filesview.h>
 #include <SSEController.h>
+#include <LogStreamController.h>
 #include <FilesController.h>
 #include <RecoveryController.h>
 #include <SystemController.h>
+#include <MetricsController.h>
 #include <DirectFileView.h>
 
 void InitHttpControllers()
@@ -39,9 +41,11 @@ void InitHttpControllers()
     HTTPServer::AddController("/HISTORY", HistoryView::getInstance);
     HTTPServer::AddController("/FILES", FilesView::getInstance);
     HTTPServer::AddController("/API/SSE", SSEController::getInstance);
+    HTTPServer::AddController("/API/LOGS/STREAM", LogStreamController::getInstance);
     HTTPServer::AddController("/API/FILES", FilesController::getInstance);
     HTTPServer::AddController("/API/RECOVERY", RecoveryController::getInstance);
     HTTPServer::AddController("/API/SYSTEM", SystemController::getInstance);
+    HTTPServer::AddController("/API/METRICS", MetricsController::getInstance);
     HTTPServer::getDefaultController = [](const char *resource) -> std::shared_ptr<HttpController>
     {
         return std::make_shared<DirectFileView>(resource);
@@ -17,30 +17,191 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <HttpHeaders.h>
+#include <HttpClientContext.h>
+#include <HTTPServer.h>
+#include <HttpReceiveBuffer.h>
+#include <algorithm>
 #ifdef DEBUG_HTTP_SERVER
 #include <Trace.h>
 #endif
 
+/// @brief HTTP status code descriptions
+static constexpr struct
+{
+    int code;
+    const char *description;
+} codeDescriptions[] =
+{ 
+    {200, "OK"}, 
+    {206, "Partial Content"}, 
+    {302, "Found"}, 
+    {304, "Not modified"}, 
+    {400, "Bad Request"},
+    {403, "Forbidden"},
+    {404, "Not Found"},
+    {416, "Range Not Satisfiable"},
+    {500, "Internal Server Error"},
+    {503, "Service Unavailable"}
+};
+
+/// @brief Content type header values, indexed by CONTENT_TYPE
+static constexpr const char *contentTypeValues[] =
+{
+    "application/octet-stream", // UNKNOWN
+    "application/javascript", // JAVASCRIPT
+    "image/x-icon", // ICON
+    "text/html", // HTML
+    "text/css", // CSS
+    "text/plain", // PLAIN
+    "image/x-jpeg", // JPEG
+    "image/x-png", // PNG
+    "application/vnd.ms-fontobject", // EOT
+    "image/svg+xml", // SVG
+    "font/ttf", // TTF
+    "font/woff", // WOFF
+    "font/woff2", // WOFF2
+    "application/json", // JSON
+    "text/event-stream" // STREAM
+};
+static_assert(NELEMS(contentTypeValues) == static_cast<size_t>(CONTENT_TYPE::STREAM) + 1, "A content type value is missing");
+
+/// @brief Collects the header section of a response in a buffer, so it is sent to the client in as few writes as possible.
+/// On the wired build, every write to the client is an SPI transaction with the W5500 and it may send a TCP segment of its own.
+/// Data that does not fit in the buffer is sent in slices of the buffer size.
+class HeaderSectionWriter
+{
+public:
+    HeaderSectionWriter(EthClient &client) :
+        client(client),
+        length(0),
+        sent(0)
+    {
+    }
+
+    /// @brief Appends data to the buffer, the buffer is sent when it is full.
+    void append(const char *data, size_t size)
+    {
+        while (size > 0)
+        {
+            size_t n = std::min(size, sizeof(buff) - length);
+            memcpy(buff + length, data, n);
+            length += n;
+            data += n;
+            size -= n;
+            if (length == sizeof(buff))
+                flush();
+        }
+    }
+
+    void append(const char *str) { append(str, strlen(str)); }
+    void append(const String &str) { append(str.c_str(), str.length()); }
+
+    /// @brief Appends a header line.
+    void appendHeader(const char *name, const char *value)
+    {
+        // Do not send empty header names
+        if (*name == '\0')
+            return;
+        append(name);
+        append(": ", 2);
+        append(value);
+        append("\r\n", 2);
+    }
+
+    /// @brief Sends the content of the buffer to the client.
+    void flush()
+    {
+        if (length > 0)
+            client.write(reinterpret_cast<const uint8_t *>(buff), length);
+        sent += length;
+        length = 0;
+    }
+
+    /// @brief Returns the number of bytes that were sent to the client.
+    size_t getSent() const { return sent; }
+
+private:
+    EthClient &client;
+    char buff[HTTP_HEADER_SECTION_BUFF_SIZE];
+    size_t length;
+    size_t sent;
+};
+
+HttpHeaders::HttpHeaders(HttpClientContext &context) :
+    client(context.getClient()),
+    context(&context),
+    receiveTimeout(DEFAULT_RECEIVE_TIMEOUT),
+    persistent(context.isPersistent()),
+    remainingRequests(context.getRemainingRequests())
+{
+}
+
+const char *HttpHeaders::getCodeDescription(int code)
+{
+    for (size_t i = 0; i < NELEMS(codeDescriptions); i++)
+        if (codeDescriptions[i].code == code)
+            return codeDescriptions[i].description;
+
+    return "";
+}
+
+const char *HttpHeaders::getContentTypeValue(CONTENT_TYPE contentType)
+{
+    return contentTypeValues[static_cast<size_t>(contentType)];
+}
+
 void HttpHeaders::sendHeaderSection(int code, bool includeDefaultHeaders, Header headers[], size_t nHeaders, int length)
 {
-    // Send the HTTP status line
-    client.printf("HTTP/1.1 %d %s\n", code, codeDescriptions.at(code).c_str());
-    // Send the default headers
+    sendResponse(code, includeDefaultHeaders, headers, nHeaders, length, NULL, 0);
+}
+
+void HttpHeaders::sendResponse(int code, Header headers[], size_t nHeaders, const String &body)
+{
+    sendResponse(code, true, headers, nHeaders, body.length(), body.c_str(), body.length());
+}
+
+void HttpHeaders::sendResponse(int code, bool includeDefaultHeaders, Header headers[], size_t nHeaders, int length, const char *body, size_t bodySize)
+{
+    // The header section is assembled in a buffer and sent in a single write
+    HeaderSectionWriter writer(client);
+    char line[64];
+
+    // The HTTP status line
+    snprintf(line, sizeof(line), "HTTP/1.1 %d %s\r\n", code, getCodeDescription(code));
+    writer.append(line);
+    // The default headers
     if (includeDefaultHeaders)
     {
-        sendHeader("Connection", "close");
-        sendHeader("Server", "Arduino");
-        sendHeader("Content-Length", String(length));
+        if (persistent)
+        {
+            writer.appendHeader("Connection", "keep-alive");
+            snprintf(line, sizeof(line), "timeout=%d, max=%d", HTTP_KEEP_ALIVE_TIMEOUT / 1000, remainingRequests);
+            writer.appendHeader("Keep-Alive", line);
+        }
+        else
+            writer.appendHeader("Connection", "close");
+        writer.appendHeader("Server", "Arduino");
+        if (length >= 0)
+        {
+            snprintf(line, sizeof(line), "%d", length);
+            writer.appendHeader("Content-Length", line);
+        }
     }
-    // Send custom headers
+    // Custom headers
     if (headers)
         for (size_t i = 0; i < nHeaders; i++)
-            sendHeader(headers[i]);
+            writer.appendHeader(headers[i].name.c_str(), headers[i].value.c_str());
     // End of headers
-    client.println();
+    writer.append("\r\n", 2);
+    // A small body goes out together with the header section
+    if (body)
+        writer.append(body, bodySize);
+    writer.flush();
     #ifdef USE_WIFI
         client.flush();
     #endif
+    if (context != NULL)
+        context->onResponseSent(writer.getSent());
 }
 
 void HttpHeaders::sendStreamHeaderSection()
@@ -57,7 +218,7 @@ void HttpHeaders::sendHeader(const String &name, const String &value)
         return;
 
     // Send the header
-    client.printf("%s: %s\n", name.c_str(), value.c_str());
+    client.printf("%s: %s\r\n", name.c_str(), value.c_str());
 }
 
 void HttpHeaders::sendHeader(const Header &header)
@@ -65,145 +226,163 @@ void HttpHeaders::sendHeader(const Header &header)
     sendHeader(header.name, header.value);
 }
 
-bool HttpHeaders::parseRequestHeaderSection(HTTP_REQ_TYPE &requestType, String &resource, Header collectedHeaders[], size_t nCollectedHeaders)
+/// @brief HTTP request types
+const HttpHeaders::HttpReqType HttpHeaders::httpReqTypes[] =
+{
+    {"GET", HTTP_REQ_TYPE::HTTP_GET}, 
+    {"POST", HTTP_REQ_TYPE::HTTP_POST}, 
+    {"PUT", HTTP_REQ_TYPE::HTTP_PUT},
+    {"DELETE", HTTP_REQ_TYPE::HTTP_DELETE}
+};
+
+/// @brief Finds a header in the collected headers.
+/// @param name The name of the header, it is not necessarily null terminated.
+/// @param nameLength The length of the name.
+/// @return The index of the header in collectedHeaders, or -1 if the header is not collected.
+static int findCollectedHeader(const char *name, size_t nameLength, HttpHeaders::Header collectedHeaders[], size_t nCollectedHeaders)
+{
+    // Header names are case insensitive
+    for (size_t i = 0; i < nCollectedHeaders; i++)
+        if (collectedHeaders[i].name.length() == nameLength && strncasecmp(collectedHeaders[i].name.c_str(), name, nameLength) == 0)
+            return i;
+
+    return -1;
+}
+
+bool HttpHeaders::parseRequestLine(char *line, HTTP_REQ_TYPE &requestType, String &resource)
+{
+#ifdef DEBUG_HTTP_SERVER
+    requestLine = line;
+#endif
+    // The request line is "<method> <resource> <version>", it is split in place.
+    char *space = strchr(line, ' ');
+    if (space == NULL)
+        return false;
+    *space = '\0';
+    char *secondSpace = strchr(space + 1, ' ');
+    if (secondSpace == NULL)
+        // Resource not found
+        return false;
+    *secondSpace = '\0';
+
+    // Find the HTTP request type
+    for (size_t i = 0; i < NELEMS(httpReqTypes); i++)
+        if (strcmp(line, httpReqTypes[i].method) == 0)
+            requestType = httpReqTypes[i].requestType;
+    if (requestType == HTTP_REQ_TYPE::HTTP_UNKNOWN)
+        // Unknown HTTP request type
+        return false;
+
+    resource = space + 1;
+    httpVersion = secondSpace + 1;
+
+    return true;
+}
+
+bool HttpHeaders::parseRequestHeaderSection(HttpReceiveBuffer &receiveBuffer, HTTP_REQ_TYPE &requestType, String &resource, Header collectedHeaders[], size_t nCollectedHeaders)
 {
     requestType = HTTP_REQ_TYPE::HTTP_UNKNOWN;
     parsedLine = "";
     requestLine = "";
+    httpVersion = "";
 
-    // Create a map of header names to their indexes in the collectedHeaders array
-    typedef std::map<String, int> HeaderNameIndexes;
-    HeaderNameIndexes headerNamesIndexes;
-    if (collectedHeaders != NULL)
-        for (size_t i = 0; i < nCollectedHeaders; i++)
-            headerNamesIndexes.insert(std::pair<String, int>(collectedHeaders[i].name, i));
-    
+    // Indicates that the rest of a line that is longer than the receive buffer is skipped
+    bool skipping = false;
     unsigned long t0 = millis();
 
     do
     {
-        if (!client)
+        char *line = receiveBuffer.data();
+        size_t size = receiveBuffer.size();
+        char *endOfLine = static_cast<char *>(memchr(line, '\n', size));
+
+        if (endOfLine == NULL)
         {
-            // Client got disconnected
+            // The line was not entirely received yet
+            if (skipping)
+                receiveBuffer.consume(size);
+            else if (receiveBuffer.isFull())
+            {
+                // The line is too long to fit in the buffer.
+                // Only a header that is not collected can be skipped.
+                const char *colon = static_cast<const char *>(memchr(line, ':', size));
+                if (requestType == HTTP_REQ_TYPE::HTTP_UNKNOWN ||
+                    colon == NULL ||
+                    findCollectedHeader(line, colon - line, collectedHeaders, nCollectedHeaders) != -1)
+                {
 #ifdef DEBUG_HTTP_SERVER
-            Tracef("%d Received incomplete request!\n", client.remotePort());
+                    Tracef("%d Request line is too long!\n", client.remotePort());
 #endif
-            return false;
-        }
-        if (!client.available()) 
-        {
-            // Wait for data to become available, break if timeout
-            if (millis() - t0 >= receiveTimeout)
+                    return false;
+                }
+                skipping = true;
+                receiveBuffer.consume(size);
+            }
+
+            // Wait for more data
+            unsigned long elapsed = millis() - t0;
+            if (elapsed >= receiveTimeout || !receiveBuffer.receive(receiveTimeout - elapsed))
             {
 #ifdef DEBUG_HTTP_SERVER
-                Tracef("%d Receive timeout!\n", client.remotePort());
+                Tracef("%d Received incomplete request!\n", client.remotePort());
 #endif
                 return false;
             }
-            delay(10);
             continue;
         }
 
-        // Read the next character
-        char c = client.read();
-
-        // Ignore carriage return characters
-        if (c == '\r')
+        // We have here the entire line from the request.
+        // The line is consumed, but it stays in place until more data is received, so it can be parsed in place.
+        size_t lineLength = endOfLine - line;
+        receiveBuffer.consume(lineLength + 1);
+        if (skipping)
+        {
+            skipping = false;
             continue;
+        }
+        // Ignore the carriage return at the end of the line
+        if (lineLength > 0 && line[lineLength - 1] == '\r')
+            lineLength--;
+        line[lineLength] = '\0';
+#ifdef DEBUG_HTTP_SERVER
+        parsedLine = line;
+#endif
 
-        if (c != '\n')
+        if (lineLength == 0)
         {
-            // Append the character to the parsed line
-            parsedLine += c;
+            // The empty line ends the header section.
+            // Empty lines before the request line are ignored.
+            if (requestType != HTTP_REQ_TYPE::HTTP_UNKNOWN)
+                return true;
             continue;
         }
 
-        // We have here the entire line from the request
-        if (parsedLine.isEmpty())
-            return true;
-
         if (requestType == HTTP_REQ_TYPE::HTTP_UNKNOWN)
         {
             // The request type is found in the request status line.
             // If requestType is unknown, it means we are dealing with the request status line.
-            requestLine = parsedLine;
-            // Extract the request method
-            int space = parsedLine.indexOf(' ');
-            if (space == -1)
+            if (!parseRequestLine(line, requestType, resource))
                 return false;
+            continue;
+        }
 
-            // Find the HTTP request type
-            HttpReqTypesMap::const_iterator httpReqType = httpReqTypesMap.find(parsedLine.substring(0, space));
-            if (httpReqType == httpReqTypesMap.end())
-                // Unknown HTTP request type
-                return false;
+        // Parse headers
+        char *colon = strchr(line, ':');
+        if (colon == NULL)
+            // Invalid header format
+            return false;
 
-            // Store the request type
-            requestType = httpReqType->second;
-            // Extract the resource
-            int secondSpace = parsedLine.indexOf(' ', space + 1);
-            if (secondSpace == -1)
-                // Resource not found
-                return false;
-            resource = parsedLine.substring(space + 1, secondSpace);
-        }
-        else
+        // If the header is in the collectedHeaders array, store its value
+        int headerIndex = findCollectedHeader(line, colon - line, collectedHeaders, nCollectedHeaders);
+        if (headerIndex != -1)
         {
-            // Parse headers
-            int delimiter = parsedLine.indexOf(": ");
-            if (delimiter == -1)
-                // Invalid header format
-                return false;
-
-            // Extract the header name
-            String headerName = parsedLine.substring(0, delimiter);
-            // If the header is in the collectedHeaders array, store its value
-            HeaderNameIndexes::const_iterator headerIndex = headerNamesIndexes.find(headerName);
-            if (headerIndex != headerNamesIndexes.end())
-                collectedHeaders[headerIndex->second].value = parsedLine.substring(delimiter + 2);
+            // Trim the white space around the value
+            char *value = colon + 1;
+            while (*value == ' ' || *value == '\t')
+                value++;
+            for (char *end = line + lineLength; end > value && (end[-1] == ' ' || end[-1] == '\t'); end--)
+                end[-1] = '\0';
+            collectedHeaders[headerIndex].value = value;
         }
-        // Clear the parsed line for the next iteration
-        parsedLine = "";
     } while(true);
 }
-
-/// @brief HTTP status code descriptions
-const std::map<int, String> HttpHeaders::codeDescriptions = 
-{ 
-    {200, "OK"}, 
-    {302, "Found"}, 
-    {304, "Not modified"}, 
-    {400, "Bad Request"},
-    {403, "Forbidden"},
-    {404, "Not Found"},
-    {500, "Internal Server Error"}
-};
-
-/// @brief Content type header value
-const std::map<CONTENT_TYPE, String> HttpHeaders::contentTypeValues =
-{
-    {CONTENT_TYPE::JAVASCRIPT, "application/javascript"},
-    {CONTENT_TYPE::ICON, "image/x-icon"},
-    {CONTENT_TYPE::HTML, "text/html"},
-    {CONTENT_TYPE::CSS, "text/css"},
-    {CONTENT_TYPE::PLAIN, "text/plain"},
-    {CONTENT_TYPE::JPEG, "image/x-jpeg"},
-    {CONTENT_TYPE::PNG, "image/x-png"},
-    {CONTENT_TYPE::EOT, "application/vnd.ms-fontobject"},
-    {CONTENT_TYPE::SVG, "image/svg+xml"},
-    {CONTENT_TYPE::TTF, "font/ttf"},
-    {CONTENT_TYPE::WOFF, "font/woff"},
-    {CONTENT_TYPE::WOFF2, "font/woff2"},
-    {CONTENT_TYPE::JSON, "application/json"},
-    {CONTENT_TYPE::STREAM, "text/event-stream"}
-};
-
-/// @brief HTTP request types
-const HttpHeaders::HttpReqTypesMap HttpHeaders::httpReqTypesMap = 
-{
-    {"GET", HTTP_REQ_TYPE::HTTP_GET}, 
-    {"POST", HTTP_REQ_TYPE::HTTP_POST}, 
-    {"PUT", HTTP_REQ_TYPE::HTTP_PUT},
-    {"DELETE", HTTP_REQ_TYPE::HTTP_DELETE}
-};
-
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <HttpMetrics.h>
+
+CriticalSection HttpMetrics::cs;
+HttpMetrics::Routes HttpMetrics::routes;
+unsigned long HttpMetrics::startTime = 0;
+
+// 1ms, 2ms, 5ms, ... 2s
+const uint32_t HttpMetrics::bucketBounds[HTTP_METRICS_N_BUCKETS - 1] =
+{
+    1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000
+};
+
+void HttpMetrics::addSample(Histogram &histogram, uint32_t value)
+{
+    histogram.count++;
+    histogram.sum += value;
+    if (value > histogram.max)
+        histogram.max = value;
+
+    size_t bucket = 0;
+    while (bucket < HTTP_METRICS_N_BUCKETS - 1 && value >= bucketBounds[bucket])
+        bucket++;
+    histogram.buckets[bucket]++;
+}
+
+void HttpMetrics::record(const String &route, const Sample &sample)
+{
+    Lock lock(cs);
+
+    Routes::iterator it = routes.find(route);
+    if (it == routes.end())
+    {
+        // The number of routes is bounded, so the metrics do not eat up the memory
+        // when clients request many different resources.
+        const String &key = routes.size() < HTTP_METRICS_MAX_ROUTES ? route : HTTP_METRICS_OTHER_ROUTE;
+        // The metrics of a new route are zero initialized
+        it = routes.insert(std::make_pair(key, RouteMetrics())).first;
+    }
+
+    RouteMetrics &metrics = it->second;
+    metrics.requests++;
+    if (!sample.succeeded)
+        metrics.failures++;
+    metrics.bytesSent += sample.bytesSent;
+    addSample(metrics.parse, sample.parseTime);
+    if (sample.firstByteTime > 0)
+        addSample(metrics.firstByte, sample.firstByteTime);
+    addSample(metrics.total, sample.totalTime);
+}
+
+unsigned long HttpMetrics::getRoutes(Routes &routes)
+{
+    Lock lock(cs);
+
+    routes = HttpMetrics::routes;
+    return millis() - startTime;
+}
+
+void HttpMetrics::reset()
+{
+    Lock lock(cs);
+
+    routes.clear();
+    startTime = millis();
+}
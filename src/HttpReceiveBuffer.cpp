@@ -0,0 +1,73 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <HttpReceiveBuffer.h>
+#include <algorithm>
+
+int HttpReceiveBuffer::available()
+{
+    // Avoid accessing the client if there is buffered data
+    return size() > 0 ? size() : client.available();
+}
+
+int HttpReceiveBuffer::read()
+{
+    if (size() > 0)
+        return static_cast<uint8_t>(buff[offset++]);
+
+    return client.read();
+}
+
+int HttpReceiveBuffer::read(uint8_t *buf, size_t size)
+{
+    size_t buffered = std::min(size, this->size());
+    if (buffered == 0)
+        return client.read(buf, size);
+
+    memcpy(buf, buff + offset, buffered);
+    offset += buffered;
+    return buffered;
+}
+
+bool HttpReceiveBuffer::receive(unsigned long timeout)
+{
+    // Move the data that was not consumed yet to the beginning of the buffer, to make room for more data
+    if (offset > 0)
+    {
+        memmove(buff, buff + offset, size());
+        length -= offset;
+        offset = 0;
+    }
+    if (length == sizeof(buff))
+        return false;
+
+    unsigned long t0 = millis();
+    while (true)
+    {
+        // Read whatever the client has sent in a single read
+        int n = client.read(reinterpret_cast<uint8_t *>(buff + length), sizeof(buff) - length);
+        if (n > 0)
+        {
+            length += n;
+            return true;
+        }
+        if (!client.connected() || millis() - t0 >= timeout)
+            return false;
+        delay(1);
+    }
+}
@@ -25,17 +25,17 @@
 #include <TimeUtil.h>
 #include <Config.h>
 #include <HttpHeaders.h>
-#include <HttpHeaders.h>
+#include <EmbeddedAssets.h>
 
 using namespace historycontrol;
 
-extern const uint8_t _binary_sd_wwwroot_index_htm_start[];
-extern const uint8_t _binary_sd_wwwroot_index_htm_end[];
+// The index page is always embedded in the firmware
+static const EmbeddedAsset *const indexHtm = EmbeddedAssets::find("/INDEX.HTM");
   
 IndexView::IndexView() : 
    HtmlFillerView(
-    _binary_sd_wwwroot_index_htm_start, 
-    _binary_sd_wwwroot_index_htm_end - _binary_sd_wwwroot_index_htm_start, 
+    indexHtm->data, 
+    indexHtm->size, 
     CONTENT_TYPE::HTML, 
     getFillers)
 {
@@ -66,13 +66,13 @@ int IndexView::getFillers(const ViewFiller *&_fillers)
 
 std::atomic<int> IndexView::id(0);
 
-bool IndexView::redirect(EthClient &client, const String &_id)
+bool IndexView::redirect(HttpClientContext &context, const String &_id)
 {
     if (_id.equals("") || !sseController.IsValidId(_id))
     {
         // If the ID is empty or not valid, generate a new ID and respond with a redirect to the index page with the new ID.
         HttpHeaders::Header additionalHeaders[] = {{"Location", String("/index/") + ++id}};
-        HttpHeaders headers(client);
+        HttpHeaders headers(context);
         headers.sendHeaderSection(302, true, additionalHeaders, NELEMS(additionalHeaders));
 
         // Add the client to the SSE controller with a new ID. This is required so that the SSE controller 
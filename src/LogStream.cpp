@@ -0,0 +1,293 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <Common.h>
+#include <LogStream.h>
+
+/// @brief The levels of the log by their letters and names, for the filters.
+static const struct
+{
+    const char *name;
+    LogLevel level;
+} levelNames[] =
+{
+    {"ERROR", LogLevel::Error},
+    {"WARN", LogLevel::Warning},
+    {"WARNING", LogLevel::Warning},
+    {"INFO", LogLevel::Info},
+    {"DEBUG", LogLevel::Debug},
+    {"VERBOSE", LogLevel::Verbose},
+};
+
+/// @brief Returns the level of a level letter of the ESP logs.
+/// @param c The letter.
+/// @param level Returns the level.
+/// @return false if c is not a level letter.
+static bool getLevelByLetter(char c, LogLevel &level)
+{
+    switch (c)
+    {
+        case 'E': level = LogLevel::Error; return true;
+        case 'W': level = LogLevel::Warning; return true;
+        case 'I': level = LogLevel::Info; return true;
+        case 'D': level = LogLevel::Debug; return true;
+        case 'V': level = LogLevel::Verbose; return true;
+        default: return false;
+    }
+}
+
+/// @brief Sets a filter by a single segment of its path.
+/// @param filter The filter.
+/// @param segment The segment, a level or a category.
+/// @param hasCategory true once a category was set, the first one replaces the default of all the categories.
+/// @return false if the segment is not a level or a category.
+static bool parseSegment(LogFilter &filter, const String &segment, bool &hasCategory)
+{
+    if (segment.length() == 1 && getLevelByLetter(toupper(segment[0]), filter.maxLevel))
+        return true;
+    for (size_t i = 0; i < NELEMS(levelNames); i++)
+    {
+        if (segment.equalsIgnoreCase(levelNames[i].name))
+        {
+            filter.maxLevel = levelNames[i].level;
+            return true;
+        }
+    }
+
+    uint8_t category;
+    if (segment.equalsIgnoreCase("APP"))
+        category = 1 << static_cast<int>(LogCategory::App);
+    else if (segment.equalsIgnoreCase("ESP"))
+        category = 1 << static_cast<int>(LogCategory::Esp);
+    else if (segment.equalsIgnoreCase("ALL"))
+        category = (1 << static_cast<int>(LogCategory::COUNT)) - 1;
+    else
+        return false;
+    filter.categories = hasCategory ? filter.categories | category : category;
+    hasCategory = true;
+
+    return true;
+}
+
+bool LogFilter::parse(const String &spec)
+{
+    *this = LogFilter();
+    bool hasCategory = false;
+    int start = 0;
+    while (start < (int)spec.length())
+    {
+        int end = spec.indexOf('/', start);
+        if (end < 0)
+            end = spec.length();
+        // Empty segments, e.g. of a trailing '/', are ignored
+        if (end > start && !parseSegment(*this, spec.substring(start, end), hasCategory))
+            return false;
+        start = end + 1;
+    }
+
+    return true;
+}
+
+LogStream::LogStream() :
+    nSubscribers(0),
+    lineLen(0),
+    inEscape(false)
+{
+    for (int i = 0; i < LOG_STREAM_MAX_SUBSCRIBERS; i++)
+        subscribers[i].active = false;
+}
+
+void LogStream::publish(const char *message)
+{
+    Lock lock(cs);
+
+    // Nobody tails the log, there is no need to gather the lines.
+    // The next subscriber starts with the next line.
+    if (nSubscribers == 0)
+    {
+        const char *lastNewLine = strrchr(message, '\n');
+        if (lastNewLine != NULL)
+        {
+            lineLen = 0;
+            inEscape = false;
+            message = lastNewLine + 1;
+        }
+    }
+
+    for (const char *p = message; *p != '\0'; p++)
+    {
+        char c = *p;
+        if (c == '\n')
+        {
+            if (nSubscribers > 0)
+                dispatchLine();
+            lineLen = 0;
+            inEscape = false;
+        }
+        // The ESP logs may be colored, the escape sequences of the colors, e.g. "\033[0;31m", are removed.
+        else if (c == '\033')
+            inEscape = true;
+        else if (inEscape)
+            inEscape = c != 'm';
+        // The rest of a line that is too long is dropped
+        else if (c != '\r' && lineLen < sizeof(line) - 1)
+            line[lineLen++] = c;
+    }
+}
+
+void LogStream::dispatchLine()
+{
+    line[lineLen] = '\0';
+    LogLevel level;
+    LogCategory category;
+    classify(line, level, category);
+
+    for (int i = 0; i < LOG_STREAM_MAX_SUBSCRIBERS; i++)
+    {
+        Subscriber &subscriber = subscribers[i];
+        if (subscriber.active && subscriber.filter.matches(level, category))
+            queueLine(subscriber);
+    }
+}
+
+void LogStream::queueLine(Subscriber &subscriber)
+{
+    // Tell the subscriber about the lines it lost before it is sent the next one, so it knows where the gap is.
+    if (subscriber.dropped > 0)
+    {
+        char notice[40];
+        size_t len = snprintf(notice, sizeof(notice), "event: dropped\ndata: %u\n\n", (unsigned)subscriber.dropped);
+        if (!queue(subscriber, notice, len))
+        {
+            subscriber.dropped++;
+            return;
+        }
+        subscriber.dropped = 0;
+    }
+
+    // An event is queued whole or not at all, so the subscriber never receives a part of an event.
+    if (subscriber.count + lineLen + 7 > LOG_STREAM_BUFF_SIZE)
+    {
+        subscriber.dropped++;
+        return;
+    }
+    queue(subscriber, "data:", 5);
+    queue(subscriber, line, lineLen);
+    queue(subscriber, "\n\n", 2);
+}
+
+bool LogStream::queue(Subscriber &subscriber, const char *event, size_t size)
+{
+    if (subscriber.count + size > LOG_STREAM_BUFF_SIZE)
+        return false;
+
+    // The event may wrap around the end of the ring
+    size_t tail = (subscriber.head + subscriber.count) % LOG_STREAM_BUFF_SIZE;
+    size_t first = std::min<size_t>(size, LOG_STREAM_BUFF_SIZE - tail);
+    memcpy(subscriber.buff + tail, event, first);
+    memcpy(subscriber.buff, event + first, size - first);
+    subscriber.count += size;
+
+    return true;
+}
+
+int LogStream::subscribe(const LogFilter &filter)
+{
+    Lock lock(cs);
+
+    for (int i = 0; i < LOG_STREAM_MAX_SUBSCRIBERS; i++)
+    {
+        Subscriber &subscriber = subscribers[i];
+        if (!subscriber.active)
+        {
+            subscriber.active = true;
+            subscriber.filter = filter;
+            subscriber.head = 0;
+            subscriber.count = 0;
+            subscriber.dropped = 0;
+            nSubscribers++;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void LogStream::unsubscribe(int subscriber)
+{
+    Lock lock(cs);
+
+    if (subscriber >= 0 && subscriber < LOG_STREAM_MAX_SUBSCRIBERS && subscribers[subscriber].active)
+    {
+        subscribers[subscriber].active = false;
+        nSubscribers--;
+    }
+}
+
+size_t LogStream::peek(int subscriber, char *buff, size_t size)
+{
+    Lock lock(cs);
+
+    if (subscriber < 0 || subscriber >= LOG_STREAM_MAX_SUBSCRIBERS || !subscribers[subscriber].active)
+        return 0;
+    Subscriber &s = subscribers[subscriber];
+    size = std::min<size_t>(size, s.count);
+    size_t first = std::min<size_t>(size, LOG_STREAM_BUFF_SIZE - s.head);
+    memcpy(buff, s.buff + s.head, first);
+    memcpy(buff + first, s.buff, size - first);
+
+    return size;
+}
+
+void LogStream::consume(int subscriber, size_t size)
+{
+    Lock lock(cs);
+
+    if (subscriber < 0 || subscriber >= LOG_STREAM_MAX_SUBSCRIBERS || !subscribers[subscriber].active)
+        return;
+    Subscriber &s = subscribers[subscriber];
+    size = std::min<size_t>(size, s.count);
+    s.head = (s.head + size) % LOG_STREAM_BUFF_SIZE;
+    s.count -= size;
+}
+
+void LogStream::classify(const char *line, LogLevel &level, LogCategory &category)
+{
+    // ESP-IDF: "W (1234) tag: message"
+    if (line[0] != '\0' && line[1] == ' ' && line[2] == '(' && getLevelByLetter(line[0], level))
+    {
+        category = LogCategory::Esp;
+        return;
+    }
+    // Arduino core: "[  1234][W][file.cpp:42] function(): message"
+    if (line[0] == '[')
+    {
+        const char *end = strchr(line, ']');
+        if (end != NULL && end[1] == '[' && end[2] != '\0' && end[3] == ']' && getLevelByLetter(end[2], level))
+        {
+            category = LogCategory::Esp;
+            return;
+        }
+    }
+
+    level = LogLevel::Info;
+    category = LogCategory::App;
+}
+
+/// Global instance of the LogStream.
+LogStream logStream;
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <Common.h>
+#include <LogStreamController.h>
+#include <HTTPServer.h>
+#include <HttpHeaders.h>
+#include <SocketBudget.h>
+#include <EthernetUtil.h>
+#ifdef DEBUG_HTTP_SERVER
+#include <Trace.h>
+#endif
+
+/// @brief The size of the buffer that the queued lines are sent from.
+#define LOG_STREAM_SEND_BUFF_SIZE 512
+
+LogStreamController::LogStreamController()
+{
+    for (int i = 0; i < LOG_STREAM_MAX_SUBSCRIBERS; i++)
+        clients[i].subscriber = -1;
+}
+
+bool LogStreamController::Get(HttpClientContext &context, const String id)
+{
+    EthClient client = context.getClient();
+
+    LogFilter filter;
+    if (!filter.parse(id))
+        return false;
+
+    int subscriber = logStream.subscribe(filter);
+    if (subscriber < 0)
+    {
+        // Every slot is taken, the browser may try again later.
+        // The connection is closed before the headers are made, so they do not offer to keep it alive.
+        HttpHeaders::Header additionalHeaders[] = { {"Retry-After", String(HTTP_RETRY_AFTER)} };
+        context.closeAfterResponse();
+        HttpHeaders headers(context);
+        headers.sendHeaderSection(503, true, additionalHeaders, NELEMS(additionalHeaders));
+        return true;
+    }
+
+    // The connection now holds the socket of a stream. The streams of the log share the budget with the streams of the state,
+    // and if there are too many streams, the oldest one of all is closed.
+    context.setSocketClass(SocketClass::SSE);
+    HttpHeaders httpHeaders(client);
+    httpHeaders.sendStreamHeaderSection();
+    {
+        Lock lock(csClients);
+        StreamClient &streamClient = clients[subscriber];
+        streamClient.client = client;
+        streamClient.subscriber = subscriber;
+        streamClient.lastSentTime = millis();
+        streamClient.openedTime = millis();
+    }
+    // Set the keep-alive flag to true to keep the connection open for the stream.
+    context.keepAlive = true;
+
+#ifdef DEBUG_HTTP_SERVER
+    Tracef("%d Log stream opened, filter=\"%s\"\n", client.remotePort(), id.c_str());
+#endif
+
+    return true;
+}
+
+bool LogStreamController::SendLines(StreamClient &streamClient)
+{
+    // Nothing is traced here, the traces would be streamed back to the clients.
+    EthClient client = streamClient.client;
+    if (!client.connected())
+        return false;
+
+    while (true)
+    {
+        // The lines are left in the log stream until they are written, so a client that has no room for
+        // a whole line receives the rest of it the next time.
+        char buff[LOG_STREAM_SEND_BUFF_SIZE];
+        size_t room = GetRoomForWrite(client, sizeof(buff));
+        if (room == 0)
+            return true;
+        size_t size = logStream.peek(streamClient.subscriber, buff, room);
+        if (size == 0)
+            break;
+        size_t written = client.write(reinterpret_cast<const uint8_t *>(buff), size);
+        if (written == 0)
+            return false;
+        logStream.consume(streamClient.subscriber, written);
+        streamClient.lastSentTime = millis();
+        if (written < size)
+            return true;
+    }
+
+    // A client that is sent no lines is sent a comment, which the browser ignores.
+    // The queue is empty at this point, so the comment does not break into an event.
+    if (millis() - streamClient.lastSentTime >= LOG_STREAM_HEARTBEAT_INTERVAL && GetRoomForWrite(client, 3) == 3)
+    {
+        if (client.write(reinterpret_cast<const uint8_t *>(":\n\n"), 3) == 0)
+            return false;
+        streamClient.lastSentTime = millis();
+    }
+#ifdef USE_WIFI
+    client.flush();
+#endif
+
+    return true;
+}
+
+void LogStreamController::SendToClients()
+{
+    Lock lock(csClients);
+
+    for (int i = 0; i < LOG_STREAM_MAX_SUBSCRIBERS; i++)
+    {
+        StreamClient &streamClient = clients[i];
+        if (streamClient.subscriber >= 0 && !SendLines(streamClient))
+            CloseStream(streamClient);
+    }
+}
+
+void LogStreamController::CloseStream(StreamClient &streamClient)
+{
+#ifdef DEBUG_HTTP_SERVER
+    uint16_t port = streamClient.client.remotePort();
+#endif
+    logStream.unsubscribe(streamClient.subscriber);
+    streamClient.subscriber = -1;
+    streamClient.client.stop();
+    streamClient.client = EthClient();
+    // The socket of the stream is returned to the socket budget right away.
+    SocketBudget::release(SocketClass::SSE);
+#ifdef DEBUG_HTTP_SERVER
+    Tracef("%d Log stream closed\n", port);
+#endif
+}
+
+int LogStreamController::FindOldestStream()
+{
+    int oldest = -1;
+    unsigned long now = millis();
+    for (int i = 0; i < LOG_STREAM_MAX_SUBSCRIBERS; i++)
+    {
+        if (clients[i].subscriber >= 0 && (oldest == -1 || now - clients[i].openedTime > now - clients[oldest].openedTime))
+            oldest = i;
+    }
+
+    return oldest;
+}
+
+bool LogStreamController::GetOldestStreamAge(unsigned long &age)
+{
+    Lock lock(csClients);
+    int oldest = FindOldestStream();
+    if (oldest < 0)
+        return false;
+    age = millis() - clients[oldest].openedTime;
+
+    return true;
+}
+
+bool LogStreamController::EvictOldestStream()
+{
+    Lock lock(csClients);
+    int oldest = FindOldestStream();
+    if (oldest < 0)
+        return false;
+#ifdef DEBUG_HTTP_SERVER
+    Traceln("Evicting the oldest log stream");
+#endif
+    CloseStream(clients[oldest]);
+
+    return true;
+}
+
+void LogStreamController::Init()
+{
+    // Let the socket budget close the oldest stream when it needs room for other sockets.
+    SocketBudget::addSSEEvictor([](void *context)
+    {
+        return static_cast<LogStreamController *>(context)->EvictOldestStream();
+    },
+    [](void *context, unsigned long &age)
+    {
+        return static_cast<LogStreamController *>(context)->GetOldestStreamAge(age);
+    }, this);
+    // Start the task that sends the lines to the clients, so the traces do not wait for the clients.
+    xTaskCreate([](void *param)
+    {
+        LogStreamController *controller = static_cast<LogStreamController *>(param);
+
+        while (true)
+        {
+            delay(LOG_STREAM_SEND_INTERVAL);
+            controller->SendToClients();
+        }
+    },
+    "LogStreamSender",
+    4 * 1024,
+    this,
+    tskIDLE_PRIORITY + 1,
+    NULL);
+}
+
+/// @brief Pointer to the global LogStreamController instance.
+static std::shared_ptr<LogStreamController> pLogStreamController = std::make_shared<LogStreamController>();
+
+/// This method returns a pointer to the global LogStreamController instance.
+std::shared_ptr<HttpController> LogStreamController::getInstance() { return pLogStreamController; }
+
+/// Global instance of the LogStreamController.
+LogStreamController &logStreamController = *pLogStreamController;
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <MetricsController.h>
+#include <HTTPServer.h>
+#include <HttpHeaders.h>
+#ifdef DEBUG_HTTP_SERVER
+#include <Trace.h>
+#endif
+
+/// @brief Common headers of the responses of the controller. The metrics must never be cached.
+static HttpHeaders::Header commonHeaders[] = { {CONTENT_TYPE::JSON}, {"Access-Control-Allow-Origin", "*"}, {"Cache-Control", "no-cache"} };
+
+void MetricsController::appendHistogram(String &json, const char *name, const HttpMetrics::Histogram &histogram)
+{
+    char buff[96];
+    snprintf(buff, sizeof(buff), "\"%s\" : { \"Count\" : %u, \"AvgUs\" : %u, \"MaxUs\" : %u, \"Buckets\" : [",
+        name,
+        histogram.count,
+        histogram.count == 0 ? 0 : static_cast<unsigned>(histogram.sum / histogram.count),
+        histogram.max);
+    json += buff;
+    for (size_t i = 0; i < HTTP_METRICS_N_BUCKETS; i++)
+    {
+        if (i > 0)
+            json += ", ";
+        json += histogram.buckets[i];
+    }
+    json += "] }";
+}
+
+bool MetricsController::Get(HttpClientContext &context, const String id)
+{
+#ifdef DEBUG_HTTP_SERVER
+    Traceln("MetricsController Get");
+#endif
+    // Take a copy of the metrics, so they are not locked while the response is built.
+    HttpMetrics::Routes routes;
+    unsigned long period = HttpMetrics::getRoutes(routes);
+    HTTPServer::AdmissionStats admission;
+    HTTPServer::getAdmissionStats(admission);
+
+    String json;
+    json.reserve(512 + routes.size() * 512);
+    json = String("{ \"PeriodMs\" : ") + period +
+        ", \"Connections\" : { \"Accepted\" : " + admission.accepted +
+        ", \"Rejected\" : " + admission.rejected +
+        ", \"Expired\" : " + admission.expired +
+        ", \"Queued\" : " + admission.queued +
+        ", \"MaxQueued\" : " + admission.maxQueued + " }" +
+        ", \"BucketBoundsUs\" : [";
+    for (size_t i = 0; i < NELEMS(HttpMetrics::bucketBounds); i++)
+    {
+        if (i > 0)
+            json += ", ";
+        json += HttpMetrics::bucketBounds[i];
+    }
+    json += "], \"Routes\" : [";
+
+    bool first = true;
+    for (const std::pair<const String, HttpMetrics::RouteMetrics> &route : routes)
+    {
+        const HttpMetrics::RouteMetrics &metrics = route.second;
+        char buff[128];
+        snprintf(buff, sizeof(buff), "\"Requests\" : %u, \"Failures\" : %u, \"BytesSent\" : %llu, ",
+            metrics.requests, metrics.failures, static_cast<unsigned long long>(metrics.bytesSent));
+        json += first ? " { \"Route\" : \"" : ", { \"Route\" : \"";
+        json += route.first + "\", " + buff;
+        appendHistogram(json, "Parse", metrics.parse);
+        json += ", ";
+        appendHistogram(json, "FirstByte", metrics.firstByte);
+        json += ", ";
+        appendHistogram(json, "Total", metrics.total);
+        json += " }";
+        first = false;
+    }
+    json += " ] }";
+
+    HttpHeaders headers(context);
+    headers.sendResponse(200, commonHeaders, NELEMS(commonHeaders), json);
+
+    return true;
+}
+
+// Post request is unimplemented.
+bool MetricsController::Post(HttpClientContext &context, const String id)
+{
+    return false;
+}
+
+// Put request is unimplemented.
+bool MetricsController::Put(HttpClientContext &context, const String id)
+{
+    return false;
+}
+
+bool MetricsController::Delete(HttpClientContext &context, const String id)
+{
+#ifdef DEBUG_HTTP_SERVER
+    Traceln("MetricsController Delete");
+#endif
+    // Start collecting the metrics anew
+    HttpMetrics::reset();
+
+    HttpHeaders headers(context);
+    headers.sendHeaderSection(200, true, commonHeaders + 1, NELEMS(commonHeaders) - 1);
+
+    return true;
+}
+
+static std::shared_ptr<HttpController> metricsController = std::make_shared<MetricsController>();
+
+// This method returns a singleton instance of the MetricsController.
+std::shared_ptr<HttpController> MetricsController::getInstance() { return metricsController; }
@@ -0,0 +1,248 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+
+#include <MultipartParser.h>
+#include <string.h>
+#include <strings.h>
+
+#define BOUNDARY_PARAM "boundary="
+#define CONTENT_DISPOSITION_HEADER "Content-Disposition:"
+#define FILE_NAME_PARAM "filename="
+
+MultipartParser::MultipartParser(const char *boundary, FileStartHandler onFileStart, FileDataHandler onFileData, void *context) :
+    onFileStart(onFileStart),
+    onFileData(onFileData),
+    context(context),
+    matched(0),
+    lineLength(0),
+    filePart(false)
+{
+    fileName[0] = '\0';
+    strcpy(delimiter, "\r\n--");
+    delimiterLength = 4;
+    if (boundary == NULL || *boundary == '\0')
+    {
+        // The boundary is taken from the first line of the body
+        state = State::DELIMITER;
+        return;
+    }
+
+    size_t boundaryLength = strlen(boundary);
+    if (boundaryLength > MULTIPART_MAX_BOUNDARY_LENGTH)
+    {
+        state = State::FAILED;
+        return;
+    }
+    memcpy(delimiter + delimiterLength, boundary, boundaryLength + 1);
+    delimiterLength += boundaryLength;
+    // Anything before the first delimiter is a preamble that is ignored.
+    // The first delimiter is not preceded by a line break, so the line break is considered already matched.
+    state = State::CONTENT;
+    matched = 2;
+}
+
+void MultipartParser::getBoundary(const char *contentType, char *boundary, size_t size)
+{
+    boundary[0] = '\0';
+    const size_t paramLength = strlen(BOUNDARY_PARAM);
+    for (const char *p = contentType; *p != '\0'; p++)
+    {
+        if (strncasecmp(p, BOUNDARY_PARAM, paramLength) != 0)
+            continue;
+
+        p += paramLength;
+        bool quoted = *p == '"';
+        if (quoted)
+            p++;
+        size_t len = 0;
+        while (p[len] != '\0' && (quoted ? p[len] != '"' : p[len] != ';' && p[len] != ' '))
+            len++;
+        if (len < size)
+        {
+            memcpy(boundary, p, len);
+            boundary[len] = '\0';
+        }
+        return;
+    }
+}
+
+bool MultipartParser::parse(const uint8_t *data, size_t size)
+{
+    size_t i = 0;
+    while (i < size)
+    {
+        switch (state)
+        {
+        case State::DELIMITER:
+        case State::DELIMITER_LINE:
+        case State::HEADERS:
+            if (!parseLine(data, size, i))
+                state = State::FAILED;
+            break;
+
+        case State::CONTENT:
+            if (!parseContent(data, size, i))
+                state = State::FAILED;
+            break;
+
+        case State::DONE:
+            // The rest of the body is ignored
+            return true;
+
+        case State::FAILED:
+            return false;
+        }
+    }
+
+    return state != State::FAILED;
+}
+
+bool MultipartParser::parseLine(const uint8_t *data, size_t size, size_t &i)
+{
+    const uint8_t *lf = static_cast<const uint8_t *>(memchr(data + i, '\n', size - i));
+    size_t end = lf == NULL ? size : lf - data;
+    // Overlong lines are truncated
+    size_t len = end - i;
+    if (len > MULTIPART_MAX_LINE_LENGTH - lineLength)
+        len = MULTIPART_MAX_LINE_LENGTH - lineLength;
+    memcpy(line + lineLength, data + i, len);
+    lineLength += len;
+    if (lf == NULL)
+    {
+        i = size;
+        return true;
+    }
+
+    i = end + 1;
+    if (lineLength > 0 && line[lineLength - 1] == '\r')
+        lineLength--;
+    line[lineLength] = '\0';
+    bool result = onLine();
+    lineLength = 0;
+    return result;
+}
+
+bool MultipartParser::onLine()
+{
+    switch (state)
+    {
+    case State::DELIMITER:
+        // The first line of the body is the delimiter, "--" followed by the boundary
+        if (strncmp(line, "--", 2) != 0 || lineLength <= 2 || lineLength - 2 > MULTIPART_MAX_BOUNDARY_LENGTH)
+            return false;
+        memcpy(delimiter + delimiterLength, line + 2, lineLength - 1);
+        delimiterLength += lineLength - 2;
+        state = State::HEADERS;
+        return true;
+
+    case State::DELIMITER_LINE:
+        // A delimiter that is followed by "--" closes the body. The body ended without a file.
+        if (strncmp(line, "--", 2) == 0)
+            return false;
+        state = State::HEADERS;
+        return true;
+
+    case State::HEADERS:
+        if (lineLength == 0)
+        {
+            // The end of the headers of the part
+            state = State::CONTENT;
+            matched = 0;
+            return !filePart || onFileStart == NULL || onFileStart(fileName, context);
+        }
+        if (strncasecmp(line, CONTENT_DISPOSITION_HEADER, strlen(CONTENT_DISPOSITION_HEADER)) == 0)
+        {
+            const char *value = strstr(line, FILE_NAME_PARAM);
+            if (value == NULL)
+                return true;
+            value += strlen(FILE_NAME_PARAM);
+            bool quoted = *value == '"';
+            if (quoted)
+                value++;
+            const char *valueEnd = strchr(value, quoted ? '"' : ';');
+            if (valueEnd == NULL)
+                valueEnd = value + strlen(value);
+            // Some browsers send the full path of the file, only its name is kept.
+            for (const char *p = value; p < valueEnd; p++)
+            {
+                if (*p == '/' || *p == '\\')
+                    value = p + 1;
+            }
+            size_t len = valueEnd - value;
+            memcpy(fileName, value, len);
+            fileName[len] = '\0';
+            // When no file is selected in the form, the part has an empty file name.
+            filePart = len > 0;
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool MultipartParser::parseContent(const uint8_t *data, size_t size, size_t &i)
+{
+    while (i < size)
+    {
+        if (matched == 0)
+        {
+            // Pass on everything up to the next possible delimiter at once.
+            // A carriage return appears only at the start of the delimiter.
+            const uint8_t *cr = static_cast<const uint8_t *>(memchr(data + i, '\r', size - i));
+            size_t end = cr == NULL ? size : cr - data;
+            if (!emit(data + i, end - i))
+                return false;
+            i = end;
+            if (cr == NULL)
+                return true;
+        }
+
+        if (data[i] == static_cast<uint8_t>(delimiter[matched]))
+        {
+            i++;
+            if (++matched < delimiterLength)
+                continue;
+
+            // The delimiter is complete, the part ended
+            matched = 0;
+            if (filePart)
+            {
+                state = State::DONE;
+                return true;
+            }
+            state = State::DELIMITER_LINE;
+            return true;
+        }
+
+        // The bytes that were matched so far are part of the content after all.
+        // The current byte is tested again against the start of the delimiter.
+        if (!emit(reinterpret_cast<const uint8_t *>(delimiter), matched))
+            return false;
+        matched = 0;
+    }
+
+    return true;
+}
+
+bool MultipartParser::emit(const uint8_t *data, size_t size)
+{
+    if (!filePart || size == 0 || onFileData == NULL)
+        return true;
+    return onFileData(data, size, context);
+}
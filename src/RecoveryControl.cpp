@@ -23,6 +23,7 @@
 #include <EthernetUtil.h>
 #ifndef USE_WIFI
 #include <ICMPPingEx.h>
+#include <SocketBudget.h>
 #else
 #include <ping.h>
 #endif
@@ -327,6 +328,8 @@ class CheckConnectivityStateParam
 public:
 	CheckConnectivityStateParam() :
 #ifndef USE_WIFI
+		// The probe socket is leased for the whole connectivity check, so the pings do not fail for lack of a socket
+		probeLease(SocketClass::PROBE),
 		ping(MAX_SOCK_NUM, 1),
 #else
 		attempts(0),
@@ -338,6 +341,7 @@ public:
 
 public:
 #ifndef USE_WIFI
+	SocketBudget::Lease probeLease;
 	ICMPPingEx ping;
 	ICMPEchoReply pingResult;
 #else
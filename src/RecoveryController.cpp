@@ -59,17 +59,15 @@ bool RecoveryController::Post(HttpClientContext &context, const String id)
     Traceln("RecoveryController Post");
 #endif
     String content;
-    EthClient client = context.getClient();
 
     // Read the request body from the client connection.
     // This assumes that the request body is sent as a JSON object containing the recovery type.
-    while (client.connected() && !client.available()) {
-        delay(10); // Wait for data to be available
-    }
-    while (client.available())
-    {
-        content += (char)client.read();
-    }
+    // Read no more than the content length, the connection may carry the next request after the body.
+    size_t contentLength = context.getContentLength();
+    // Part of the body may already be received along with the header section, so it is read through the context.
+    // The wait for the body is bound by the deadline of the request, so a stalled client does not hold the worker.
+    while (content.length() < contentLength && context.waitForData())
+        content += (char)context.read();
 
 #ifdef DEBUG_HTTP_SERVER
     TRACE_BLOCK
@@ -99,7 +97,7 @@ bool RecoveryController::Post(HttpClientContext &context, const String id)
 
     // Send a 200 OK response to the client with appropriate headers.
     HttpHeaders::Header additionalHeaders[] = { {"Access-Control-Allow-Origin", "*" }, {"Cache-Control", "no-cache"} };
-    HttpHeaders headers(client);
+    HttpHeaders headers(context);
     headers.sendHeaderSection(200, true, additionalHeaders, NELEMS(additionalHeaders));
 
     return true;
@@ -20,10 +20,41 @@
 #include <Relays.h>
 #include <TimeUtil.h>
 #include <HttpHeaders.h>
+#include <SocketBudget.h>
+#include <EthernetUtil.h>
 #ifdef DEBUG_HTTP_SERVER
 #include <Trace.h>
 #endif
 
+/// @brief Parses the ID of a client. The IDs are the numbers that IndexView gives to the browsers.
+/// @param id The ID, as in the URL.
+/// @param numericId Returns the numeric ID.
+/// @return true if the ID is a valid number.
+static bool parseId(const String &id, uint32_t &numericId)
+{
+    if (id.isEmpty() || id.length() > 10)
+        return false;
+    uint64_t value = 0;
+    for (const char *p = id.c_str(); *p != '\0'; p++)
+    {
+        if (!isdigit(*p))
+            return false;
+        value = value * 10 + (*p - '0');
+    }
+    if (value > UINT32_MAX)
+        return false;
+    numericId = value;
+
+    return true;
+}
+
+/// @brief The IDs of clients that are collected while the table of clients is scanned, to be deleted after the scan.
+struct ClientIds
+{
+    uint32_t ids[SSE_MAX_CLIENTS];
+    size_t count;
+};
+
 bool SSEController::Get(HttpClientContext &context, const String id)
 {
     EthClient client = context.getClient();
@@ -42,44 +73,47 @@ bool SSEController::Get(HttpClientContext &context, const String id)
     }
 #endif
 
-    struct Params
-    {
-        SSEController *controller;
-        String id;
-    } params = { this, id };
+    uint32_t numericId;
+    if (!parseId(id, numericId))
+        return false;
 
-    // Scan the list of clients and delete the client if there is already a client with the same ID.
+    // Delete the client if there is already a client with the same ID.
     // In case index page is invoked with no ID, a temporary clientInfo instance is created with the ID
-    // and added to the clients list. Then the request is replied with a redirect to the index page with the ID in the URL.
+    // and added to the clients table. Then the request is replied with a redirect to the index page with the ID in the URL.
     // So now it is time to delete this temporary clientInfo instance and replace it with a real clientInfo instance.
     // The temporary clientInfo instance is required so that the SSE controller will recognise the redirected call as a valid 
     // call with a valid ID.
-    clients.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
-    {
-        const Params *params = static_cast<const Params *>(param);
-        String id = params->id;
-        if (clientInfo.id.equals(id))
-        {
-            // If the client already exists, delete it.
-            params->controller->DeleteClient(clientInfo, true);
-            return false;
-        }
-
-        return true;
-    }, &params);
+    DeleteClient(numericId, true);
+    // The connection now holds a socket of an SSE stream. If there are too many streams, the oldest one is closed.
+    context.setSocketClass(SocketClass::SSE);
 #ifdef DEBUG_HTTP_SERVER
     Tracef("Adding SSE client: id=%s, IP=%s, port=%d, object=%lx\n", id.c_str(), client.remoteIP().toString().c_str(), client.remotePort(), (ulong)&client);
 #endif
-    // Add the client to the list of clients.
-    clients.Insert(ClientInfo(id, client));
+    // Add the client to the table of clients.
+    // A browser that reconnects sends the ID of the last event it received. If the events that it missed since then
+    // are still in the ring, they are replayed. Otherwise, the client is sent a snapshot of the state.
+    ClientInfo clientInfo(numericId, client);
+    uint32_t lastSeq;
+    if (GetResumeSeq(context.getLastEventId(), lastSeq))
+    {
+#ifdef DEBUG_HTTP_SERVER
+        Tracef("Resuming SSE client id=%s after event %u\n", id.c_str(), (unsigned)lastSeq);
+#endif
+        clientInfo.needsSnapshot = false;
+        clientInfo.sentSeq = lastSeq;
+    }
 
     // Send response to the client to acknowledge the SSE request.
+    // The response is sent before the client is added, so the broadcaster task does not send events ahead of it.
     HttpHeaders httpHeaders(client);
     httpHeaders.sendStreamHeaderSection();
+    // If there is no room for the client, the stream ends right away and the browser tries again later.
+    if (!InsertClient(numericId, clientInfo))
+        return true;
     // Set the keep-alive flag to true to keep the connection open for SSE.
     context.keepAlive = true;
 
-    // Notify the client about the current state.
+    // Notify the client about the current state, or about what it missed.
     NotifyState(id);
 
     return true;
@@ -101,30 +135,14 @@ bool SSEController::Put(HttpClientContext &context, const String id)
 // Not all browsers call the beforeunload event. So there is also a background task that periodically deletes unused clients.
 bool SSEController::Delete(HttpClientContext &context, const String id)
 {
-    struct Params
-    {
-        SSEController *controller;
-        const String &id;
-    } params = { this, id };
-
-    // Scan the list of clients and delete the client with the given ID.
-    clients.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
-    {
-        const Params *params = static_cast<const Params *>(param);
-        String id = params->id;
-        if (clientInfo.id.equals(id))
-        {
-            // If the client with the given ID is found, delete it.
-            params->controller->DeleteClient(clientInfo, true);
-            return false;
-        }
-
-        return true;
-    }, &params);
+    // Delete the client with the given ID.
+    uint32_t numericId;
+    if (parseId(id, numericId))
+        DeleteClient(numericId, true);
 
     // Send a response to the client to acknowledge the deletion.
     HttpHeaders::Header additionalHeaders[] = { {"Access-Control-Allow-Origin", "*" }, {"Cache-Control", "no-cache"} };
-    HttpHeaders headers(context.getClient());
+    HttpHeaders headers(context);
     headers.sendHeaderSection(200, true, additionalHeaders, NELEMS(additionalHeaders));
 
     return true;
@@ -132,133 +150,264 @@ bool SSEController::Delete(HttpClientContext &context, const String id)
 
 void SSEController::NotifyState(const String &id)
 {
-    UpdateStateLastRecoveryTime();
+    {
+        Lock lock(csState);
 
-    // Prepare the event data to be sent to the clients.
-    String event("data:{");
-    event += "\"autoRecovery\": ";
-    event += state.autoRecovery ? "true" : "false";
-    event += ", \"modemState\": ";
-    event += static_cast<int>(state.modemState);
-    event += ", \"routerState\": ";
-    event += static_cast<int>(state.routerState);
-    event += ", \"recoveryType\": ";
-    event += static_cast<int>(state.recoveryType);
-    event += ", \"showLastRecovery\": ";
-    event += state.showLastRecovery ? "true" : "false";
-    event += ", \"days\": ";
-    event += state.days;
-    event += ", \"hours\": ";
-    event += state.hours;
-    event += ", \"minutes\": ";
-    event += state.minutes;
-    event += ", \"seconds\": ";
-    event += state.seconds;
-    event += ", \"rDisco\": ";
-    event += AppConfig::getRDisconnect();
-    event += ", \"mDisco\": ";
-    event += AppConfig::getMDisconnect();
-    event += ", \"rPeriodic\": ";
-    event += AppConfig::getPeriodicallyRestartRouter() ? "true" : "false";
-    event += ", \"mPeriodic\": ";
-    event += AppConfig::getPeriodicallyRestartModem() ? "true" : "false";
-    event += "}\n";
+        UpdateStateLastRecoveryTime();
+        state.set(SSEStateField::RDisco, AppConfig::getRDisconnect());
+        state.set(SSEStateField::MDisco, AppConfig::getMDisconnect());
+        state.set(SSEStateField::RPeriodic, AppConfig::getPeriodicallyRestartRouter());
+        state.set(SSEStateField::MPeriodic, AppConfig::getPeriodicallyRestartModem());
+
+        // The clients already have the state that was last notified, so they are queued only the fields that changed since then.
+        // A client that has just connected was queued a snapshot, or the events that it missed, when it was added.
+        if (id.isEmpty() && state.commit())
+        {
+            char event[SSE_EVENT_BUFF_SIZE];
+            size_t idLen = WriteEventId(state.getSeq(), event, sizeof(event));
+            if (state.writeDelta(notifiedSeq, event + idLen, sizeof(event) - idLen) > 0)
+            {
 #ifdef DEBUG_HTTP_SERVER
-    Trace(event);
+                Trace(event);
 #endif
+                events.push(state.getSeq(), event);
+            }
+            notifiedSeq = state.getSeq();
+        }
 
-    struct Params
+        // A single device recovery is notified once, after that it is a router recovery.
+        if (state.get(SSEStateField::RecoveryType) == static_cast<int>(RecoveryTypes::RouterSingleDevice))
+            state.set(SSEStateField::RecoveryType, static_cast<int>(RecoveryTypes::Router));
+    }
+
+    // Let the broadcaster task send the events.
+    if (broadcasterTask != NULL)
+        xTaskNotifyGive(broadcasterTask);
+}
+
+void SSEController::Broadcast()
+{
+    ClientIds streams;
+    streams.count = 0;
+
+    // Collect the IDs of the streams. Nothing is written to the clients while the table is locked,
+    // so a client that is slow to receive does not hold up the lookups of the IDs and the other changes of the table.
+    clients.ScanNodes([](uint32_t id, ClientInfo &clientInfo, void *param)->bool
     {
-        String id;
-        String event;
-    } params = { id, event };
+        ClientIds *streams = static_cast<ClientIds *>(param);
+        if (clientInfo.streaming)
+            streams->ids[streams->count++] = id;
+        return true;
+    }, &streams);
 
-    // Scan the list of clients and send the event data to the requires client(s).
-    clients.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
+    for (size_t i = 0; i < streams.count; i++)
     {
-        const Params *params = static_cast<const Params *>(param);
-        String id = params->id;
-        // If an ID is provided, only send the event to the client with that ID.
-        if (!id.equals("") && !id.equals(clientInfo.id))
-            return true;
-        EthClient client = clientInfo.client;
-        // If the client is not connected, skip it.
-        if (client.connected())
+        // Take a copy of the client and of the progress of its stream, and send it the events out of the lock
+        ClientInfo clientInfo;
+        if (!clients.Find(streams.ids[i], [](ClientInfo &value, void *param)
+            {
+                *static_cast<ClientInfo *>(param) = value;
+            }, &clientInfo))
+            // The client was deleted meanwhile
+            continue;
+
+        if (!SendEvents(clientInfo))
+        {
+            // The socket of the stream is returned to the socket budget right away, so it is available for the next probe or query.
+            // The client is looked up by its connection, in case the ID was taken by a new stream meanwhile.
+            DeleteClient(clientInfo.client, true);
+            continue;
+        }
+
+        // Store the progress of the stream, unless the ID was taken by a new stream meanwhile
+        clients.Find(streams.ids[i], [](ClientInfo &value, void *param)
         {
+            const ClientInfo *clientInfo = static_cast<const ClientInfo *>(param);
+            if (value.streaming && value.client == clientInfo->client && value.createdTime == clientInfo->createdTime)
+                value = *clientInfo;
+        }, &clientInfo);
+    }
+}
+
+bool SSEController::SendEvents(ClientInfo &clientInfo)
+{
+    EthClient client = clientInfo.client;
+    // The client closed the stream, or the heartbeats found out that it is gone.
+    if (!client.connected())
+    {
 #ifdef DEBUG_HTTP_SERVER
-            TRACE_BLOCK
+        Tracef("SSE client id=%u disconnected\n", (unsigned)clientInfo.id);
+#endif
+        return false;
+    }
+
+    while (true)
+    {
+        // Send as much of the current event as the client has room for, without waiting.
+        size_t remaining = clientInfo.pendingLength - clientInfo.pendingOffset;
+        if (remaining > 0)
+        {
+            size_t room = GetRoomForWrite(client, remaining);
+            if (room > 0)
             {
-                Trace("Notifying client id=");
-                Trace(clientInfo.id);
-                Tracef(" IP=%s, port=%d", client.remoteIP().toString().c_str(), client.remotePort());
-#ifndef USE_WIFI
-                Trace(", socket=");
-                Traceln(client.getSocketNumber());
-#else
-                Traceln();
+                size_t written = client.write(reinterpret_cast<const uint8_t *>(clientInfo.pending) + clientInfo.pendingOffset, room);
+                if (written == 0)
+                {
+#ifdef DEBUG_HTTP_SERVER
+                    Tracef("SSE client id=%u failed to write\n", (unsigned)clientInfo.id);
 #endif
+                    return false;
+                }
+                clientInfo.pendingOffset += written;
+                clientInfo.lastSentTime = millis();
             }
-#endif
-            // Send the event data to the client.`
-            client.print(params->event);
-            client.println();
+            // The rest of the event is sent once the client has room for it.
+            if (clientInfo.pendingOffset < clientInfo.pendingLength)
+                return true;
 #ifdef USE_WIFI
             client.flush();
 #endif
         }
 
-        // If an ID is provided, stop scanning after sending the event to the specified client.
-        if (!id.equals(""))
-            return false;
-            
-        // Continue scanning for other clients if no ID is provided.
-        return true;
-    }, &params);
+        // Take the next event of the client. The event is copied, so the state is not locked while it is written to the client.
+        {
+            Lock lock(csState);
+
+            if (!clientInfo.needsSnapshot && clientInfo.sentSeq < events.getLastSeq() && events.get(clientInfo.sentSeq + 1) == NULL)
+            {
+                // The client fell so far behind that the events it did not receive yet were dropped from the ring.
+#ifdef DEBUG_HTTP_SERVER
+                Tracef("SSE client id=%u fell behind, sent=%u, first=%u\n", (unsigned)clientInfo.id, (unsigned)clientInfo.sentSeq, (unsigned)events.getFirstSeq());
+#endif
+#if SSE_DISCONNECT_LAGGARDS
+                return false;
+#else
+                // The changes that the client missed are replaced by a snapshot of the state.
+                clientInfo.needsSnapshot = true;
+#endif
+            }
+
+            if (clientInfo.needsSnapshot)
+            {
+                // The snapshot is written right into the buffer of the client
+                size_t idLen = WriteEventId(state.getSeq(), clientInfo.pending, sizeof(clientInfo.pending));
+                clientInfo.pendingLength = idLen + state.writeSnapshot(clientInfo.pending + idLen, sizeof(clientInfo.pending) - idLen);
+                clientInfo.pendingOffset = 0;
+                clientInfo.sentSeq = state.getSeq();
+                clientInfo.needsSnapshot = false;
+            }
+            else if (clientInfo.sentSeq < events.getLastSeq())
+                clientInfo.setPending(events.get(++clientInfo.sentSeq)->c_str());
+            else if (millis() - clientInfo.lastSentTime >= SSE_HEARTBEAT_INTERVAL)
+            {
+                // A comment line is ignored by the browser. The ID of the last event stays as it is.
+                clientInfo.setPending(":\n\n");
+                continue;
+            }
+            else
+                return true;
+        }
 
-    if (state.recoveryType == RecoveryTypes::RouterSingleDevice)
-        state.recoveryType = RecoveryTypes::Router;
+#ifdef DEBUG_HTTP_SERVER
+        TRACE_BLOCK
+        {
+            Trace("Notifying client id=");
+            Trace((unsigned)clientInfo.id);
+            Tracef(" IP=%s, port=%d", client.remoteIP().toString().c_str(), client.remotePort());
+#ifndef USE_WIFI
+            Trace(", socket=");
+            Traceln(client.getSocketNumber());
+#else
+            Traceln();
+#endif
+        }
+#endif
+    }
 }
 
 // This method is called periodically to delete unused clients.
-// It scans the list of clients and deletes those that are not connected.
+// It scans the table of clients and deletes those that are not connected.
 void SSEController::DeleteUnusedClients()
 {
-    ClientsList clientsToDelete;
+    ClientIds clientsToDelete;
+    clientsToDelete.count = 0;
 
-    // Scan the list of clients and add the unused clients to the clientsToDelete list.
-    // It is not possible to delete clients while scanning the list, so we first collect the clients to delete in a separate list.
-    clients.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
+    // Scan the table of clients and collect the IDs of the unused clients.
+    // It is not possible to delete clients while scanning the table, so we first collect the clients to delete.
+    clients.ScanNodes([](uint32_t id, ClientInfo &clientInfo, void *param)->bool
     {
-        ClientsList *clientsToDelete = static_cast<ClientsList *>(param);
+        ClientIds *clientsToDelete = static_cast<ClientIds *>(param);
         EthClient client = clientInfo.client;
         if (!client.connected())
-            clientsToDelete->Insert(clientInfo);
+            clientsToDelete->ids[clientsToDelete->count++] = id;
         return true;
     }, &clientsToDelete);
 
-    // Now delete the clients that were collected in the clientsToDelete list.
-    clientsToDelete.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
-    {
-        SSEController *controller = static_cast<SSEController *>(param);
-        EthClient client = clientInfo.client;
-        controller->DeleteClient(clientInfo, client);
-        return true;
-    }, this);
+    // Now delete the clients that were collected.
+    for (size_t i = 0; i < clientsToDelete.count; i++)
+        DeleteClient(clientsToDelete.ids[i], false);
+}
+
+size_t SSEController::WriteEventId(uint32_t seq, char *buff, size_t size) const
+{
+    return snprintf(buff, size, "id: %08x.%x\n", (unsigned)bootId, (unsigned)seq);
+}
+
+bool SSEController::GetResumeSeq(const String &lastEventId, uint32_t &seq)
+{
+    // The ID is the boot ID and the sequence number of the event, in hex, separated by a dot.
+    int dot = lastEventId.indexOf('.');
+    if (dot <= 0 || strtoul(lastEventId.substring(0, dot).c_str(), NULL, 16) != bootId)
+        return false;
+    seq = strtoul(lastEventId.c_str() + dot + 1, NULL, 16);
+
+    Lock lock(csState);
+    // The client is either up to date, or the event that follows its last event is still in the ring.
+    return seq == notifiedSeq || (seq < notifiedSeq && events.get(seq + 1) != NULL);
 }
 
 void SSEController::Init()
 {
     // Initialize the state of the controller.
-    state.autoRecovery = recoveryControl.GetAutoRecovery();
-    state.recoveryType = recoveryControl.GetRecoveryState();
-    state.modemState = GetModemPowerState();
-    state.routerState = GetRouterPowerState();
+    bootId = esp_random();
+    state.set(SSEStateField::AutoRecovery, recoveryControl.GetAutoRecovery());
+    state.set(SSEStateField::RecoveryType, static_cast<int>(recoveryControl.GetRecoveryState()));
+    state.set(SSEStateField::ModemState, static_cast<int>(GetModemPowerState()));
+    state.set(SSEStateField::RouterState, static_cast<int>(GetRouterPowerState()));
     UpdateStateLastRecoveryTime();
+    state.commit();
+    notifiedSeq = state.getSeq();
     // Register observers for various state changes.
     recoveryControl.addRecoveryStateChangedObserver(OnRecoveryStateChanged, this);
     recoveryControl.addAutoRecoveryStateChangedObserver(OnAutoRecoveryStateChanged, this);
     recoveryControl.addModemPowerStateChangedObserver(OnModemPowerStateChanged, this);
     recoveryControl.addRouterPowerStateChangedObserver(OnRouterPowerStateChanged, this);
+    // Let the socket budget close the oldest stream when it needs room for other sockets.
+    SocketBudget::addSSEEvictor([](void *context)
+    {
+        return static_cast<SSEController *>(context)->EvictOldestClient();
+    },
+    [](void *context, unsigned long &age)
+    {
+        return static_cast<SSEController *>(context)->GetOldestClientAge(age);
+    }, this);
+    // Start the task that sends the events to the clients, so the observers of the state do not wait for the clients.
+    xTaskCreate([](void *param)
+    {
+        SSEController *controller = static_cast<SSEController *>(param);
+
+        while (true)
+        {
+            // Wait for new events, or go on sending to the clients that did not have room for the previous events.
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SSE_BROADCAST_INTERVAL));
+            controller->Broadcast();
+        }
+    },
+    "SSE_Broadcaster",
+    4 * 1024,
+    this,
+    tskIDLE_PRIORITY + 1,
+    &broadcasterTask);
     // Start a background task to periodically delete unused clients.
     xTaskCreate([](void *param)
     {
@@ -266,7 +415,7 @@ void SSEController::Init()
 
         while (true)
         {
-            delay(5000);
+            delay(SSE_REAP_INTERVAL);
             controller->DeleteUnusedClients();
         }
     },
@@ -281,22 +430,25 @@ void SSEController::UpdateStateLastRecoveryTime()
 {
     time_t lastRecovery = recoveryControl.GetLastRecovery();
     // We should show the last recovery time only if we are not in a recovery state.
-    state.showLastRecovery = lastRecovery != INT32_MAX && recoveryControl.GetRecoveryState() == RecoveryTypes::NoRecovery;
-    if (state.showLastRecovery)
+    bool showLastRecovery = lastRecovery != INT32_MAX && recoveryControl.GetRecoveryState() == RecoveryTypes::NoRecovery;
+    state.set(SSEStateField::ShowLastRecovery, showLastRecovery);
+    if (showLastRecovery)
     {
         // Calculate the time since the last recovery.
         time_t timeSinceLastRecovery = t_now - lastRecovery;
-        state.seconds = timeSinceLastRecovery % 60;
-        state.minutes = (timeSinceLastRecovery / 60) % 60;
-        state.hours = (timeSinceLastRecovery / 3600) % 24;
-        state.days = (timeSinceLastRecovery / 3600 / 24);
+        state.set(SSEStateField::Seconds, timeSinceLastRecovery % 60);
+        state.set(SSEStateField::Minutes, (timeSinceLastRecovery / 60) % 60);
+        state.set(SSEStateField::Hours, (timeSinceLastRecovery / 3600) % 24);
+        state.set(SSEStateField::Days, timeSinceLastRecovery / 3600 / 24);
     }
 }
 
 void SSEController::OnRecoveryStateChanged(const RecoveryStateChangedParams &params)
 {
-    state.recoveryType = params.m_recoveryType;
-    UpdateStateLastRecoveryTime();
+    {
+        Lock lock(csState);
+        state.set(SSEStateField::RecoveryType, static_cast<int>(params.m_recoveryType));
+    }
     // Notify all the clients about the recovery state change.
     NotifyState("");
 }
@@ -310,14 +462,20 @@ void SSEController::OnAutoRecoveryStateChanged(const AutoRecoveryStateChangedPar
         Traceln(params.m_autoRecovery);
     }
 #endif
-    state.autoRecovery = params.m_autoRecovery;
+    {
+        Lock lock(csState);
+        state.set(SSEStateField::AutoRecovery, params.m_autoRecovery);
+    }
     // Notify all the clients about the auto-recovery state change.
     NotifyState("");
 }
 
 void SSEController::OnModemPowerStateChanged(const PowerStateChangedParams &params)
 {
-    state.modemState = params.m_state;
+    {
+        Lock lock(csState);
+        state.set(SSEStateField::ModemState, static_cast<int>(params.m_state));
+    }
     // Notify all the clients about the modem power state change.
     NotifyState("");
 }
@@ -331,7 +489,10 @@ void SSEController::OnModemPowerStateChanged(const PowerStateChangedParams &para
 /// @param context The context pointer.
 void SSEController::OnRouterPowerStateChanged(const PowerStateChangedParams &params)
 {
-    state.routerState = params.m_state;
+    {
+        Lock lock(csState);
+        state.set(SSEStateField::RouterState, static_cast<int>(params.m_state));
+    }
     NotifyState("");
 }
 
@@ -339,94 +500,156 @@ bool SSEController::DeleteClient(EthClient &client, bool stopClient)
 {
     struct Params
     {
-        SSEController *controller;
         const EthClient client;
-        bool stopClient;
-        bool ret;
-    } params = { this, client, stopClient, false };
+        uint32_t id;
+        bool found;
+    } params = { client, 0, false };
 
-    clients.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
+    clients.ScanNodes([](uint32_t id, ClientInfo &clientInfo, void *param)->bool
     {
         Params *params = static_cast<Params *>(param);
         EthClient client = clientInfo.client;
         if (client == params->client)
         {
-            // Since we do not continue to scan the list after finding the client,
-            // we can safely delete the client here.
-            params->controller->DeleteClient(clientInfo, params->stopClient);
-            params->ret = true;
+            params->id = id;
+            params->found = true;
             return false;
         }
 
         return true;
     }, &params);
 
-    return params.ret;
+    return params.found && DeleteClient(params.id, stopClient);
 }
 
-void SSEController::DeleteClient(const ClientInfo &clientInfo, bool stopClient)
+bool SSEController::DeleteClient(uint32_t id, bool stopClient)
 {
-    EthClient client = clientInfo.client;
-    // If the client is not connected then there is no need to stop it.
-    if (client)
+    struct Params
+    {
+        bool stopClient;
+        bool streaming;
+    } params = { stopClient, false };
+
+    // The client is stopped while the table is locked, so a new client with the same ID does not take its place in the meantime.
+    bool deleted = clients.Delete(id, [](ClientInfo &clientInfo, void *param)
     {
+        Params *params = static_cast<Params *>(param);
+        params->streaming = clientInfo.streaming;
+        EthClient client = clientInfo.client;
+        // If the client is not connected then there is no need to stop it.
+        if (client)
+        {
 #ifdef DEBUG_HTTP_SERVER
-        TRACE_BLOCK
-	    {
-            Tracef("%d Deleting previous session id=%s", client.remotePort(), clientInfo.id.c_str());
+            TRACE_BLOCK
+            {
+                Tracef("%d Deleting previous session id=%u", client.remotePort(), (unsigned)clientInfo.id);
 #ifndef USE_WIFI
-            Trace(", socket=");
-            Traceln(client.getSocketNumber());
+                Trace(", socket=");
+                Traceln(client.getSocketNumber());
 #else
-            Traceln();
+                Traceln();
 #endif
-        }
+            }
 #endif
-        if (stopClient)
-        {
+            if (params->stopClient)
+            {
 #ifdef DEBUG_HTTP_SERVER
-            Tracef("%d Stopping client\n", client.remotePort());
-#endif        
-            // Stop the client connection.
-            client.stop();
+                Tracef("%d Stopping client\n", client.remotePort());
+#endif
+                // Stop the client connection.
+                client.stop();
+            }
         }
-    }
 #ifdef DEBUG_HTTP_SERVER
-    else
-        Tracef("Deleting client info id=%s\n", clientInfo.id);
+        else
+            Tracef("Deleting client info id=%u\n", (unsigned)clientInfo.id);
 #endif
-    // Delete the client info from the list of clients.
-    clients.Delete(clientInfo);
+    }, &params);
+
+    // The socket of a stream is returned to the socket budget.
+    if (deleted && params.streaming)
+        SocketBudget::release(SocketClass::SSE);
+
+    return deleted;
 }
 
-bool SSEController::IsValidId(const String &id)
+bool SSEController::InsertClient(uint32_t id, const ClientInfo &clientInfo)
+{
+    if (clients.Insert(id, clientInfo))
+        return true;
+
+    // The table is full. The IDs that were given to browsers that did not connect their stream yet are expendable.
+#ifdef DEBUG_HTTP_SERVER
+    Tracef("SSE clients table is full, deleting the oldest ID to add id=%u\n", (unsigned)clientInfo.id);
+#endif
+    return DeleteOldestClient(false) && clients.Insert(id, clientInfo);
+}
+
+bool SSEController::FindOldestClient(bool streaming, uint32_t &id, unsigned long &age)
 {
     struct Params
     {
-        String id;
-        bool isValid;
-    } params = { id, false };
-
-    // Scan the list of clients and check if one of the clients has the given ID.
-    clients.ScanNodes([](const ClientInfo &clientInfo, void *param)->bool
+        bool streaming;
+        uint32_t id;
+        unsigned long age;
+        bool found;
+    } params = { streaming, 0, 0, false };
+
+    // The clients are not kept in order, so the oldest one is found by the time it was added.
+    clients.ScanNodes([](uint32_t id, ClientInfo &clientInfo, void *param)->bool
     {
         Params *params = static_cast<Params *>(param);
-        params->isValid = clientInfo.id.equals(params->id);
-        // If the ID is found, stop scanning the list. Otherwise, continue scanning.
-        return !params->isValid;
+        unsigned long age = millis() - clientInfo.createdTime;
+        if (clientInfo.streaming == params->streaming && (!params->found || age > params->age))
+        {
+            params->id = id;
+            params->age = age;
+            params->found = true;
+        }
+        return true;
     }, &params);
 
-    return params.isValid;
+    id = params.id;
+    age = params.age;
+    return params.found;
+}
+
+bool SSEController::DeleteOldestClient(bool streaming)
+{
+    uint32_t id;
+    unsigned long age;
+    return FindOldestClient(streaming, id, age) && DeleteClient(id, true);
+}
+
+bool SSEController::GetOldestClientAge(unsigned long &age)
+{
+    uint32_t id;
+    return FindOldestClient(true, id, age);
+}
+
+bool SSEController::EvictOldestClient()
+{
+#ifdef DEBUG_HTTP_SERVER
+    Traceln("Evicting the oldest SSE client");
+#endif
+    return DeleteOldestClient(true);
+}
+
+bool SSEController::IsValidId(const String &id)
+{
+    uint32_t numericId;
+    return parseId(id, numericId) && clients.Contains(numericId);
 }
 
 void SSEController::AddClient(const String &id)
 {
+    uint32_t numericId;
     // If the ID is already valid, do not add it again.
-    if (IsValidId(id))
+    if (!parseId(id, numericId) || clients.Contains(numericId))
         return;
 
-    // Add a new client with the given ID to the list of clients.
-    clients.Insert(ClientInfo(id));
+    // Add a new client with the given ID to the table of clients.
+    InsertClient(numericId, ClientInfo(numericId));
 }
 
 /// @brief Pointer to the global SSEController instance.
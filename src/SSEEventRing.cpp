@@ -0,0 +1,44 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#include <SSEEventRing.h>
+
+SSEEventRing::SSEEventRing() :
+    firstSeq(1),
+    nextSeq(1)
+{
+}
+
+void SSEEventRing::push(uint32_t seq, const char *event)
+{
+    if (seq != nextSeq)
+        firstSeq = seq;
+    else if (nextSeq - firstSeq == SSE_EVENT_RING_SIZE)
+        firstSeq++;
+    nextSeq = seq + 1;
+
+    // The string keeps its buffer, so once the ring is warmed up, events are stored without allocations.
+    events[seq % SSE_EVENT_RING_SIZE] = event;
+}
+
+const String *SSEEventRing::get(uint32_t seq) const
+{
+    if (seq < firstSeq || seq >= nextSeq)
+        return NULL;
+
+    return &events[seq % SSE_EVENT_RING_SIZE];
+}
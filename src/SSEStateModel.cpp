@@ -0,0 +1,111 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#include <SSEStateModel.h>
+
+/// @brief The JSON names of the fields, in the order of SSEStateField, and whether they are boolean.
+static const struct
+{
+    const char *name;
+    bool isBool;
+} fieldsInfo[] =
+{
+    { "autoRecovery", true },
+    { "modemState", false },
+    { "routerState", false },
+    { "recoveryType", false },
+    { "showLastRecovery", true },
+    { "days", false },
+    { "hours", false },
+    { "minutes", false },
+    { "seconds", false },
+    { "rDisco", false },
+    { "mDisco", false },
+    { "rPeriodic", true },
+    { "mPeriodic", true }
+};
+
+static_assert(sizeof(fieldsInfo) / sizeof(*fieldsInfo) == static_cast<size_t>(SSEStateField::COUNT), "Every field of the state must have a name");
+
+SSEStateModel::SSEStateModel() :
+    seq(0),
+    dirty(false)
+{
+    for (int i = 0; i < static_cast<int>(SSEStateField::COUNT); i++)
+    {
+        values[i] = 0;
+        versions[i] = 0;
+    }
+}
+
+bool SSEStateModel::set(SSEStateField field, int value)
+{
+    int i = static_cast<int>(field);
+    if (values[i] == value)
+        return false;
+
+    values[i] = value;
+    versions[i] = seq + 1;
+    dirty = true;
+
+    return true;
+}
+
+bool SSEStateModel::commit()
+{
+    if (!dirty)
+        return false;
+
+    seq++;
+    dirty = false;
+
+    return true;
+}
+
+size_t SSEStateModel::writeSnapshot(char *buff, size_t size) const
+{
+    return writeEvent(true, 0, buff, size);
+}
+
+size_t SSEStateModel::writeDelta(uint32_t since, char *buff, size_t size) const
+{
+    return writeEvent(false, since, buff, size);
+}
+
+size_t SSEStateModel::writeEvent(bool snapshot, uint32_t since, char *buff, size_t size) const
+{
+    // Fields that were set but not committed yet are part of the next sequence number, so they are not sent yet.
+    // The snapshot sends the current value of every field, which is at least as new as the committed one.
+    size_t len = snprintf(buff, size, "data:{\"seq\": %u%s", (unsigned)seq, snapshot ? ", \"full\": true" : "");
+    bool changed = false;
+    for (int i = 0; i < static_cast<int>(SSEStateField::COUNT) && len < size; i++)
+    {
+        if (!snapshot && (versions[i] <= since || versions[i] > seq))
+            continue;
+        changed = true;
+        if (fieldsInfo[i].isBool)
+            len += snprintf(buff + len, size - len, ", \"%s\": %s", fieldsInfo[i].name, values[i] ? "true" : "false");
+        else
+            len += snprintf(buff + len, size - len, ", \"%s\": %d", fieldsInfo[i].name, values[i]);
+    }
+    if (!snapshot && !changed)
+        return 0;
+    if (len < size)
+        len += snprintf(buff + len, size - len, "}\n\n");
+
+    return len < size ? len : 0;
+}
@@ -210,14 +210,17 @@ bool SettingsView::Post(HttpClientContext &context, const String id)
         { settingsKeys::periodicallyRestartModem, false }
     };
 
-    EthClient client = context.getClient();
-
     // Read the form data from the message body.
     // The form data is expected to be in the format "key1=value1&key2=value2&...".
-    // We read until we reach the end of the message body.
-    while(client.available())
+    // We read until we reach the end of the message body, as specified by the content length.
+    // The connection may carry the next request after the body.
+    // Part of the body may already be received along with the header section, so it is read through the context.
+    // Stop reading if the client disconnects or falls behind the deadline of the request.
+    size_t contentLength = context.getContentLength();
+    for (size_t nBytes = 0; nBytes < contentLength && context.waitForData();)
     {
-        char c = client.read();
+        char c = context.read();
+        nBytes++;
         if (c != '&')
         {
             // If the character is not an '&', append it to the current pair.
@@ -241,7 +244,7 @@ bool SettingsView::Post(HttpClientContext &context, const String id)
     // Send a response to the client indicating that the settings have been saved.
     // We send a 302 Found status code to redirect the client to the index page.
     HttpHeaders::Header additionalHeaders[] = { {"Access-Control-Allow-Origin", "*" }, {"Location", "/index"} };
-    HttpHeaders headers(client);
+    HttpHeaders headers(context);
     headers.sendHeaderSection(302, true, additionalHeaders, NELEMS(additionalHeaders));
 
     return true;
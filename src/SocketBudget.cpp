@@ -0,0 +1,223 @@
+/*
+ * Copyright 2020-2025 Boaz Feldboim
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// SPDX-License-Identifier: Apache-2.0
+#include <SocketBudget.h>
+#include <Common.h>
+#ifndef USE_WIFI
+#include <w5100ex.h>
+#endif
+#ifdef DEBUG_ETHERNET
+#include <Trace.h>
+#endif
+
+CriticalSection SocketBudget::cs;
+SocketBudget::Stats SocketBudget::stats = {};
+int SocketBudget::pendingIdleEvictions = 0;
+SocketBudget::SSEOwner SocketBudget::sseOwners[SOCKET_BUDGET_MAX_SSE_EVICTORS] = {};
+int SocketBudget::nSSEOwners = 0;
+
+static const char *classNames[] = { "Probe", "Name", "API", "Static", "SSE" };
+
+/// @brief Returns true if the class is of the connections of the HTTP server.
+static bool isHttpClass(SocketClass cls)
+{
+    return cls == SocketClass::API || cls == SocketClass::STATIC || cls == SocketClass::SSE;
+}
+
+const char *SocketBudget::getClassName(SocketClass cls)
+{
+    return classNames[static_cast<int>(cls)];
+}
+
+int SocketBudget::getFreeSockets()
+{
+#ifndef USE_WIFI
+    int freeSockets = 0;
+    Lock lock(csSpi);
+    for (uint8_t s = 0; s < MAX_SOCK_NUM; s++)
+    {
+        if (W5100Ex.readSnSR(s) == SnSR::CLOSED)
+            freeSockets++;
+    }
+    return freeSockets;
+#else
+    // The network stack of the WiFi does not tell how many of its sockets are free
+    return -1;
+#endif
+}
+
+bool SocketBudget::acquire(SocketClass cls)
+{
+    if (!isHttpClass(cls))
+    {
+        // A system socket is always acquired, the probe or the query fails by itself if there is no room for it
+        bool available = makeRoom();
+        Lock lock(cs);
+        ClassStats &classStats = getClassStats(cls);
+        classStats.acquired++;
+        if (++classStats.inUse > classStats.peak)
+            classStats.peak = classStats.inUse;
+        if (!available)
+            classStats.denied++;
+        return available;
+    }
+
+    Lock lock(cs);
+    int httpInUse = 0;
+    for (SocketClass httpCls : { SocketClass::API, SocketClass::STATIC, SocketClass::SSE })
+        httpInUse += getClassStats(httpCls).inUse;
+    ClassStats &classStats = getClassStats(cls);
+    if (httpInUse >= SOCKET_BUDGET_HTTP_SOCKETS)
+    {
+        classStats.denied++;
+        // Ask an idle persistent connection to close, so there is room for the next connection
+        if (pendingIdleEvictions == 0)
+            pendingIdleEvictions = 1;
+        return false;
+    }
+    classStats.acquired++;
+    if (++classStats.inUse > classStats.peak)
+        classStats.peak = classStats.inUse;
+    return true;
+}
+
+void SocketBudget::release(SocketClass cls)
+{
+    Lock lock(cs);
+    ClassStats &classStats = getClassStats(cls);
+    if (classStats.inUse > 0)
+        classStats.inUse--;
+}
+
+void SocketBudget::reclassify(SocketClass from, SocketClass to)
+{
+    if (from == to)
+        return;
+
+    bool overBudget;
+    {
+        Lock lock(cs);
+        ClassStats &fromStats = getClassStats(from);
+        if (fromStats.inUse > 0)
+            fromStats.inUse--;
+        ClassStats &toStats = getClassStats(to);
+        toStats.acquired++;
+        if (++toStats.inUse > toStats.peak)
+            toStats.peak = toStats.inUse;
+        overBudget = to == SocketClass::SSE && toStats.inUse > SOCKET_BUDGET_MAX_SSE;
+    }
+
+    // The evictor releases the socket of the stream, so it is called out of the lock
+    if (overBudget)
+        evictSSE();
+}
+
+SocketClass SocketBudget::classify(const String &resource)
+{
+    return resource.length() >= 5 && strncasecmp(resource.c_str(), "/API/", 5) == 0 ? SocketClass::API : SocketClass::STATIC;
+}
+
+bool SocketBudget::takeIdleEviction()
+{
+    Lock lock(cs);
+    if (pendingIdleEvictions == 0)
+        return false;
+    pendingIdleEvictions--;
+    stats.idleEvictions++;
+    return true;
+}
+
+void SocketBudget::addSSEEvictor(SSEEvictor evictor, SSEOldestAge oldestAge, void *context)
+{
+    Lock lock(cs);
+    if (nSSEOwners < SOCKET_BUDGET_MAX_SSE_EVICTORS)
+        sseOwners[nSSEOwners++] = { evictor, oldestAge, context };
+}
+
+bool SocketBudget::evictSSE()
+{
+    SSEOwner owners[SOCKET_BUDGET_MAX_SSE_EVICTORS];
+    int nOwners;
+    {
+        Lock lock(cs);
+        nOwners = nSSEOwners;
+        memcpy(owners, sseOwners, sizeof(SSEOwner) * nOwners);
+    }
+
+    // The owners close their streams out of the lock, since closing a stream releases its socket.
+    // The streams of all the owners share the budget, so the oldest stream is closed, whichever owner it belongs to.
+    const SSEOwner *oldest = NULL;
+    unsigned long oldestAge = 0;
+    for (int i = 0; i < nOwners; i++)
+    {
+        unsigned long age;
+        if (owners[i].oldestAge(owners[i].context, age) && (oldest == NULL || age > oldestAge))
+        {
+            oldest = &owners[i];
+            oldestAge = age;
+        }
+    }
+    if (oldest == NULL || !oldest->evictor(oldest->context))
+        return false;
+
+    Lock lock(cs);
+    stats.sseEvictions++;
+    return true;
+}
+
+bool SocketBudget::makeRoom()
+{
+    if (getFreeSockets() != 0)
+        return true;
+
+#ifdef DEBUG_ETHERNET
+    Traceln("SocketBudget: No free socket, evicting an idle connection");
+#endif
+    {
+        Lock lock(cs);
+        pendingIdleEvictions++;
+    }
+    // Idle persistent connections check for evictions every few milliseconds
+    bool available = false;
+    unsigned long t0 = millis();
+    while (!(available = getFreeSockets() != 0) && millis() - t0 < SOCKET_BUDGET_EVICTION_TIMEOUT)
+        delay(10);
+    if (!available)
+    {
+        // No idle connection took the eviction, withdraw it
+        {
+            Lock lock(cs);
+            if (pendingIdleEvictions > 0)
+                pendingIdleEvictions--;
+        }
+#ifdef DEBUG_ETHERNET
+        Traceln("SocketBudget: No idle connection, evicting the oldest SSE stream");
+#endif
+        available = evictSSE() && getFreeSockets() != 0;
+    }
+
+    return available;
+}
+
+void SocketBudget::getStats(Stats &stats)
+{
+    {
+        Lock lock(cs);
+        stats = SocketBudget::stats;
+    }
+    stats.freeSockets = getFreeSockets();
+}
@@ -23,6 +23,9 @@
 #include <Trace.h>
 #endif
 #include <HttpHeaders.h>
+#include <FileCache.h>
+#include <HTTPServer.h>
+#include <SocketBudget.h>
 #include <atomic>
 
 bool SystemController::sendVersionInfo(HttpClientContext &context)
@@ -34,12 +37,87 @@ bool SystemController::sendVersionInfo(HttpClientContext &context)
 
     // Prepare the HTTP headers for the response.
     HttpHeaders::Header additionalHeaders[] = {{CONTENT_TYPE::JSON}, {"Access-Control-Allow-Origin", "*"}};
-    HttpHeaders headers(context.getClient());
-    // Send the HTTP response headers.
-    headers.sendHeaderSection(200, true, additionalHeaders, NELEMS(additionalHeaders), versionJson.length());
+    HttpHeaders headers(context);
+    // Send the HTTP response headers along with the JSON response body.
+    headers.sendResponse(200, additionalHeaders, NELEMS(additionalHeaders), versionJson);
 
-    // Send the JSON response body.
-    context.getClient().print(versionJson.c_str());
+    return true;
+}
+
+bool SystemController::sendCacheInfo(HttpClientContext &context)
+{
+    // Get the file cache statistics.
+    FileCache::Stats stats;
+    FileCache::getStats(stats);
+    // Construct the JSON response.
+    String cacheJson = String("{ \"Hits\" : ") + stats.hits +
+        ", \"Misses\" : " + stats.misses +
+        ", \"Evictions\" : " + stats.evictions +
+        ", \"Files\" : " + stats.entries +
+        ", \"Bytes\" : " + stats.bytes +
+        ", \"Missing\" : " + stats.missing +
+        ", \"Capacity\" : " + FILE_CACHE_SIZE + " }";
+
+    // Prepare the HTTP headers for the response.
+    HttpHeaders::Header additionalHeaders[] = {{CONTENT_TYPE::JSON}, {"Access-Control-Allow-Origin", "*"}, {"Cache-Control", "no-cache"}};
+    HttpHeaders headers(context);
+    // Send the HTTP response headers along with the JSON response body.
+    headers.sendResponse(200, additionalHeaders, NELEMS(additionalHeaders), cacheJson);
+
+    return true;
+}
+
+bool SystemController::sendServerInfo(HttpClientContext &context)
+{
+    // Get the admission statistics of the HTTP server.
+    HTTPServer::AdmissionStats stats;
+    HTTPServer::getAdmissionStats(stats);
+    // Construct the JSON response.
+    String serverJson = String("{ \"Accepted\" : ") + stats.accepted +
+        ", \"Rejected\" : " + stats.rejected +
+        ", \"Expired\" : " + stats.expired +
+        ", \"Queued\" : " + stats.queued +
+        ", \"MaxQueued\" : " + stats.maxQueued +
+        ", \"QueueDepth\" : " + HTTP_REQUESTS_QUEUE_DEPTH +
+        ", \"Workers\" : " + HTTP_WORKERS_POOL_SIZE + " }";
+
+    // Prepare the HTTP headers for the response.
+    HttpHeaders::Header additionalHeaders[] = {{CONTENT_TYPE::JSON}, {"Access-Control-Allow-Origin", "*"}, {"Cache-Control", "no-cache"}};
+    HttpHeaders headers(context);
+    // Send the HTTP response headers along with the JSON response body.
+    headers.sendResponse(200, additionalHeaders, NELEMS(additionalHeaders), serverJson);
+
+    return true;
+}
+
+bool SystemController::sendSocketsInfo(HttpClientContext &context)
+{
+    // Get the statistics of the socket budget.
+    SocketBudget::Stats stats;
+    SocketBudget::getStats(stats);
+    // Construct the JSON response.
+    String socketsJson = String("{ \"Sockets\" : ") + SOCKET_BUDGET_SOCKETS +
+        ", \"HttpSockets\" : " + SOCKET_BUDGET_HTTP_SOCKETS +
+        ", \"Free\" : " + stats.freeSockets +
+        ", \"IdleEvictions\" : " + stats.idleEvictions +
+        ", \"SSEEvictions\" : " + stats.sseEvictions +
+        ", \"Classes\" : {";
+    for (int i = 0; i < static_cast<int>(SocketClass::COUNT); i++)
+    {
+        const SocketBudget::ClassStats &classStats = stats.classes[i];
+        socketsJson += String(i == 0 ? " \"" : ", \"") + SocketBudget::getClassName(static_cast<SocketClass>(i)) +
+            "\" : { \"InUse\" : " + classStats.inUse +
+            ", \"Peak\" : " + classStats.peak +
+            ", \"Acquired\" : " + classStats.acquired +
+            ", \"Denied\" : " + classStats.denied + " }";
+    }
+    socketsJson += " } }";
+
+    // Prepare the HTTP headers for the response.
+    HttpHeaders::Header additionalHeaders[] = {{CONTENT_TYPE::JSON}, {"Access-Control-Allow-Origin", "*"}, {"Cache-Control", "no-cache"}};
+    HttpHeaders headers(context);
+    // Send the HTTP response headers along with the JSON response body.
+    headers.sendResponse(200, additionalHeaders, NELEMS(additionalHeaders), socketsJson);
 
     return true;
 }
@@ -20,6 +20,7 @@
 #ifndef USE_WIFI
 #include <EthernetUtil.h>
 #include <NTPClient.h>
+#include <SocketBudget.h>
 #include <sys/time.h>
 #endif
 #include <TimeUtil.h>
@@ -53,6 +54,8 @@ static void setTime(bool ignoreFailure)
 #else
   // Use Ethernet to get the time
   unsigned long t0 = millis();
+  // Make sure there is a socket for the time queries
+  SocketBudget::Lease lease(SocketClass::NAME);
   EthUDP ntpUDP;
   NTPClient ntpClient(ntpUDP, Config::timeServer, Config::timeZone * 60 + (DST ? (Config::DST * 60) : 0), Config::timeUpdatePeriodMin * 60 * 1000);
   ntpClient.begin();
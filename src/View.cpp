@@ -19,48 +19,105 @@
 #include <Common.h>
 #include <View.h>
 #include <HttpHeaders.h>
-#include <HttpServer.h>
+#include <HTTPServer.h>
 #ifdef DEBUG_HTTP_SERVER
 #include <Trace.h>
 #endif
 
-bool View::Get(HttpClientContext &context, const String id)
+/// @brief The size of the buffer that the view is read into.
+#define VIEW_BUFF_SIZE 256
+/// @brief Room that is reserved before the view data for the end of the previous chunk and the size line
+/// of the next chunk, "\r\nXXXXXXXX\r\n", when the view is sent with the chunked transfer encoding.
+#define CHUNK_PREFIX_SIZE 12
+
+/// @brief Writes the end of the previous chunk and the size line of the next chunk right before the chunk data.
+/// @param data The chunk data. At least CHUNK_PREFIX_SIZE bytes before it are reserved for the prefix.
+/// @param size The size of the chunk data.
+/// @param first True if this is the first chunk of the body.
+/// @return The length of the prefix.
+static int writeChunkPrefix(byte *data, int size, bool first)
+{
+    char prefix[CHUNK_PREFIX_SIZE + 1];
+    int len = snprintf(prefix, sizeof(prefix), "%s%x\r\n", first ? "" : "\r\n", size);
+    memcpy(data - len, prefix, len);
+    return len;
+}
+
+/// @brief Checks the validators of a view against the conditional headers of the request.
+/// @param context The context of the request.
+/// @param etag The entity tag of the view, or an empty string if it has none.
+/// @param lastModifiedTime The last modified time of the view, or an empty string if it is not known.
+/// @return true if the copy of the view that the client has is up to date.
+static bool isNotModified(HttpClientContext &context, const String &etag, const String &lastModifiedTime)
 {
-    EthClient client = context.getClient();
+    String ifNoneMatch = context.getIfNoneMatch();
+    if (!ifNoneMatch.isEmpty())
+        // If-None-Match takes precedence over If-Modified-Since.
+        // It may hold a list of entity tags, or "*".
+        return !etag.isEmpty() && (ifNoneMatch.equals("*") || ifNoneMatch.indexOf(etag) != -1);
+
+    return !lastModifiedTime.isEmpty() && context.getLastModified().equals(lastModifiedTime);
+}
+
+/// @brief Traces a 304 Not Modified response.
+static void traceNotModified(HttpClientContext &context)
+{
+#ifdef DEBUG_HTTP_SERVER
+    TRACE_BLOCK
+    {
+        Tracef("%d ", context.getClient().remotePort());
+        Trace("Resource: ");
+        Trace(context.getResource());
+        Trace(" File was not modified. ");
+        Traceln(context.getIfNoneMatch().isEmpty() ? context.getLastModified() : context.getIfNoneMatch());
+    }
+#endif
+}
 
+bool View::Get(HttpClientContext &context, const String id)
+{
     // Check if redirect is needed.
     // If the redirect is successful, it will send the redirect response and return true.
     // Otherwise, it will return false, and we will proceed to read the view.
-    if (redirect(client, id))
+    if (redirect(context, id))
         return true;
 
     // Open the view and pass it a buffer to read the view data.
-    byte buff[256];
-    if (!viewReader->open(buff, sizeof(buff)))
+    // The buffer is preceded by room for the size line of a chunk.
+    byte chunk[CHUNK_PREFIX_SIZE + VIEW_BUFF_SIZE];
+    byte *buff = chunk + CHUNK_PREFIX_SIZE;
+    // Let the view reader know whether it may read a gzip compressed view.
+    viewReader->setGzipAccepted(context.acceptsGzip());
+
+    // Check if the view was modified since the last request.
+    // When the validators of the view are cached, there is no need to open the view for that.
+    bool conditional = !context.getIfNoneMatch().isEmpty() || !context.getLastModified().isEmpty();
+    String etag;
+    String lastModifiedTime;
+    if (conditional && viewReader->getCachedValidators(etag, lastModifiedTime) && isNotModified(context, etag, lastModifiedTime))
     {
-        return false;
+        // If the validators match, we can return a 304 Not Modified response.
+        traceNotModified(context);
+        HTTPServer::NotModified(context, etag);
+        return true;
     }
 
-    // Check if the view was modified since the last request.
-    if (!context.getLastModified().isEmpty())
+    if (!viewReader->open(buff, VIEW_BUFF_SIZE))
     {
-        String lastModifiedTime;
+        return false;
+    }
 
+    etag = "";
+    viewReader->getETag(etag);
+    if (conditional)
+    {
+        lastModifiedTime = "";
         viewReader->getLastModifiedTime(lastModifiedTime);
-        if (context.getLastModified().equals(lastModifiedTime))
+        if (isNotModified(context, etag, lastModifiedTime))
         {
-            // If the last modified time matches, we can return a 304 Not Modified response.
-#ifdef DEBUG_HTTP_SERVER
-            TRACE_BLOCK
-	        {
-                Tracef("%d ", context.getClient().remotePort());
-                Trace("Resource: ");
-                Trace(context.getResource());
-                Trace(" File was not modified. ");
-                Traceln(context.getLastModified());
-            }
-#endif
-            HTTPServer::NotModified(client);
+            // If the validators match, we can return a 304 Not Modified response.
+            traceNotModified(context);
+            HTTPServer::NotModified(context, etag);
             viewReader->close();
             return true;
         }
@@ -79,13 +136,28 @@ bool View::Get(HttpClientContext &context, const String id)
     }
 
     // Prepare the headers to send.
+    // When the size of the view is not known in advance, the view is sent in chunks.
+    // HTTP/1.0 clients do not support chunks, so the end of the view is marked by closing the connection.
     long size = viewReader->getViewSize();
+    bool chunked = size < 0 && context.getHttpVersion().equals("HTTP/1.1");
+    if (size < 0 && !chunked)
+        context.closeAfterResponse();
 
-    // Prepare two additional headers, one for the content type and one for the last modified time.
+    // Prepare the additional headers, one for the content type and one for the last modified time.
     // If the content type is HTML, we will not send the last modified time header.
     // This is because HTML files are often dynamically generated and may not have a last modified time.
     // For other content types, we will send the last modified time header if it is available.
-    HttpHeaders::Header additionalHeaders[] = { {type}, {} };
+    // The rest of the headers are for the transfer encoding, the content encoding and the entity tag, if required.
+    HttpHeaders::Header additionalHeaders[] = { {type}, {}, {}, {}, {}, {} };
+    if (!etag.isEmpty())
+        additionalHeaders[5] = {"ETag", etag};
+    if (chunked)
+        additionalHeaders[2] = {"Transfer-Encoding", "chunked"};
+    if (viewReader->isGzipEncoded())
+        additionalHeaders[3] = {"Content-Encoding", "gzip"};
+    // Caches should keep the compressed and the uncompressed views apart.
+    if (viewReader->supportsGzip())
+        additionalHeaders[4] = {"Vary", "Accept-Encoding"};
     if (type != CONTENT_TYPE::HTML)
     {
         String lastModifiedTime;
@@ -96,16 +168,61 @@ bool View::Get(HttpClientContext &context, const String id)
     }
 
     // Send the headers to the client.
-    HttpHeaders headers(client);
+    HttpHeaders headers(context);
     headers.sendHeaderSection(200, true, additionalHeaders, NELEMS(additionalHeaders), size);
 
     // Pump the response body to the client.
+    // The writes go through the context, so a client that does not receive the response expires the request.
+    // A response that is cut short must not be followed by another request on the connection.
     long bytesSent = 0;
-    while (bytesSent < size)
+    // A view of a known size is sent directly by the view reader, if it can.
+    // It accounts for the body in the metrics of the server and in the deadline of the request.
+    long directlySent = size >= 0 ? viewReader->send(context, size) : -1;
+    if (directlySent >= 0)
     {
-        int nBytes = viewReader->read();
-        client.write(buff, nBytes);
-        bytesSent += nBytes;
+        bytesSent = directlySent;
+        if (directlySent < size)
+            context.closeAfterResponse();
+    }
+    else if (size >= 0)
+    {
+        while (bytesSent < size)
+        {
+            int nBytes = viewReader->read();
+            if (nBytes <= 0)
+            {
+                context.closeAfterResponse();
+                break;
+            }
+            if (context.write(buff, nBytes) != (size_t)nBytes || context.isExpired())
+            {
+                context.closeAfterResponse();
+                break;
+            }
+            bytesSent += nBytes;
+        }
+    }
+    else
+    {
+        bool completed = true;
+        for (int nBytes = viewReader->read(); nBytes > 0; nBytes = viewReader->read())
+        {
+            // Send the chunk with its size line in a single write
+            int prefixLen = chunked ? writeChunkPrefix(buff, nBytes, bytesSent == 0) : 0;
+            if (context.write(buff - prefixLen, prefixLen + nBytes) != (size_t)(prefixLen + nBytes) || context.isExpired())
+            {
+                context.closeAfterResponse();
+                completed = false;
+                break;
+            }
+            bytesSent += nBytes;
+        }
+        // Send the last chunk
+        if (chunked && completed)
+        {
+            const char *lastChunk = bytesSent == 0 ? "0\r\n\r\n" : "\r\n0\r\n\r\n";
+            context.write((const uint8_t *)lastChunk, strlen(lastChunk));
+        }
     }
 
 #ifdef DEBUG_HTTP_SERVER
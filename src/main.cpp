@@ -33,6 +33,9 @@
 #include <PwrCntl.h>
 #include <Buttons.h>
 
+/// @brief The time, in milliseconds, between the iterations of the program loop
+#define LOOP_INTERVAL 50
+
 /// @brief Sets indicators to reflect initialization progress.
 /// @param last If true, indicates the last step of initialization.
 void initProgress(bool last = false)
@@ -77,7 +80,8 @@ void setup() {
   InitFileTrace();
   InitControllers();
   InitHttpControllers();
-  InitHTTPServer();
+  // Requests are served only while the gateway is reachable
+  InitHTTPServer([]() { return gwConnTest.IsConnected(); });
   hardResetEvent.addObserver([](const HardResetEventParam &param, void *context)
   {
       switch (param.stage)
@@ -98,10 +102,9 @@ void setup() {
 void loop() 
 {
   MaintainEthernet();
-  if (gwConnTest.IsConnected())
-    DoHTTPService();
   PerformControllersCycles();
-  delay(1);
+  // Client connections are accepted by the HTTP server task, the loop only does periodic maintenance
+  delay(LOOP_INTERVAL);
 }
 
 CriticalSection csSpi;
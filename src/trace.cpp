@@ -23,6 +23,7 @@
 #include <TimeUtil.h>
 #include <queue>
 #include <PwrCntl.h>
+#include <LogStream.h>
 
 static char logFileName[80];
 
@@ -270,7 +271,7 @@ void InitFileTrace()
         1 - xPortGetCoreID());
 }
 
-/// @brief Function to log a message to the serial port and the log file.
+/// @brief Function to log a message to the serial port, the log file and the live log stream.
 /// @param message The message to log.
 /// @note This function locks the trace lock to ensure no trace messages are interleaved.
 /// @return The number of characters written to the serial port and log file.
@@ -285,6 +286,8 @@ size_t Trace(const char *message)
     messages.push(message);
     // Notify the file logger task that there is a new message to log (consume).
     xSemaphoreGive(logSem);
+    // Pass the message to the clients that tail the log, they do not wait for the file.
+    logStream.publish(message);
 
     return ret;
 };
@@ -54,6 +54,18 @@ uint16_t W5100ClassEx::getRXReceivedSize(SOCKET s)
   return val;
 }
 
+uint16_t W5100ClassEx::getTXFreeSize(SOCKET s)
+{
+  uint16_t val=0,val1=0;
+  do {
+    val1 = readSnTX_FSR(s);
+    if (val1 != 0)
+      val = readSnTX_FSR(s);
+  } 
+  while (val != val1);
+  return val;
+}
+
 void W5100ClassEx::read_data(SOCKET s, volatile uint16_t src, volatile uint8_t *dst, uint16_t len)
 {
   uint16_t size;
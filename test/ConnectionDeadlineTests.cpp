@@ -0,0 +1,65 @@
+#include "ConnectionDeadlineTests.h"
+#include <ConnectionDeadline.h>
+#include <unity.h>
+
+void connectionDeadlineIdleTests()
+{
+    ConnectionDeadline deadline;
+    deadline.restart();
+    TEST_ASSERT_FALSE_MESSAGE(deadline.isExpired(), "Expected a new request not to be expired");
+    TEST_ASSERT_FALSE_MESSAGE(deadline.isExpired(HTTP_IDLE_TIMEOUT - 1), "Expected a wait shorter than the idle timeout not to expire the request");
+    TEST_ASSERT_TRUE_MESSAGE(deadline.isExpired(HTTP_IDLE_TIMEOUT), "Expected a wait of the idle timeout to expire the request");
+
+    // Time that is not spent waiting for the client does not count
+    deadline.restart();
+    deadline.progress(1);
+    TEST_ASSERT_FALSE_MESSAGE(deadline.isExpired(), "Expected a request that was not waited for not to be expired");
+}
+
+void connectionDeadlineRateTests()
+{
+    ConnectionDeadline deadline;
+    deadline.restart();
+    // A trickle of data within the grace period is fine
+    for (int i = 0; i < HTTP_RATE_GRACE_PERIOD / 500; i++)
+    {
+        deadline.waited(500);
+        deadline.progress(1);
+        TEST_ASSERT_FALSE_MESSAGE(deadline.isExpired(), "Expected the rate not to be enforced within the grace period");
+    }
+    // After the grace period, a byte every half a second is too slow
+    deadline.waited(500);
+    deadline.progress(1);
+    TEST_ASSERT_TRUE_MESSAGE(deadline.isExpired(), "Expected a trickling client to be expired");
+
+    // The wait that is in progress counts too
+    deadline.restart();
+    deadline.waited(HTTP_RATE_GRACE_PERIOD);
+    deadline.progress(HTTP_MIN_BYTE_RATE);
+    TEST_ASSERT_FALSE(deadline.isExpired(999));
+    TEST_ASSERT_TRUE(deadline.isExpired(1001));
+
+    // A client that keeps up the minimal rate is not expired, however long the request takes
+    deadline.restart();
+    for (int i = 0; i < 600; i++)
+    {
+        deadline.waited(100);
+        deadline.progress(HTTP_MIN_BYTE_RATE / 10);
+        TEST_ASSERT_FALSE_MESSAGE(deadline.isExpired(), "Expected a client at the minimal rate not to be expired");
+    }
+    TEST_ASSERT_EQUAL(600 * (HTTP_MIN_BYTE_RATE / 10), deadline.getTransferred());
+    TEST_ASSERT_EQUAL(60000, deadline.getWaitTime());
+}
+
+void connectionDeadlineRestartTests()
+{
+    ConnectionDeadline deadline;
+    deadline.restart();
+    deadline.waited(HTTP_RATE_GRACE_PERIOD * 2);
+    TEST_ASSERT_TRUE(deadline.isExpired());
+    // The next request on a persistent connection starts a new deadline
+    deadline.restart();
+    TEST_ASSERT_FALSE(deadline.isExpired());
+    TEST_ASSERT_EQUAL(0, deadline.getTransferred());
+    TEST_ASSERT_EQUAL(0, deadline.getWaitTime());
+}
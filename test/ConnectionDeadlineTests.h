@@ -0,0 +1,8 @@
+#ifndef ConnectionDeadlineTests_h
+#define ConnectionDeadlineTests_h
+
+void connectionDeadlineIdleTests();
+void connectionDeadlineRateTests();
+void connectionDeadlineRestartTests();
+
+#endif // ConnectionDeadlineTests_h
@@ -0,0 +1,70 @@
+#include <SDUtil.h>
+
+// The SD card and the files of SDUtil and FileEx, over the fake SD card.
+
+SPIClass SPI;
+std::map<std::string, std::string> FakeSD::files;
+int FakeSD::opens = 0;
+int FakeSD::existsChecks = 0;
+
+int SDExClass::count = 0;
+SDExClass SDEx;
+
+AutoSD::AutoSD() { SD.begin(); }
+AutoSD::~AutoSD() { SD.end(); }
+
+bool SDExClass::begin(uint8_t ssPin, SPIClass &spi, uint32_t frequency, const char *mountpoint, uint8_t max_files) { count++; return true; }
+void SDExClass::end() { count--; }
+sdcard_type_t SDExClass::cardType() { return CARD_SDHC; }
+uint64_t SDExClass::cardSize() { return 0; }
+uint64_t SDExClass::totalBytes() { return 0; }
+uint64_t SDExClass::usedBytes() { return 0; }
+
+File SDExClass::open(const char *path, const char *mode)
+{
+    std::map<std::string, std::string>::iterator i = FakeSD::files.find(path);
+    if (i == FakeSD::files.end())
+        return File();
+    FakeSD::opens++;
+    return File(path, i->second, 0);
+}
+
+File SDExClass::open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+
+bool SDExClass::exists(const char *path)
+{
+    FakeSD::existsChecks++;
+    return FakeSD::files.find(path) != FakeSD::files.end();
+}
+
+bool SDExClass::exists(const String &path) { return exists(path.c_str()); }
+bool SDExClass::remove(const char *path) { return FakeSD::files.erase(path) > 0; }
+bool SDExClass::remove(const String &path) { return remove(path.c_str()); }
+bool SDExClass::rename(const char *pathFrom, const char *pathTo) { return false; }
+bool SDExClass::rename(const String &pathFrom, const String &pathTo) { return false; }
+bool SDExClass::mkdir(const char *path) { return true; }
+bool SDExClass::mkdir(const String &path) { return true; }
+bool SDExClass::rmdir(const char *path) { return true; }
+bool SDExClass::rmdir(const String &path) { return true; }
+
+FileEx &FileEx::operator=(const File &file) { File::operator=(file); return *this; }
+size_t FileEx::write(uint8_t byte) { return File::write(byte); }
+size_t FileEx::write(const uint8_t *buf, size_t size) { return File::write(buf, size); }
+int FileEx::available() { return File::available(); }
+int FileEx::read() { return File::read(); }
+int FileEx::peek() { return File::peek(); }
+void FileEx::flush() { File::flush(); }
+size_t FileEx::read(uint8_t *buf, size_t size) { return File::read(buf, size); }
+size_t FileEx::readBytes(char *buffer, size_t length) { return File::readBytes(buffer, length); }
+bool FileEx::seek(uint32_t pos, SeekMode mode) { return File::seek(pos, mode); }
+bool FileEx::seek(uint32_t pos) { return File::seek(pos); }
+size_t FileEx::position() const { return File::position(); }
+size_t FileEx::size() const { return File::size(); }
+void FileEx::close() { File::close(); }
+FileEx::operator bool() const { return File::operator bool(); }
+time_t FileEx::getLastWrite() { return File::getLastWrite(); }
+const char *FileEx::path() const { return File::path(); }
+const char *FileEx::name() const { return File::name(); }
+boolean FileEx::isDirectory(void) { return File::isDirectory(); }
+FileEx FileEx::openNextFile(const char *mode) { return File::openNextFile(mode); }
+void FileEx::rewindDirectory(void) { File::rewindDirectory(); }
@@ -0,0 +1,130 @@
+#include "FileViewReaderTests.h"
+#include <SD.h>
+#include <FileViewReader.h>
+#include <FileViewReader.cpp>
+#include <FileCache.cpp>
+#include <FileValidatorsCache.cpp>
+#include <EmbeddedAssets.cpp>
+#include <unity.h>
+
+// No file is embedded in the firmware of the tests, all the files are read from the fake SD card.
+const EmbeddedAsset *const EmbeddedAssets::assets = NULL;
+const size_t EmbeddedAssets::nAssets = 0;
+
+/// @brief Opens the view reader of a file the way a view does, and reads all of it.
+class TestFileViewReader : public FileViewReader
+{
+public:
+    using FileViewReader::isGzipEncoded;
+
+    TestFileViewReader(const String &path, bool gzipAccepted) : FileViewReader(path)
+    {
+        setGzipAccepted(gzipAccepted);
+    }
+
+    /// @brief Reads the file.
+    /// @param content Returns the content of the file.
+    /// @return false if the file could not be opened.
+    bool readAll(std::string &content)
+    {
+        byte buff[16];
+        if (!open(buff, sizeof(buff)))
+            return false;
+        for (int nBytes = read(0); nBytes > 0; nBytes = read(0))
+            content.append(reinterpret_cast<const char *>(buff), nBytes);
+        close();
+        return true;
+    }
+};
+
+void fileViewReaderGzipAfterPlainCachedTests()
+{
+    FakeSD::clear();
+    FakeSD::put("/wwwroot/APP.JS", "plain content of the script");
+    FakeSD::put("/wwwroot/APP.JS.GZ", "gzip content");
+    FileCache::invalidate("/wwwroot/APP.JS");
+
+    // A client that does not accept gzip gets the plain file, and the file is cached
+    std::string content;
+    TestFileViewReader plainReader("/APP.JS", false);
+    TEST_ASSERT_TRUE(plainReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING("plain content of the script", content.c_str());
+    TEST_ASSERT_FALSE(plainReader.isGzipEncoded());
+
+    // A client that accepts gzip gets the compressed copy, even though the plain file is cached
+    content.clear();
+    TestFileViewReader gzipReader("/APP.JS", true);
+    TEST_ASSERT_TRUE(gzipReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("gzip content", content.c_str(), "Expected the compressed copy rather than the cached plain file");
+    TEST_ASSERT_TRUE(gzipReader.isGzipEncoded());
+
+    // Both copies are cached now, the SD card is not accessed again
+    int opens = FakeSD::opens;
+    content.clear();
+    TestFileViewReader cachedReader("/APP.JS", true);
+    TEST_ASSERT_TRUE(cachedReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING("gzip content", content.c_str());
+    TEST_ASSERT_EQUAL(opens, FakeSD::opens);
+}
+
+void fileViewReaderNoGzipCopyTests()
+{
+    FakeSD::clear();
+    FakeSD::put("/wwwroot/STYLE.CSS", "plain content of the style");
+    FileCache::invalidate("/wwwroot/STYLE.CSS");
+
+    // A client that accepts gzip gets the plain file when there is no compressed copy
+    std::string content;
+    TestFileViewReader firstReader("/STYLE.CSS", true);
+    TEST_ASSERT_TRUE(firstReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING("plain content of the style", content.c_str());
+    TEST_ASSERT_FALSE(firstReader.isGzipEncoded());
+
+    // The missing compressed copy is remembered, so the cached plain file is served without accessing the SD card
+    int existsChecks = FakeSD::existsChecks;
+    int opens = FakeSD::opens;
+    content.clear();
+    TestFileViewReader secondReader("/STYLE.CSS", true);
+    TEST_ASSERT_TRUE(secondReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING("plain content of the style", content.c_str());
+    TEST_ASSERT_EQUAL(existsChecks, FakeSD::existsChecks);
+    TEST_ASSERT_EQUAL(opens, FakeSD::opens);
+
+    // A compressed copy that is uploaded later is found once the cache is invalidated
+    FakeSD::put("/wwwroot/STYLE.CSS.GZ", "gzip content");
+    FileCache::invalidate("/wwwroot/STYLE.CSS");
+    content.clear();
+    TestFileViewReader thirdReader("/STYLE.CSS", true);
+    TEST_ASSERT_TRUE(thirdReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING("gzip content", content.c_str());
+}
+
+void fileViewReaderMissingFilesBoundTests()
+{
+    FakeSD::clear();
+    FakeSD::put("/wwwroot/INDEX.HTML", "plain content of the page");
+    FileCache::invalidate("/wwwroot");
+
+    // Each file that is asked for by a client that accepts gzip leaves a missing compressed copy behind
+    std::string content;
+    TestFileViewReader reader("/INDEX.HTML", true);
+    TEST_ASSERT_TRUE(reader.readAll(content));
+    TEST_ASSERT_TRUE(FileCache::isMissing("/wwwroot/INDEX.HTML.GZ"));
+
+    // Files that do not exist at all do not make the missing files grow without a bound
+    for (int i = 0; i < FILE_CACHE_MAX_MISSING * 2; i++)
+    {
+        TestFileViewReader missingReader(String("/NOPE") + i + ".HTML", true);
+        content.clear();
+        TEST_ASSERT_FALSE(missingReader.readAll(content));
+    }
+    FileCache::Stats stats;
+    FileCache::getStats(stats);
+    TEST_ASSERT_TRUE(stats.missing <= FILE_CACHE_MAX_MISSING);
+
+    // The files that were forgotten are looked for on the SD card again
+    content.clear();
+    TestFileViewReader againReader("/INDEX.HTML", true);
+    TEST_ASSERT_TRUE(againReader.readAll(content));
+    TEST_ASSERT_EQUAL_STRING("plain content of the page", content.c_str());
+}
@@ -0,0 +1,8 @@
+#ifndef FileViewReaderTests_h
+#define FileViewReaderTests_h
+
+void fileViewReaderGzipAfterPlainCachedTests();
+void fileViewReaderNoGzipCopyTests();
+void fileViewReaderMissingFilesBoundTests();
+
+#endif // FileViewReaderTests_h
@@ -115,3 +115,28 @@ void htmlFillerViewReaderWithNotEnoughSpaceForFillerTests()
         "This is a test string with %0 filler, but without enough space.", 
         "This is a test string with Mocfiller, but without enough space.");
 }
+
+void HtmlFillerViewReaderWithExpandedFillers(const String &mem, const String &expectedContent)
+{
+    ViewReader *mockViewReader = new MemViewReader(reinterpret_cast<const byte *>(mem.c_str()), mem.length(), CONTENT_TYPE::HTML);
+    HtmlFillerViewReader reader(std::unique_ptr<ViewReader>(mockViewReader), mockGetFillers, true);
+
+    TEST_ASSERT_EQUAL_MESSAGE(-1, reader.getViewSize(), "Expected unknown view size when fillers are expanded");
+    HtmlFillerViewReaderTestLoop(mem, expectedContent, reader);
+}
+
+void htmlFillerViewReaderExpandFillersTests()
+{
+    HtmlFillerViewReaderWithExpandedFillers(
+        mem,
+        "This%1is a t%est string% with Mock Filler1 and Mock Filler2 fillers.%");
+    HtmlFillerViewReaderWithExpandedFillers(
+        "This is a test string with %0 filler, %1   and %2 non existing filler.",
+        "This is a test string with Mock Filler1 filler, Mock Filler2 and %2 non existing filler.");
+    HtmlFillerViewReaderWithExpandedFillers(
+        "%0 %1 ",
+        "Mock Filler1 Mock Filler2 ");
+    HtmlFillerViewReaderWithExpandedFillers(
+        "Ends with a filler %1",
+        "Ends with a filler %1");
+}
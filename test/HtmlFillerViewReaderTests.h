@@ -5,5 +5,6 @@ void htmlFillerViewReaderBasicTests();
 void htmlFillerViewReaderWithVariousBuffLenTests();
 void htmlFillerViewReaderWithNonExistingFillerTests();
 void htmlFillerViewReaderWithNotEnoughSpaceForFillerTests();
+void htmlFillerViewReaderExpandFillersTests();
 
 #endif// HtmlFillerViewReaderTests_h
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "HttpRangeTests.h"
+#include <HttpRange.h>
+#include <unity.h>
+
+static void verifyRange(const char *value, size_t size, size_t expectedFirst, size_t expectedLast)
+{
+    size_t first = 0;
+    size_t last = 0;
+    TEST_ASSERT_TRUE_MESSAGE(HttpRange::parse(value, size, first, last) == HttpRange::Result::SATISFIABLE, value);
+    TEST_ASSERT_EQUAL_MESSAGE(expectedFirst, first, value);
+    TEST_ASSERT_EQUAL_MESSAGE(expectedLast, last, value);
+}
+
+static void verifyResult(const char *value, size_t size, HttpRange::Result expectedResult)
+{
+    size_t first = 0;
+    size_t last = 0;
+    TEST_ASSERT_TRUE_MESSAGE(HttpRange::parse(value, size, first, last) == expectedResult, value);
+}
+
+void httpRangeSatisfiableTests()
+{
+    verifyRange("bytes=0-99", 1000, 0, 99);
+    verifyRange("bytes=100-199", 1000, 100, 199);
+    verifyRange("BYTES=100-199", 1000, 100, 199);
+    verifyRange("bytes=900-", 1000, 900, 999);
+    verifyRange("bytes=999-999", 1000, 999, 999);
+    // The last byte position is limited to the size of the resource
+    verifyRange("bytes=500-5000", 1000, 500, 999);
+    // Suffix ranges
+    verifyRange("bytes=-100", 1000, 900, 999);
+    verifyRange("bytes=-5000", 1000, 0, 999);
+}
+
+void httpRangeUnsatisfiableTests()
+{
+    verifyResult("bytes=1000-", 1000, HttpRange::Result::UNSATISFIABLE);
+    verifyResult("bytes=1000-1999", 1000, HttpRange::Result::UNSATISFIABLE);
+    verifyResult("bytes=-0", 1000, HttpRange::Result::UNSATISFIABLE);
+    verifyResult("bytes=0-", 0, HttpRange::Result::UNSATISFIABLE);
+    verifyResult("bytes=-10", 0, HttpRange::Result::UNSATISFIABLE);
+}
+
+void httpRangeIgnoredTests()
+{
+    verifyResult("", 1000, HttpRange::Result::NONE);
+    verifyResult("items=0-99", 1000, HttpRange::Result::NONE);
+    verifyResult("bytes=", 1000, HttpRange::Result::NONE);
+    verifyResult("bytes=-", 1000, HttpRange::Result::NONE);
+    verifyResult("bytes=abc", 1000, HttpRange::Result::NONE);
+    verifyResult("bytes=200-100", 1000, HttpRange::Result::NONE);
+    // Multiple ranges are not supported, the entire resource is sent
+    verifyResult("bytes=0-99,200-299", 1000, HttpRange::Result::NONE);
+}
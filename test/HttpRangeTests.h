@@ -0,0 +1,8 @@
+#ifndef HttpRangeTests_h
+#define HttpRangeTests_h
+
+void httpRangeSatisfiableTests();
+void httpRangeUnsatisfiableTests();
+void httpRangeIgnoredTests();
+
+#endif // HttpRangeTests_h
@@ -0,0 +1,112 @@
+#include "IdHashTableTests.h"
+#include "FakeLock.h"
+#include <IdHashTable.h>
+#include <unity.h>
+
+typedef IdHashTable<int, 8> TestTable;
+
+static int findValue(TestTable &table, uint32_t id)
+{
+    int value = -1;
+    table.Find(id, [](int &v, void *param)
+    {
+        *static_cast<int *>(param) = v;
+    }, &value);
+    return value;
+}
+
+void idHashTableInsertTests()
+{
+    TestTable table;
+    TEST_ASSERT_EQUAL(0, table.Count());
+    TEST_ASSERT_FALSE(table.Contains(1));
+    TEST_ASSERT_TRUE(table.Insert(1, 10));
+    TEST_ASSERT_TRUE(table.Insert(2, 20));
+    TEST_ASSERT_TRUE(table.Insert(1000, 30));
+    TEST_ASSERT_EQUAL(3, table.Count());
+    TEST_ASSERT_EQUAL(10, findValue(table, 1));
+    TEST_ASSERT_EQUAL(20, findValue(table, 2));
+    TEST_ASSERT_EQUAL(30, findValue(table, 1000));
+    TEST_ASSERT_FALSE(table.Contains(3));
+    // Inserting an existing ID replaces its value
+    TEST_ASSERT_TRUE(table.Insert(2, 21));
+    TEST_ASSERT_EQUAL(3, table.Count());
+    TEST_ASSERT_EQUAL(21, findValue(table, 2));
+}
+
+void idHashTableDeleteTests()
+{
+    TestTable table;
+    for (uint32_t id = 1; id <= 6; id++)
+        table.Insert(id, id * 10);
+    TEST_ASSERT_FALSE(table.Delete(7));
+    TEST_ASSERT_TRUE(table.Delete(3));
+    TEST_ASSERT_FALSE(table.Contains(3));
+    TEST_ASSERT_EQUAL(5, table.Count());
+    // The rest of the values are still found after the values that followed them were moved back
+    for (uint32_t id : { 1, 2, 4, 5, 6 })
+        TEST_ASSERT_EQUAL(id * 10, findValue(table, id));
+    for (uint32_t id : { 1, 2, 4, 5, 6 })
+        TEST_ASSERT_TRUE(table.Delete(id));
+    TEST_ASSERT_EQUAL(0, table.Count());
+    // The value is handed to the action before it is deleted
+    table.Insert(7, 70);
+    int deleted = -1;
+    TEST_ASSERT_TRUE(table.Delete(7, [](int &value, void *param)
+    {
+        *static_cast<int *>(param) = value;
+    }, &deleted));
+    TEST_ASSERT_EQUAL(70, deleted);
+    TEST_ASSERT_FALSE(table.Contains(7));
+    // Deleted slots are reused
+    for (uint32_t id = 100; id < 108; id++)
+        TEST_ASSERT_TRUE(table.Insert(id, id));
+    for (uint32_t id = 100; id < 108; id++)
+        TEST_ASSERT_EQUAL(id, findValue(table, id));
+}
+
+void idHashTableFullTests()
+{
+    TestTable table;
+    for (uint32_t id = 0; id < 8; id++)
+        TEST_ASSERT_TRUE(table.Insert(id * 8, id));
+    TEST_ASSERT_FALSE_MESSAGE(table.Insert(100, 100), "Expected a full table to refuse a new ID");
+    TEST_ASSERT_FALSE(table.Contains(100));
+    TEST_ASSERT_FALSE(table.Delete(100));
+    TEST_ASSERT_TRUE_MESSAGE(table.Insert(16, 50), "Expected a full table to replace the value of an existing ID");
+    TEST_ASSERT_EQUAL(50, findValue(table, 16));
+    TEST_ASSERT_TRUE(table.Delete(16));
+    TEST_ASSERT_TRUE(table.Insert(100, 100));
+    for (uint32_t id = 0; id < 8; id++)
+    {
+        if (id != 2)
+            TEST_ASSERT_EQUAL(id, findValue(table, id * 8));
+    }
+    TEST_ASSERT_EQUAL(100, findValue(table, 100));
+}
+
+void idHashTableScanNodesTests()
+{
+    TestTable table;
+    for (uint32_t id = 1; id <= 5; id++)
+        table.Insert(id, id);
+
+    int sum = 0;
+    table.ScanNodes([](uint32_t id, int &value, void *param) -> bool
+    {
+        TEST_ASSERT_EQUAL(id, value);
+        *static_cast<int *>(param) += value;
+        value *= 2;
+        return true;
+    }, &sum);
+    TEST_ASSERT_EQUAL(15, sum);
+    TEST_ASSERT_EQUAL(8, findValue(table, 4));
+
+    // The scan stops when the action returns false
+    int visited = 0;
+    table.ScanNodes([](uint32_t id, int &value, void *param) -> bool
+    {
+        return ++*static_cast<int *>(param) < 2;
+    }, &visited);
+    TEST_ASSERT_EQUAL(2, visited);
+}
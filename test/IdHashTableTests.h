@@ -0,0 +1,9 @@
+#ifndef IdHashTableTests_h
+#define IdHashTableTests_h
+
+void idHashTableInsertTests();
+void idHashTableDeleteTests();
+void idHashTableFullTests();
+void idHashTableScanNodesTests();
+
+#endif // IdHashTableTests_h
@@ -0,0 +1,119 @@
+#include "LogStreamTests.h"
+#include <LogStream.h>
+#include <LogStream.cpp>
+#include <unity.h>
+
+/// @brief Takes all the queued events of a subscriber.
+static String takeAll(LogStream &stream, int subscriber)
+{
+    char buff[LOG_STREAM_BUFF_SIZE + 1];
+    size_t size = stream.peek(subscriber, buff, LOG_STREAM_BUFF_SIZE);
+    stream.consume(subscriber, size);
+    buff[size] = '\0';
+    return String(buff);
+}
+
+void logStreamClassifyTests()
+{
+    LogLevel level;
+    LogCategory category;
+
+    LogStream::classify("W (1234) wifi: timeout", level, category);
+    TEST_ASSERT_EQUAL(static_cast<int>(LogLevel::Warning), static_cast<int>(level));
+    TEST_ASSERT_EQUAL(static_cast<int>(LogCategory::Esp), static_cast<int>(category));
+
+    LogStream::classify("[  1234][E][WiFiClient.cpp:42] write(): fail", level, category);
+    TEST_ASSERT_EQUAL(static_cast<int>(LogLevel::Error), static_cast<int>(level));
+    TEST_ASSERT_EQUAL(static_cast<int>(LogCategory::Esp), static_cast<int>(category));
+
+    // The traces of the application have no level
+    LogStream::classify("Router recovery started", level, category);
+    TEST_ASSERT_EQUAL(static_cast<int>(LogLevel::Info), static_cast<int>(level));
+    TEST_ASSERT_EQUAL(static_cast<int>(LogCategory::App), static_cast<int>(category));
+    LogStream::classify("[config] X (1) is not a level", level, category);
+    TEST_ASSERT_EQUAL(static_cast<int>(LogCategory::App), static_cast<int>(category));
+    LogStream::classify("", level, category);
+    TEST_ASSERT_EQUAL(static_cast<int>(LogCategory::App), static_cast<int>(category));
+}
+
+void logStreamFilterTests()
+{
+    LogFilter filter;
+    TEST_ASSERT_TRUE(filter.parse(""));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Verbose, LogCategory::App));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Verbose, LogCategory::Esp));
+
+    TEST_ASSERT_TRUE(filter.parse("w"));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Error, LogCategory::Esp));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Warning, LogCategory::App));
+    TEST_ASSERT_FALSE(filter.matches(LogLevel::Info, LogCategory::App));
+
+    TEST_ASSERT_TRUE(filter.parse("ESP/DEBUG/"));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Debug, LogCategory::Esp));
+    TEST_ASSERT_FALSE(filter.matches(LogLevel::Verbose, LogCategory::Esp));
+    TEST_ASSERT_FALSE_MESSAGE(filter.matches(LogLevel::Error, LogCategory::App), "Expected only the ESP category to pass");
+
+    TEST_ASSERT_TRUE(filter.parse("APP/ESP"));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Info, LogCategory::App));
+    TEST_ASSERT_TRUE(filter.matches(LogLevel::Info, LogCategory::Esp));
+
+    TEST_ASSERT_FALSE(filter.parse("WARN/NET"));
+    TEST_ASSERT_FALSE(filter.parse("X"));
+}
+
+void logStreamPublishTests()
+{
+    LogStream stream;
+    LogFilter warnings;
+    warnings.parse("W");
+    int all = stream.subscribe(LogFilter());
+    int warn = stream.subscribe(warnings);
+    TEST_ASSERT_TRUE(all >= 0 && warn >= 0 && all != warn);
+
+    // Lines are gathered from the parts of the traces, the colors and the carriage returns are removed
+    stream.publish("Connectivity ");
+    stream.publish("check failed\r\n");
+    stream.publish("\033[0;33mW (10) wifi: disconnected\033[0m\nI (11) wifi: conn");
+    TEST_ASSERT_EQUAL_STRING("data:Connectivity check failed\n\ndata:W (10) wifi: disconnected\n\n", takeAll(stream, all).c_str());
+    TEST_ASSERT_EQUAL_STRING("data:W (10) wifi: disconnected\n\n", takeAll(stream, warn).c_str());
+    stream.publish("ecting\n");
+    TEST_ASSERT_EQUAL_STRING("data:I (11) wifi: connecting\n\n", takeAll(stream, all).c_str());
+    TEST_ASSERT_EQUAL_STRING("", takeAll(stream, warn).c_str());
+
+    // A part of an event stays queued until it is consumed
+    stream.publish("abc\n");
+    char buff[4];
+    TEST_ASSERT_EQUAL(4, stream.peek(all, buff, sizeof(buff)));
+    stream.consume(all, 2);
+    TEST_ASSERT_EQUAL_STRING("ta:abc\n\n", takeAll(stream, all).c_str());
+
+    // An unsubscribed slot is given to the next subscriber
+    stream.unsubscribe(warn);
+    TEST_ASSERT_EQUAL(warn, stream.subscribe(LogFilter()));
+    TEST_ASSERT_EQUAL_STRING("", takeAll(stream, warn).c_str());
+    TEST_ASSERT_EQUAL_MESSAGE(-1, stream.subscribe(LogFilter()), "Expected no room for another subscriber");
+}
+
+void logStreamOverflowTests()
+{
+    LogStream stream;
+    int subscriber = stream.subscribe(LogFilter());
+
+    // Each line takes 16 bytes as an event, the lines that do not fit are dropped whole
+    int nLines = LOG_STREAM_BUFF_SIZE / 16 + 3;
+    for (int i = 0; i < nLines; i++)
+        stream.publish("line 0123\n");
+    String events = takeAll(stream, subscriber);
+    TEST_ASSERT_EQUAL(LOG_STREAM_BUFF_SIZE, events.length());
+
+    // The subscriber is told how many lines it lost before the next line
+    stream.publish("next\n");
+    TEST_ASSERT_EQUAL_STRING("event: dropped\ndata: 3\n\ndata:next\n\n", takeAll(stream, subscriber).c_str());
+
+    // A line that is too long is truncated
+    String longLine;
+    for (int i = 0; i < LOG_STREAM_LINE_SIZE + 10; i++)
+        longLine += 'x';
+    stream.publish((longLine + "\n").c_str());
+    TEST_ASSERT_EQUAL(5 + LOG_STREAM_LINE_SIZE - 1 + 2, takeAll(stream, subscriber).length());
+}
@@ -0,0 +1,9 @@
+#ifndef LogStreamTests_h
+#define LogStreamTests_h
+
+void logStreamClassifyTests();
+void logStreamFilterTests();
+void logStreamPublishTests();
+void logStreamOverflowTests();
+
+#endif // LogStreamTests_h
@@ -0,0 +1,154 @@
+#include "MultipartParserTests.h"
+#include <MultipartParser.h>
+#include <MultipartParser.cpp>
+#include <unity.h>
+#include <string>
+
+#define BOUNDARY "----WebKitFormBoundary7MA4YWxkTrZu0gW"
+
+struct UploadResult
+{
+    std::string fileName;
+    std::string content;
+    int fileStarts = 0;
+};
+
+static bool onFileStart(const char *fileName, void *context)
+{
+    UploadResult *result = static_cast<UploadResult *>(context);
+    result->fileName = fileName;
+    result->fileStarts++;
+    return true;
+}
+
+static bool onFileData(const uint8_t *data, size_t size, void *context)
+{
+    UploadResult *result = static_cast<UploadResult *>(context);
+    result->content.append(reinterpret_cast<const char *>(data), size);
+    return true;
+}
+
+static std::string createBody(const std::string &fileName, const std::string &content)
+{
+    return
+        "--" BOUNDARY "\r\n"
+        "Content-Disposition: form-data; name=\"file\"; filename=\"" + fileName + "\"\r\n"
+        "Content-Type: application/octet-stream\r\n"
+        "\r\n" +
+        content +
+        "\r\n--" BOUNDARY "--\r\n";
+}
+
+static bool parseInChunks(MultipartParser &parser, const std::string &body, size_t chunkSize)
+{
+    const uint8_t *data = reinterpret_cast<const uint8_t *>(body.data());
+    for (size_t offset = 0; offset < body.size(); offset += chunkSize)
+    {
+        if (!parser.parse(data + offset, std::min(chunkSize, body.size() - offset)))
+            return false;
+    }
+    return true;
+}
+
+static void verifyUpload(const char *boundary, const std::string &body, size_t chunkSize, const char *expectedFileName, const std::string &expectedContent)
+{
+    UploadResult result;
+    MultipartParser parser(boundary, onFileStart, onFileData, &result);
+    TEST_ASSERT_TRUE(parseInChunks(parser, body, chunkSize));
+    TEST_ASSERT_TRUE(parser.isDone());
+    TEST_ASSERT_EQUAL(1, result.fileStarts);
+    TEST_ASSERT_EQUAL_STRING(expectedFileName, result.fileName.c_str());
+    TEST_ASSERT_EQUAL_STRING(expectedFileName, parser.getFileName());
+    TEST_ASSERT_EQUAL(expectedContent.size(), result.content.size());
+    TEST_ASSERT_TRUE(expectedContent == result.content);
+}
+
+void multipartParserBasicTests()
+{
+    char boundary[MULTIPART_MAX_BOUNDARY_LENGTH + 1];
+    MultipartParser::getBoundary("multipart/form-data; boundary=" BOUNDARY, boundary, sizeof(boundary));
+    TEST_ASSERT_EQUAL_STRING(BOUNDARY, boundary);
+    MultipartParser::getBoundary("multipart/form-data; boundary=\"" BOUNDARY "\"; charset=utf-8", boundary, sizeof(boundary));
+    TEST_ASSERT_EQUAL_STRING(BOUNDARY, boundary);
+    MultipartParser::getBoundary("multipart/form-data", boundary, sizeof(boundary));
+    TEST_ASSERT_EQUAL_STRING("", boundary);
+
+    verifyUpload(BOUNDARY, createBody("TEST.TXT", "Hello, World!"), 1024, "TEST.TXT", "Hello, World!");
+    verifyUpload(BOUNDARY, createBody("EMPTY.TXT", ""), 1024, "EMPTY.TXT", "");
+    // Only the name of the file is kept
+    verifyUpload(BOUNDARY, createBody("C:\\Users\\me\\TEST.TXT", "abc"), 1024, "TEST.TXT", "abc");
+    verifyUpload(BOUNDARY, createBody("dir/TEST.TXT", "abc"), 1024, "TEST.TXT", "abc");
+
+    // Parts without a file are skipped
+    std::string body =
+        "--" BOUNDARY "\r\n"
+        "Content-Disposition: form-data; name=\"field\"\r\n"
+        "\r\n"
+        "value\r\n" +
+        createBody("TEST.TXT", "content");
+    verifyUpload(BOUNDARY, body, 1024, "TEST.TXT", "content");
+}
+
+void multipartParserVariousChunkSizesTests()
+{
+    std::string content;
+    for (int i = 0; i < 5000; i++)
+        content += static_cast<char>(i * 7 + i / 256);
+    std::string body = createBody("DATA.BIN", content);
+    for (size_t chunkSize = 1; chunkSize <= 70; chunkSize++)
+        verifyUpload(BOUNDARY, body, chunkSize, "DATA.BIN", content);
+    verifyUpload(BOUNDARY, body, 511, "DATA.BIN", content);
+    verifyUpload(BOUNDARY, body, 4096, "DATA.BIN", content);
+}
+
+void multipartParserDelimiterLikeContentTests()
+{
+    // Content that contains partial delimiters and line breaks
+    std::string content =
+        "\r\r\n\r\n-\r\n--\r\n--" + std::string(BOUNDARY).substr(0, 10) +
+        "\r\n--" + std::string(BOUNDARY).substr(0, strlen(BOUNDARY) - 1) + "x\r";
+    // A delimiter that is not at the start of a line is part of the content
+    content += "--" BOUNDARY "\r\n";
+    for (size_t chunkSize = 1; chunkSize <= 20; chunkSize++)
+        verifyUpload(BOUNDARY, createBody("TRICKY.TXT", content), chunkSize, "TRICKY.TXT", content);
+}
+
+void multipartParserUnknownBoundaryTests()
+{
+    std::string content = "Some content\r\nwith lines\r\n";
+    for (size_t chunkSize = 1; chunkSize <= 20; chunkSize++)
+        verifyUpload(NULL, createBody("TEST.TXT", content), chunkSize, "TEST.TXT", content);
+    verifyUpload("", createBody("TEST.TXT", content), 1024, "TEST.TXT", content);
+}
+
+void multipartParserMalformedBodyTests()
+{
+    UploadResult result;
+
+    // The body ends before the delimiter that follows the file
+    std::string body = createBody("TEST.TXT", "content");
+    body.resize(body.size() - 10);
+    MultipartParser truncated(BOUNDARY, onFileStart, onFileData, &result);
+    TEST_ASSERT_TRUE(parseInChunks(truncated, body, 1024));
+    TEST_ASSERT_FALSE(truncated.isDone());
+
+    // A body without a file
+    body =
+        "--" BOUNDARY "\r\n"
+        "Content-Disposition: form-data; name=\"file\"; filename=\"\"\r\n"
+        "\r\n"
+        "\r\n--" BOUNDARY "--\r\n";
+    MultipartParser noFile(BOUNDARY, onFileStart, onFileData, &result);
+    TEST_ASSERT_FALSE(parseInChunks(noFile, body, 1024));
+    TEST_ASSERT_TRUE(noFile.hasFailed());
+
+    // A body that does not start with a delimiter, when the boundary is not known
+    MultipartParser noDelimiter(NULL, onFileStart, onFileData, &result);
+    TEST_ASSERT_FALSE(parseInChunks(noDelimiter, "Hello\r\n", 1024));
+    TEST_ASSERT_TRUE(noDelimiter.hasFailed());
+
+    // A handler that fails
+    MultipartParser failed(BOUNDARY, onFileStart, [](const uint8_t *, size_t, void *) { return false; }, &result);
+    TEST_ASSERT_FALSE(parseInChunks(failed, createBody("TEST.TXT", "content"), 1024));
+    TEST_ASSERT_TRUE(failed.hasFailed());
+}
@@ -0,0 +1,10 @@
+#ifndef MultipartParserTests_h
+#define MultipartParserTests_h
+
+void multipartParserBasicTests();
+void multipartParserVariousChunkSizesTests();
+void multipartParserDelimiterLikeContentTests();
+void multipartParserUnknownBoundaryTests();
+void multipartParserMalformedBodyTests();
+
+#endif // MultipartParserTests_h
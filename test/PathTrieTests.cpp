@@ -0,0 +1,80 @@
+#include "PathTrieTests.h"
+#include <PathTrie.h>
+#include <unity.h>
+
+static PathTrie<int> createRoutesTrie()
+{
+    PathTrie<int> trie;
+    trie.Insert("/INDEX", 1);
+    trie.Insert("/SETTINGS", 2);
+    trie.Insert("/", 3);
+    trie.Insert("/HISTORY", 4);
+    trie.Insert("/API/SSE", 5);
+    trie.Insert("/API/FILES", 6);
+    return trie;
+}
+
+static void verifyMatch(const PathTrie<int> &trie, const char *str, int expectedValue, size_t expectedLength)
+{
+    int value = 0;
+    size_t length = 0;
+    TEST_ASSERT_TRUE_MESSAGE(trie.Find(str, value, length), str);
+    TEST_ASSERT_EQUAL_MESSAGE(expectedValue, value, str);
+    TEST_ASSERT_EQUAL_MESSAGE(expectedLength, length, str);
+}
+
+static void verifyNoMatch(const PathTrie<int> &trie, const char *str)
+{
+    int value = 0;
+    size_t length = 0;
+    TEST_ASSERT_FALSE_MESSAGE(trie.Find(str, value, length), str);
+}
+
+void pathTrieBasicTests()
+{
+    PathTrie<int> empty;
+    verifyNoMatch(empty, "/");
+    verifyNoMatch(empty, "");
+
+    PathTrie<int> trie = createRoutesTrie();
+    verifyMatch(trie, "/INDEX", 1, 6);
+    verifyMatch(trie, "/index", 1, 6);
+    verifyMatch(trie, "/Settings", 2, 9);
+    verifyMatch(trie, "/", 3, 1);
+    verifyMatch(trie, "/api/sse", 5, 8);
+    verifyMatch(trie, "/API/FILES", 6, 10);
+    verifyNoMatch(trie, "");
+    verifyNoMatch(trie, "/API");
+    verifyNoMatch(trie, "/FAVICON.ICO");
+
+    trie.Insert("/index", 7);
+    verifyMatch(trie, "/INDEX", 7, 6);
+}
+
+void pathTrieSegmentBoundaryTests()
+{
+    PathTrie<int> trie = createRoutesTrie();
+    verifyMatch(trie, "/SETTINGS/3", 2, 9);
+    verifyMatch(trie, "/API/FILES/WWWROOT/INDEX.HTM", 6, 10);
+    verifyMatch(trie, "/HISTORY/", 4, 8);
+    verifyNoMatch(trie, "/SETTINGS3");
+    verifyNoMatch(trie, "/INDEX.HTM");
+    verifyNoMatch(trie, "/API/SSEX");
+    // The root path matches only itself.
+    verifyNoMatch(trie, "//");
+    verifyNoMatch(trie, "/X");
+}
+
+void pathTrieLongestMatchTests()
+{
+    PathTrie<int> trie;
+    trie.Insert("/API", 1);
+    trie.Insert("/API/FILES", 2);
+    trie.Insert("/API/FILES/SD", 3);
+    verifyMatch(trie, "/API", 1, 4);
+    verifyMatch(trie, "/API/SYSTEM", 1, 4);
+    verifyMatch(trie, "/API/FILES", 2, 10);
+    verifyMatch(trie, "/API/FILESX", 1, 4);
+    verifyMatch(trie, "/API/FILES/SDX", 2, 10);
+    verifyMatch(trie, "/API/FILES/SD/A.TXT", 3, 13);
+}
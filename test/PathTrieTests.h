@@ -0,0 +1,8 @@
+#ifndef PathTrieTests_h
+#define PathTrieTests_h
+
+void pathTrieBasicTests();
+void pathTrieSegmentBoundaryTests();
+void pathTrieLongestMatchTests();
+
+#endif // PathTrieTests_h
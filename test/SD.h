@@ -0,0 +1,100 @@
+#ifndef FakeSD_h
+#define FakeSD_h
+
+#include <Arduino.h>
+#include <string.h>
+#include <time.h>
+#include <map>
+#include <memory>
+#include <string>
+
+// A fake of the SD library for the tests.
+// The files are kept in memory, so the code that serves files can be tested without an SD card.
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+#ifndef SS
+#define SS 5
+#endif
+
+class SPIClass {};
+extern SPIClass SPI;
+
+typedef enum { CARD_NONE, CARD_MMC, CARD_SD, CARD_SDHC, CARD_UNKNOWN } sdcard_type_t;
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+/// @brief An open file of the fake SD card.
+class File
+{
+public:
+    File() {}
+    File(const String &path, const std::string &data, time_t lastWrite) :
+        handle(std::make_shared<Handle>(Handle{path, data, 0, lastWrite}))
+    {
+    }
+    virtual ~File() {}
+
+    virtual size_t write(uint8_t) { return 0; }
+    virtual size_t write(const uint8_t *buf, size_t size) { return 0; }
+    virtual int available() { return handle ? handle->data.size() - handle->pos : 0; }
+    virtual int read() { return available() > 0 ? static_cast<uint8_t>(handle->data[handle->pos++]) : -1; }
+    virtual int peek() { return available() > 0 ? static_cast<uint8_t>(handle->data[handle->pos]) : -1; }
+    virtual void flush() {}
+    virtual size_t readBytes(char *buffer, size_t length) { return read(reinterpret_cast<uint8_t *>(buffer), length); }
+    size_t read(uint8_t *buf, size_t size)
+    {
+        size_t n = std::min<size_t>(size, available());
+        if (n > 0)
+            memcpy(buf, handle->data.data() + handle->pos, n);
+        if (handle)
+            handle->pos += n;
+        return n;
+    }
+    bool seek(uint32_t pos, SeekMode mode = SeekSet)
+    {
+        if (!handle || pos > handle->data.size())
+            return false;
+        handle->pos = pos;
+        return true;
+    }
+    size_t position() const { return handle ? handle->pos : 0; }
+    size_t size() const { return handle ? handle->data.size() : 0; }
+    void close() { handle.reset(); }
+    operator bool() const { return static_cast<bool>(handle); }
+    time_t getLastWrite() { return handle ? handle->lastWrite : 0; }
+    const char *path() const { return handle ? handle->path.c_str() : NULL; }
+    const char *name() const { return handle ? strrchr(handle->path.c_str(), '/') + 1 : NULL; }
+    boolean isDirectory(void) { return false; }
+    File openNextFile(const char *mode = FILE_READ) { return File(); }
+    void rewindDirectory(void) {}
+
+private:
+    struct Handle
+    {
+        String path;
+        std::string data;
+        size_t pos;
+        time_t lastWrite;
+    };
+    std::shared_ptr<Handle> handle;
+};
+
+/// @brief The content of the fake SD card.
+class FakeSD
+{
+public:
+    /// @brief Puts a file on the card, replacing the file with the same path.
+    static void put(const String &path, const std::string &data) { files[path.c_str()] = data; }
+    /// @brief Removes all the files from the card and resets the counters.
+    static void clear() { files.clear(); opens = 0; existsChecks = 0; }
+
+public:
+    static std::map<std::string, std::string> files;
+    /// @brief The number of files that were opened
+    static int opens;
+    /// @brief The number of times the existence of a file was checked
+    static int existsChecks;
+};
+
+#endif // FakeSD_h
@@ -0,0 +1,46 @@
+#include "SSEEventRingTests.h"
+#include <SSEEventRing.h>
+#include <SSEEventRing.cpp>
+#include <unity.h>
+
+void sseEventRingBasicTests()
+{
+    SSEEventRing ring;
+    TEST_ASSERT_NULL_MESSAGE(ring.get(1), "Expected an empty ring not to have events");
+    TEST_ASSERT_EQUAL(ring.getFirstSeq() - 1, ring.getLastSeq());
+
+    ring.push(1, "a");
+    ring.push(2, "b");
+    TEST_ASSERT_EQUAL(1, ring.getFirstSeq());
+    TEST_ASSERT_EQUAL(2, ring.getLastSeq());
+    TEST_ASSERT_EQUAL_STRING("a", ring.get(1)->c_str());
+    TEST_ASSERT_EQUAL_STRING("b", ring.get(2)->c_str());
+    TEST_ASSERT_NULL(ring.get(3));
+}
+
+void sseEventRingOverflowTests()
+{
+    SSEEventRing ring;
+    for (uint32_t seq = 1; seq <= SSE_EVENT_RING_SIZE + 3; seq++)
+        ring.push(seq, String(seq).c_str());
+
+    // The oldest events are replaced
+    TEST_ASSERT_EQUAL(4, ring.getFirstSeq());
+    TEST_ASSERT_EQUAL(SSE_EVENT_RING_SIZE + 3, ring.getLastSeq());
+    TEST_ASSERT_NULL_MESSAGE(ring.get(3), "Expected a replaced event not to be in the ring");
+    TEST_ASSERT_EQUAL_STRING("4", ring.get(4)->c_str());
+    TEST_ASSERT_EQUAL_STRING(String(SSE_EVENT_RING_SIZE + 3).c_str(), ring.get(SSE_EVENT_RING_SIZE + 3)->c_str());
+}
+
+void sseEventRingGapTests()
+{
+    SSEEventRing ring;
+    ring.push(1, "a");
+    ring.push(2, "b");
+    // An event that does not follow the last one starts the ring over
+    ring.push(10, "c");
+    TEST_ASSERT_EQUAL(10, ring.getFirstSeq());
+    TEST_ASSERT_EQUAL(10, ring.getLastSeq());
+    TEST_ASSERT_NULL(ring.get(2));
+    TEST_ASSERT_EQUAL_STRING("c", ring.get(10)->c_str());
+}
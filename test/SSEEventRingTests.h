@@ -0,0 +1,8 @@
+#ifndef SSEEventRingTests_h
+#define SSEEventRingTests_h
+
+void sseEventRingBasicTests();
+void sseEventRingOverflowTests();
+void sseEventRingGapTests();
+
+#endif // SSEEventRingTests_h
@@ -0,0 +1,72 @@
+#include "SSEStateModelTests.h"
+#include <SSEStateModel.h>
+#include <SSEStateModel.cpp>
+#include <unity.h>
+
+void sseStateModelSnapshotTests()
+{
+    SSEStateModel model;
+    char buff[SSE_EVENT_BUFF_SIZE];
+
+    model.set(SSEStateField::AutoRecovery, 1);
+    model.set(SSEStateField::RecoveryType, 3);
+    model.set(SSEStateField::RDisco, 180);
+    TEST_ASSERT_TRUE_MESSAGE(model.commit(), "Expected the changes to be committed");
+    TEST_ASSERT_EQUAL_UINT32(1, model.getSeq());
+
+    size_t len = model.writeSnapshot(buff, sizeof(buff));
+    TEST_ASSERT_EQUAL(strlen(buff), len);
+    TEST_ASSERT_EQUAL_STRING(
+        "data:{\"seq\": 1, \"full\": true, \"autoRecovery\": true, \"modemState\": 0, \"routerState\": 0, \"recoveryType\": 3, "
+        "\"showLastRecovery\": false, \"days\": 0, \"hours\": 0, \"minutes\": 0, \"seconds\": 0, \"rDisco\": 180, \"mDisco\": 0, "
+        "\"rPeriodic\": false, \"mPeriodic\": false}\n\n",
+        buff);
+
+    // A buffer that is too small for the event does not get a partial event
+    TEST_ASSERT_EQUAL(0, model.writeSnapshot(buff, 64));
+}
+
+void sseStateModelDeltaTests()
+{
+    SSEStateModel model;
+    char buff[SSE_EVENT_BUFF_SIZE];
+
+    model.set(SSEStateField::ModemState, 1);
+    model.set(SSEStateField::RouterState, 1);
+    model.commit();
+    model.set(SSEStateField::RecoveryType, 2);
+    TEST_ASSERT_FALSE_MESSAGE(model.set(SSEStateField::ModemState, 1), "Expected setting the same value not to be a change");
+    model.commit();
+    model.set(SSEStateField::Seconds, 5);
+    model.commit();
+
+    model.writeDelta(2, buff, sizeof(buff));
+    TEST_ASSERT_EQUAL_STRING("data:{\"seq\": 3, \"seconds\": 5}\n\n", buff);
+    model.writeDelta(1, buff, sizeof(buff));
+    TEST_ASSERT_EQUAL_STRING("data:{\"seq\": 3, \"recoveryType\": 2, \"seconds\": 5}\n\n", buff);
+    model.writeDelta(0, buff, sizeof(buff));
+    TEST_ASSERT_EQUAL_STRING("data:{\"seq\": 3, \"modemState\": 1, \"routerState\": 1, \"recoveryType\": 2, \"seconds\": 5}\n\n", buff);
+    TEST_ASSERT_EQUAL_MESSAGE(0, model.writeDelta(3, buff, sizeof(buff)), "Expected no delta for a client that is up to date");
+
+    // Nothing to commit if nothing changed
+    model.set(SSEStateField::Seconds, 5);
+    TEST_ASSERT_FALSE(model.commit());
+    TEST_ASSERT_EQUAL_UINT32(3, model.getSeq());
+}
+
+void sseStateModelUncommittedTests()
+{
+    SSEStateModel model;
+    char buff[SSE_EVENT_BUFF_SIZE];
+
+    model.set(SSEStateField::Minutes, 7);
+    model.commit();
+    model.set(SSEStateField::Minutes, 8);
+    model.set(SSEStateField::MPeriodic, 1);
+    // Changes that are not committed are not part of a delta yet
+    TEST_ASSERT_EQUAL(0, model.writeDelta(1, buff, sizeof(buff)));
+    TEST_ASSERT_EQUAL(8, model.get(SSEStateField::Minutes));
+    model.commit();
+    model.writeDelta(1, buff, sizeof(buff));
+    TEST_ASSERT_EQUAL_STRING("data:{\"seq\": 2, \"minutes\": 8, \"mPeriodic\": true}\n\n", buff);
+}
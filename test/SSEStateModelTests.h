@@ -0,0 +1,8 @@
+#ifndef SSEStateModelTests_h
+#define SSEStateModelTests_h
+
+void sseStateModelSnapshotTests();
+void sseStateModelDeltaTests();
+void sseStateModelUncommittedTests();
+
+#endif // SSEStateModelTests_h
@@ -7,6 +7,15 @@
 #include "HistoryControlTests.h"
 #include "LinkedListTests.h"
 #include "ObserversTests.h"
+#include "PathTrieTests.h"
+#include "HttpRangeTests.h"
+#include "MultipartParserTests.h"
+#include "ConnectionDeadlineTests.h"
+#include "SSEStateModelTests.h"
+#include "SSEEventRingTests.h"
+#include "IdHashTableTests.h"
+#include "LogStreamTests.h"
+#include "FileViewReaderTests.h"
 #include "FakeLock.h"
 #include <FakeEEPROMEx.h>
 #include <Trace.h>
@@ -34,6 +43,7 @@ int main(void) {
 	RUN_TEST(htmlFillerViewReaderWithVariousBuffLenTests);
 	RUN_TEST(htmlFillerViewReaderWithNonExistingFillerTests);
 	RUN_TEST(htmlFillerViewReaderWithNotEnoughSpaceForFillerTests);
+	RUN_TEST(htmlFillerViewReaderExpandFillersTests);
 	RUN_TEST(historyStorageBasicTests);
 	RUN_TEST(historyStorageBasicResizeTests);
 	RUN_TEST(historyStorageInitTests);
@@ -52,6 +62,37 @@ int main(void) {
 	RUN_TEST(linkedListClearAllTests);
 	RUN_TEST(linkedListScanNodesTests);
 	RUN_TEST(observersBasicTests);
+	RUN_TEST(pathTrieBasicTests);
+	RUN_TEST(pathTrieSegmentBoundaryTests);
+	RUN_TEST(pathTrieLongestMatchTests);
+	RUN_TEST(httpRangeSatisfiableTests);
+	RUN_TEST(httpRangeUnsatisfiableTests);
+	RUN_TEST(httpRangeIgnoredTests);
+	RUN_TEST(multipartParserBasicTests);
+	RUN_TEST(multipartParserVariousChunkSizesTests);
+	RUN_TEST(multipartParserDelimiterLikeContentTests);
+	RUN_TEST(multipartParserUnknownBoundaryTests);
+	RUN_TEST(multipartParserMalformedBodyTests);
+	RUN_TEST(connectionDeadlineIdleTests);
+	RUN_TEST(connectionDeadlineRateTests);
+	RUN_TEST(connectionDeadlineRestartTests);
+	RUN_TEST(sseStateModelSnapshotTests);
+	RUN_TEST(sseStateModelDeltaTests);
+	RUN_TEST(sseStateModelUncommittedTests);
+	RUN_TEST(sseEventRingBasicTests);
+	RUN_TEST(sseEventRingOverflowTests);
+	RUN_TEST(sseEventRingGapTests);
+	RUN_TEST(idHashTableInsertTests);
+	RUN_TEST(idHashTableDeleteTests);
+	RUN_TEST(idHashTableFullTests);
+	RUN_TEST(idHashTableScanNodesTests);
+	RUN_TEST(logStreamClassifyTests);
+	RUN_TEST(logStreamFilterTests);
+	RUN_TEST(logStreamPublishTests);
+	RUN_TEST(logStreamOverflowTests);
+	RUN_TEST(fileViewReaderGzipAfterPlainCachedTests);
+	RUN_TEST(fileViewReaderNoGzipCopyTests);
+	RUN_TEST(fileViewReaderMissingFilesBoundTests);
   return UNITY_END();
 }
 